@@ -23,6 +23,49 @@ client_ping = {
 	["timeout_ping_count"] = 4,
 };
 
+-- How many bytes may be waiting to be sent to a client before it's considered stalled and disconnected?
+-- 0 disables the limit
+client_send_queue_limit = 512 * 1024;
+
+-- How often (in seconds) should each server append how many of each packet it handled and how long they took to logs/<server>_packet_stats.log?
+-- 0 disables the dump, the numbers are still kept for the !packetstats command
+packet_stats_interval = 300;
+
+-- Should each ChannelServer record the packets its clients send to logs/captures?
+-- Only the ChannelServer captures, the LoginServer's clients send account passwords and PINs
+-- !capture turns this on and off while the ChannelServer is running
+capture_client_packets = false;
+
+-- Should !replay be able to play a capture from logs/captures back through the ChannelServer?
+-- The captured characters act again as they did, so this is meant for benchmarking against a test database and should stay off for live servers
+replay_captures = false;
+
+-- How many threads (each with its own database connection) should each ChannelServer use to save players?
+-- Saves happen on these threads so that a burst of disconnects doesn't stall the game
+channel_save_threads = 2;
+
+-- How many threads (each with its own database connection) should each ChannelServer use to load characters?
+-- The queries for a character run side by side on these threads, so connecting players don't stall the game either
+channel_load_threads = 4;
+
+-- Should each ChannelServer load every map before accepting players?
+-- Otherwise maps load in the background as players approach them, this adds a large amount of time to startup
+preload_all_maps = false;
+
+-- Which maps should each ChannelServer load in the background as soon as it starts?
+-- Towns and other hubs are good candidates
+preload_maps = {
+	100000000, -- Henesys
+	104000000, -- Lith Harbor
+};
+
+-- How far apart (in pixels) can two players be on a map before they stop seeing each other?
+-- Player, pet and summon movement and facial expressions are only sent to players within roughly this distance (up to twice it diagonally)
+-- Mob movement still goes to the whole map so that mobs are never seen at stale positions
+-- Players are despawned and respawned for each other as they move out of and into range
+-- Only worth turning on for servers with large, crowded maps, 0 sends everything to the whole map
+map_aoi_radius = 0;
+
 -- What IP and port should the server use to connect to the LoginServer?
 login_ip = "127.0.0.1";
 login_inter_port = 8485;
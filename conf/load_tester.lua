@@ -0,0 +1,66 @@
+-- Settings for the LoadTester, a headless client that puts a server under load with simulated players
+-- Point it at a test server, not a live one
+
+-- Where is the LoginServer?
+login_ip = "127.0.0.1";
+login_port = 8484;
+
+-- Which world and channel should the clients play on?
+-- Both are 0-based, like the client sends them
+world = 0;
+channel = 0;
+
+-- How many clients should connect, and how many per second?
+clients = 100;
+ramp_up = 20;
+
+-- How long (in seconds) should the test run from the first client connecting? 0 runs until interrupted
+duration = 300;
+
+-- How often (in seconds) should the latencies since the last report be printed?
+report_interval = 10;
+
+-- How often (in milliseconds) should each client consider doing something?
+-- Nothing in the profiles happens more often than this
+tick = 100;
+
+-- How many threads should be used for the clients' network traffic?
+threads = 4;
+
+-- Client N logs in as <account_prefix><first_account + N> with the password below and plays the first character on it
+-- The accounts need a character in the world, a gender and no PIN
+account_prefix = "loadtest";
+first_account = 1;
+password = "loadtest";
+
+-- How do the clients behave once they're in the game?
+-- Every client picks one profile, the weight decides how likely each one is
+-- Intervals are in milliseconds and randomized by up to half in either direction, leaving one out or setting it to 0 turns that action off
+-- Clients wander up to "wander" away from the origin of the map their character is on
+profiles = {
+	{
+		["name"] = "grinder",
+		["weight"] = 6,
+		["move_interval"] = 500,
+		["wander"] = 300,
+		["attack_interval"] = 700,
+		["damage"] = 50,
+		["loot"] = true,
+	},
+	{
+		["name"] = "socializer",
+		["weight"] = 3,
+		["move_interval"] = 2000,
+		["wander"] = 150,
+		["chat_interval"] = 5000,
+		["chat"] = {
+			"hello",
+			"anyone want to party?",
+			"selling stuff, pm me",
+		},
+	},
+	{
+		["name"] = "idler",
+		["weight"] = 1,
+	},
+};
\ No newline at end of file
@@ -39,7 +39,8 @@
 -- -- All replacement identifiers are case-sensitive
 -- Optional keys
 -- time_format: an exclusive time format for the specific server, if not specified, the global one is used
--- buffer_size: buffer for limited resources like SQL and files, log items are cached until these are full
+-- buffer_size: buffer for limited resources like SQL and files, log items are cached until these are full (file and SQL logs are also written at least once a second)
+-- -- SQL logs that the database can't keep up with or fails to store go to logs/<server>/<date>_sql_spill.log instead
 -- file: the path/file that you wish to log to, supports all above replacements (time and format)
 
 -- The format that %t expands to (required)
@@ -0,0 +1,117 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "aoi_grid.hpp"
+#include "channel_server/player.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace vana {
+namespace channel_server {
+
+aoi_grid::aoi_grid(const rect &bounds, game_coord cell_size) :
+	m_origin{bounds.normalize().left_top()},
+	m_cell_size{std::max<int32_t>(cell_size, 1)}
+{
+	rect normalized = bounds.normalize();
+	m_columns = std::max(normalized.width() / m_cell_size + 1, 1);
+	m_rows = std::max(normalized.height() / m_cell_size + 1, 1);
+	m_cells.resize(static_cast<size_t>(m_columns) * m_rows);
+}
+
+auto aoi_grid::add(ref_ptr<player> player) -> void {
+	cell value = get_cell(player->get_pos());
+	m_cells[get_index(value)].push_back(player);
+	m_player_cells[player->get_id()] = value;
+}
+
+auto aoi_grid::remove(ref_ptr<player> player) -> void {
+	auto kvp = m_player_cells.find(player->get_id());
+	if (kvp == std::end(m_player_cells)) {
+		return;
+	}
+
+	auto &players = m_cells[get_index(kvp->second)];
+	players.erase(std::remove(std::begin(players), std::end(players), player), std::end(players));
+	m_player_cells.erase(kvp);
+}
+
+auto aoi_grid::update(ref_ptr<player> mover, vector<ref_ptr<player>> &entered_view, vector<ref_ptr<player>> &left_view) -> void {
+	auto kvp = m_player_cells.find(mover->get_id());
+	if (kvp == std::end(m_player_cells)) {
+		add(mover);
+		return;
+	}
+
+	cell old_cell = kvp->second;
+	cell new_cell = get_cell(mover->get_pos());
+	if (old_cell.x == new_cell.x && old_cell.y == new_cell.y) {
+		return;
+	}
+
+	auto &players = m_cells[get_index(old_cell)];
+	players.erase(std::remove(std::begin(players), std::end(players), mover), std::end(players));
+	m_cells[get_index(new_cell)].push_back(mover);
+	kvp->second = new_cell;
+
+	collect(new_cell, &old_cell, mover, entered_view);
+	collect(old_cell, &new_cell, mover, left_view);
+}
+
+auto aoi_grid::get_nearby(const point &pos) const -> vector<ref_ptr<player>> {
+	vector<ref_ptr<player>> ret;
+	collect(get_cell(pos), nullptr, nullptr, ret);
+	return ret;
+}
+
+auto aoi_grid::get_cell(const point &pos) const -> cell {
+	// Anything outside of the map bounds (e.g. someone falling off the map) is clamped to the nearest edge cell
+	cell ret;
+	ret.x = std::min(std::max((static_cast<int32_t>(pos.x) - m_origin.x) / m_cell_size, 0), m_columns - 1);
+	ret.y = std::min(std::max((static_cast<int32_t>(pos.y) - m_origin.y) / m_cell_size, 0), m_rows - 1);
+	return ret;
+}
+
+auto aoi_grid::get_index(const cell &value) const -> size_t {
+	return static_cast<size_t>(value.y) * m_columns + value.x;
+}
+
+auto aoi_grid::is_adjacent(const cell &first, const cell &second) const -> bool {
+	return std::abs(first.x - second.x) <= 1 && std::abs(first.y - second.y) <= 1;
+}
+
+auto aoi_grid::collect(const cell &center, const cell *exclude_near, ref_ptr<player> exclude, vector<ref_ptr<player>> &out) const -> void {
+	for (int32_t y = std::max(center.y - 1, 0); y <= std::min(center.y + 1, m_rows - 1); y++) {
+		for (int32_t x = std::max(center.x - 1, 0); x <= std::min(center.x + 1, m_columns - 1); x++) {
+			cell current;
+			current.x = x;
+			current.y = y;
+			if (exclude_near != nullptr && is_adjacent(current, *exclude_near)) {
+				continue;
+			}
+
+			for (const auto &value : m_cells[get_index(current)]) {
+				if (value != exclude) {
+					out.push_back(value);
+				}
+			}
+		}
+	}
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/point.hpp"
+#include "common/rect.hpp"
+#include "common/types.hpp"
+#include <vector>
+
+namespace vana {
+	namespace channel_server {
+		class player;
+
+		// Uniform grid over a map that tracks which cell every player on it is in
+		// Two players are in each other's area of interest when their cells are adjacent (including diagonally), so visibility is symmetric
+		// and only changes when a player moves into a different cell
+		class aoi_grid {
+			NONCOPYABLE(aoi_grid);
+			NO_DEFAULT_CONSTRUCTOR(aoi_grid);
+		public:
+			aoi_grid(const rect &bounds, game_coord cell_size);
+
+			auto add(ref_ptr<player> player) -> void;
+			auto remove(ref_ptr<player> player) -> void;
+			// Moves the player into the cell for their current position
+			// Players that came into or went out of their view as a result are appended to entered_view and left_view
+			auto update(ref_ptr<player> mover, vector<ref_ptr<player>> &entered_view, vector<ref_ptr<player>> &left_view) -> void;
+			auto get_nearby(const point &pos) const -> vector<ref_ptr<player>>;
+		private:
+			struct cell {
+				int32_t x = 0;
+				int32_t y = 0;
+			};
+
+			auto get_cell(const point &pos) const -> cell;
+			auto get_index(const cell &value) const -> size_t;
+			auto is_adjacent(const cell &first, const cell &second) const -> bool;
+			auto collect(const cell &center, const cell *exclude_near, ref_ptr<player> exclude, vector<ref_ptr<player>> &out) const -> void;
+
+			point m_origin;
+			int32_t m_cell_size = 1;
+			int32_t m_columns = 1;
+			int32_t m_rows = 1;
+			vector<vector<ref_ptr<player>>> m_cells;
+			hash_map<game_player_id, cell> m_player_cells;
+		};
+	}
+}
\ No newline at end of file
@@ -19,9 +19,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common/connection_listener_config.hpp"
 #include "common/connection_manager.hpp"
 #include "common/data/initialize.hpp"
+#include "common/data/loader.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/exit_code.hpp"
 #include "common/lua/config_file.hpp"
 #include "common/packet_builder.hpp"
+#include "common/packet_capture.hpp"
 #include "common/server_type.hpp"
 #include "common/util/misc.hpp"
 #include "channel_server/chat_handler.hpp"
@@ -39,6 +42,14 @@ channel_server::channel_server() :
 	abstract_server{server_type::channel},
 	m_world_ip{0}
 {
+	// Channel-wide services aren't owned by any map, so they share a strand of their own
+	auto strand = make_ref_ptr<asio::io_service::strand>(get_io_service());
+	vana::timer::dispatcher dispatcher = [strand](function<void()> work) {
+		strand->post(work);
+	};
+	m_event_data_provider.set_timer_dispatcher(dispatcher);
+	m_trades.set_timer_dispatcher(dispatcher);
+	m_maple_tvs.set_timer_dispatcher(dispatcher);
 }
 
 auto channel_server::listen() -> void {
@@ -52,14 +63,30 @@ auto channel_server::listen() -> void {
 			connection_type::end_user,
 			maple_version::channel_subversion,
 			m_port,
-			ip::type::ipv4
+			ip::type::ipv4,
+			config.client_send_queue_limit
 		},
 		[&] { return make_ref_ptr<player>(); }
 	);
 
+	if (config.capture_client_packets) {
+		if (start_packet_capture() == result::failure) {
+			log(vana::log::type::warning, "Unable to open a packet capture file, client packets won't be captured");
+		}
+	}
+
 	vana::data::initialize::set_users_offline(this, get_online_id());
 }
 
+auto channel_server::start_packet_capture() -> result {
+	// Only the channel captures, the login server's clients send account passwords and PINs
+	return packet_capture::start(get_log_prefix());
+}
+
+auto channel_server::open_replay_session(const ip &source) -> ref_ptr<session> {
+	return get_connection_manager().open_replay_session(source, [&] { return make_ref_ptr<player>(); });
+}
+
 auto channel_server::finalize_player(ref_ptr<player> session) -> void {
 	m_session_pool.store(session);
 }
@@ -67,7 +94,10 @@ auto channel_server::finalize_player(ref_ptr<player> session) -> void {
 auto channel_server::shutdown() -> void {
 	// If we don't do this and the connection disconnects, it will try to call shutdown() again
 	m_channel_id = -1;
+	packet_capture::stop();
 	abstract_server::shutdown();
+	// The save threads are gone by now, so whatever the disconnects queued up gets committed here
+	m_player_saver.flush();
 }
 
 auto channel_server::load_data() -> result {
@@ -77,29 +107,43 @@ auto channel_server::load_data() -> result {
 	if (vana::data::initialize::check_mcdb_version(this) == result::failure) {
 		return result::failure;
 	}
-
-	m_buff_data_provider.load_data();
-	m_valid_char_data_provider.load_data();
-	m_equip_data_provider.load_data();
-	m_curse_data_provider.load_data();
-	m_npc_data_provider.load_data();
-	m_drop_data_provider.load_data();
-	m_beauty_data_provider.load_data();
-	m_mob_data_provider.load_data();
-	m_script_data_provider.load_data();
-	m_skill_data_provider.load_data();
-	m_reactor_data_provider.load_data();
-	m_shop_data_provider.load_data();
-	m_quest_data_provider.load_data();
-	m_item_data_provider.load_data(m_buff_data_provider);
-	m_map_data_provider.load_data();
+	vana::data::mcdb::load_snapshot(this);
+
+	vana::data::loader loader;
+	loader
+		.add("Buffs", [&] { m_buff_data_provider.load_data(); })
+		.add("Char Info", [&] { m_valid_char_data_provider.load_data(); })
+		.add("Equips", [&] { m_equip_data_provider.load_data(); })
+		.add("Curse Info", [&] { m_curse_data_provider.load_data(); })
+		.add("NPCs", [&] { m_npc_data_provider.load_data(); })
+		.add("Drops", [&] { m_drop_data_provider.load_data(); })
+		.add("Beauty", [&] { m_beauty_data_provider.load_data(); })
+		.add("Mobs", [&] { m_mob_data_provider.load_data(); })
+		.add("Scripts", [&] { m_script_data_provider.load_data(); })
+		.add("Skills", [&] { m_skill_data_provider.load_data(); })
+		.add("Reactors", [&] { m_reactor_data_provider.load_data(); })
+		.add("Shops", [&] { m_shop_data_provider.load_data(); })
+		.add("Quests", [&] { m_quest_data_provider.load_data(); })
+		.add("Items", [&] { m_item_data_provider.load_data(m_buff_data_provider); }, {"Buffs"})
+		.add("Maps", [&] { m_map_data_provider.load_data(); });
+	loader.run();
+
+	// Events start instances and timers on the channel itself, so they wait until all the data is in
 	m_event_data_provider.load_data();
 
+	auto &config = get_inter_server_config();
+	if (config.preload_all_maps) {
+		m_map_data_provider.preload_all();
+	}
+	m_map_preloader.start(config.preload_maps);
+	m_player_loader.start(config.channel_load_threads);
+	m_player_saver.start(config.channel_save_threads);
+	m_packet_replayer.start();
+
 	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Commands... ";
 	chat_handler::initialize_commands();
 	std::cout << "DONE" << std::endl;
 
-	auto &config = get_inter_server_config();
 	auto result = get_connection_manager().connect(
 		config.login_ip,
 		config.login_port,
@@ -118,28 +162,36 @@ auto channel_server::load_data() -> result {
 }
 
 auto channel_server::reload_data(const string &args) -> void {
-	if (args == "all") {
-		m_item_data_provider.load_data(m_buff_data_provider);
-		m_drop_data_provider.load_data();
-		m_shop_data_provider.load_data();
-		m_mob_data_provider.load_data();
-		m_beauty_data_provider.load_data();
-		m_script_data_provider.load_data();
-		m_skill_data_provider.load_data();
-		m_reactor_data_provider.load_data();
-		m_quest_data_provider.load_data();
-		m_map_data_provider.load_data();
+	vana::data::mcdb::discard_snapshot();
+
+	bool all = args == "all";
+	vana::data::loader loader;
+	if (all || args == "items") loader.add("Items", [&] { m_item_data_provider.load_data(m_buff_data_provider); });
+	if (all || args == "drops") loader.add("Drops", [&] { m_drop_data_provider.load_data(); });
+	if (all || args == "shops") loader.add("Shops", [&] { m_shop_data_provider.load_data(); });
+	if (all || args == "mobs") loader.add("Mobs", [&] { m_mob_data_provider.load_data(); });
+	if (all || args == "beauty") loader.add("Beauty", [&] { m_beauty_data_provider.load_data(); });
+	if (all || args == "scripts") loader.add("Scripts", [&] { m_script_data_provider.load_data(); });
+	if (all || args == "skills") loader.add("Skills", [&] { m_skill_data_provider.load_data(); });
+	if (all || args == "reactors") loader.add("Reactors", [&] { m_reactor_data_provider.load_data(); });
+	if (all || args == "quests") loader.add("Quests", [&] { m_quest_data_provider.load_data(); });
+	if (all || args == "maps") loader.add("Maps", [&] { m_map_data_provider.load_data(); });
+	loader.run();
+
+	if (all || args == "maps") {
+		reload_maps();
+	}
+}
+
+auto channel_server::reload_maps() -> void {
+	// A reload throws away every map's link info, warm the configured ones back up in the background
+	// Preloading everything again here would stall whoever ran the command for the length of a startup
+	// Maps that failed to load get another chance with the fresh data
+	m_map_preloader.clear_failures();
+	auto &config = get_inter_server_config();
+	for (const auto &map_id : config.preload_maps) {
+		m_map_preloader.prefetch(map_id);
 	}
-	else if (args == "items") m_item_data_provider.load_data(m_buff_data_provider);
-	else if (args == "drops") m_drop_data_provider.load_data();
-	else if (args == "shops") m_shop_data_provider.load_data();
-	else if (args == "mobs") m_mob_data_provider.load_data();
-	else if (args == "beauty") m_beauty_data_provider.load_data();
-	else if (args == "scripts") m_script_data_provider.load_data();
-	else if (args == "skills") m_skill_data_provider.load_data();
-	else if (args == "reactors") m_reactor_data_provider.load_data();
-	else if (args == "quests") m_quest_data_provider.load_data();
-	else if (args == "maps") m_map_data_provider.load_data();
 }
 
 auto channel_server::make_log_identifier() const -> opt_string {
@@ -282,6 +334,22 @@ auto channel_server::get_player_data_provider() -> player_data_provider & {
 	return m_player_data_provider;
 }
 
+auto channel_server::get_map_preloader() -> map_preloader & {
+	return m_map_preloader;
+}
+
+auto channel_server::get_packet_replayer() -> packet_replayer & {
+	return m_packet_replayer;
+}
+
+auto channel_server::get_player_loader() -> player_loader & {
+	return m_player_loader;
+}
+
+auto channel_server::get_player_saver() -> player_saver & {
+	return m_player_saver;
+}
+
 auto channel_server::get_trades() -> trades & {
 	return m_trades;
 }
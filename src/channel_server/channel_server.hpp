@@ -41,8 +41,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "channel_server/instances.hpp"
 #include "channel_server/login_server_session.hpp"
 #include "channel_server/map_factory.hpp"
+#include "channel_server/map_preloader.hpp"
 #include "channel_server/maple_tvs.hpp"
+#include "channel_server/packet_replayer.hpp"
 #include "channel_server/player_data_provider.hpp"
+#include "channel_server/player_loader.hpp"
+#include "channel_server/player_saver.hpp"
 #include "channel_server/trades.hpp"
 #include "channel_server/world_server_session.hpp"
 #include <string>
@@ -91,6 +95,10 @@ namespace vana {
 			auto get_map_data_provider() -> data::provider::map &;
 			auto get_player_data_provider() -> player_data_provider &;
 			auto get_map_factory() const -> map_factory &;
+			auto get_map_preloader() -> map_preloader &;
+			auto get_packet_replayer() -> packet_replayer &;
+			auto get_player_loader() -> player_loader &;
+			auto get_player_saver() -> player_saver &;
 			auto get_trades() -> trades &;
 			auto get_maple_tvs() -> maple_tvs &;
 			auto get_instances() -> instances &;
@@ -98,6 +106,9 @@ namespace vana {
 			auto get_map(int32_t map_id) -> map *;
 			auto unload_map(int32_t map_id) -> void;
 
+			auto start_packet_capture() -> result;
+			auto open_replay_session(const ip &source) -> ref_ptr<session>;
+
 			auto is_connected() const -> bool;
 			auto get_world_id() const -> game_world_id;
 			auto get_channel_id() const -> game_channel_id;
@@ -115,6 +126,8 @@ namespace vana {
 			auto make_log_identifier() const -> opt_string override;
 			auto get_log_prefix() const -> string override;
 		private:
+			auto reload_maps() -> void;
+
 			game_world_id m_world_id = -1;
 			game_channel_id m_channel_id = -1;
 			connection_port m_world_port = 0;
@@ -143,6 +156,10 @@ namespace vana {
 			event_data_provider m_event_data_provider;
 			player_data_provider m_player_data_provider;
 			map_factory m_map_factory;
+			map_preloader m_map_preloader;
+			packet_replayer m_packet_replayer;
+			player_loader m_player_loader;
+			player_saver m_player_saver;
 			trades m_trades;
 			maple_tvs m_maple_tvs;
 			instances m_instances;
@@ -287,6 +287,19 @@ auto chat_handler_functions::initialize() -> void {
 	command.notes.push_back("Forces ranking recalculation");
 	g_command_list["dorankings"] = command.add_to_map();
 
+	command.command = &management_functions::capture;
+	command.syntax = "[${on | off}]";
+	command.notes.push_back("Records the packets of clients that connect from now on to logs/captures, or shows whether that's happening");
+	g_command_list["capture"] = command.add_to_map();
+
+	command.command = &management_functions::replay;
+	command.syntax = "<$capture file> [#speed]";
+	command.notes.push_back("Plays a packet capture from logs/captures back through the current channel as though its clients were connected");
+	command.notes.push_back("Only available when replay_captures is turned on in connection_properties.lua");
+	command.notes.push_back("The characters in the capture need to exist in the database, meant for benchmarking on a test server");
+	command.notes.push_back("Speed 0 sends the packets as fast as they're handled instead of with their recorded timing");
+	g_command_list["replay"] = command.add_to_map();
+
 	command.command = &message_functions::global_message;
 	command.syntax = "<${notice | box | red | blue}> <$message>";
 	command.notes.push_back("Displays a message to every channel on every world");
@@ -623,6 +636,15 @@ auto chat_handler_functions::initialize() -> void {
 	command.notes.push_back("Allows you to see up to 100 players on the current channel");
 	g_command_list["online"] = command.add_to_map();
 
+	command.command = &info_functions::save_stats;
+	command.notes.push_back("Shows how many database rows player saves on the current channel have written and deleted");
+	g_command_list["savestats"] = command.add_to_map();
+
+	command.command = &info_functions::packet_stats;
+	command.syntax = "[#count]";
+	command.notes.push_back("Shows the packets the current channel has spent the most time handling, with their counts, bytes and handler latency");
+	g_command_list["packetstats"] = command.add_to_map();
+
 	command.command = &management_functions::lag;
 	command.syntax = "<$player>";
 	command.notes.push_back("Allows you to view the lag of any player");
@@ -0,0 +1,67 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "foothold_index.hpp"
+#include <limits>
+
+namespace vana {
+namespace channel_server {
+
+foothold_index::foothold_index(const vector<data::type::foothold_info> &footholds) :
+	m_footholds{footholds}
+{
+	if (m_footholds.empty()) {
+		return;
+	}
+
+	m_min_x = std::numeric_limits<game_coord>::max();
+	m_max_x = std::numeric_limits<game_coord>::min();
+	for (uint32_t i = 0; i < m_footholds.size(); i++) {
+		const auto &foothold = m_footholds[i];
+		m_min_x = std::min(m_min_x, std::min(foothold.line.pt1.x, foothold.line.pt2.x));
+		m_max_x = std::max(m_max_x, std::max(foothold.line.pt1.x, foothold.line.pt2.x));
+		// Duplicate IDs resolve to the first one, which is what the old linear scans found
+		m_ids.emplace(foothold.id, i);
+	}
+
+	// Aim for roughly one foothold per bucket, most footholds are short platform segments
+	int32_t span = static_cast<int32_t>(m_max_x) - m_min_x + 1;
+	int32_t bucket_count = static_cast<int32_t>(std::min<size_t>(m_footholds.size(), 4096));
+	m_bucket_width = std::max((span + bucket_count - 1) / bucket_count, 16);
+	m_buckets.resize(static_cast<size_t>((span + m_bucket_width - 1) / m_bucket_width));
+
+	for (uint32_t i = 0; i < m_footholds.size(); i++) {
+		const auto &line = m_footholds[i].line;
+		size_t first = get_bucket(std::min(line.pt1.x, line.pt2.x));
+		size_t last = get_bucket(std::max(line.pt1.x, line.pt2.x));
+		for (size_t bucket = first; bucket <= last; bucket++) {
+			m_buckets[bucket].push_back(i);
+		}
+	}
+}
+
+auto foothold_index::find(game_foothold_id id) const -> const data::type::foothold_info * {
+	auto kvp = m_ids.find(id);
+	return kvp != std::end(m_ids) ? &m_footholds[kvp->second] : nullptr;
+}
+
+auto foothold_index::get_bucket(game_coord x) const -> size_t {
+	return static_cast<size_t>((static_cast<int32_t>(x) - m_min_x) / m_bucket_width);
+}
+
+}
+}
\ No newline at end of file
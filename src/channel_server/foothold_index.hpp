@@ -0,0 +1,85 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/data/type/foothold_info.hpp"
+#include "common/types.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace vana {
+	namespace channel_server {
+		// Immutable lookup structure over a map's footholds, built once when the map is created
+		// Footholds are bucketed into uniform slices of the x axis so that floor queries only look at footholds that can be under a given x
+		// Candidates are always visited in the order the footholds were given in, so queries resolve ties the same way a linear scan would
+		class foothold_index {
+		public:
+			foothold_index() = default;
+			explicit foothold_index(const vector<data::type::foothold_info> &footholds);
+
+			auto find(game_foothold_id id) const -> const data::type::foothold_info *;
+			auto size() const -> size_t { return m_footholds.size(); }
+			auto empty() const -> bool { return m_footholds.empty(); }
+
+			// Calls func for every foothold whose x range may include x
+			template <typename TFunc>
+			auto for_each_candidate(game_coord x, TFunc func) const -> void;
+			// Returns true if pred holds for any foothold whose x range may overlap [min_x, max_x]
+			template <typename TPredicate>
+			auto any_in_range(game_coord min_x, game_coord max_x, TPredicate pred) const -> bool;
+		private:
+			auto get_bucket(game_coord x) const -> size_t;
+
+			game_coord m_min_x = 0;
+			game_coord m_max_x = 0;
+			int32_t m_bucket_width = 1;
+			vector<data::type::foothold_info> m_footholds;
+			vector<vector<uint32_t>> m_buckets;
+			hash_map<game_foothold_id, uint32_t> m_ids;
+		};
+
+		template <typename TFunc>
+		auto foothold_index::for_each_candidate(game_coord x, TFunc func) const -> void {
+			if (m_footholds.empty() || x < m_min_x || x > m_max_x) {
+				return;
+			}
+
+			for (const auto &index : m_buckets[get_bucket(x)]) {
+				func(m_footholds[index]);
+			}
+		}
+
+		template <typename TPredicate>
+		auto foothold_index::any_in_range(game_coord min_x, game_coord max_x, TPredicate pred) const -> bool {
+			if (m_footholds.empty() || max_x < m_min_x || min_x > m_max_x) {
+				return false;
+			}
+
+			size_t first = get_bucket(std::max(min_x, m_min_x));
+			size_t last = get_bucket(std::min(max_x, m_max_x));
+			for (size_t bucket = first; bucket <= last; bucket++) {
+				for (const auto &index : m_buckets[bucket]) {
+					if (pred(m_footholds[index])) {
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+	}
+}
\ No newline at end of file
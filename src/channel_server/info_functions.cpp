@@ -16,13 +16,16 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "info_functions.hpp"
+#include "common/algorithm.hpp"
 #include "common/io/database.hpp"
 #include "common/map_position.hpp"
+#include "common/packet_stats.hpp"
 #include "channel_server/channel_server.hpp"
 #include "channel_server/maps.hpp"
 #include "channel_server/player.hpp"
 #include "channel_server/player_data_provider.hpp"
 #include "channel_server/player_packet.hpp"
+#include "channel_server/player_saver.hpp"
 #include <iostream>
 
 namespace vana {
@@ -375,6 +378,39 @@ auto info_functions::online(ref_ptr<player> player_value, const game_chat &args)
 	return chat_result::handled_display;
 }
 
+auto info_functions::save_stats(ref_ptr<player> player, const game_chat &args) -> chat_result {
+	auto stats = channel_server::get_instance().get_player_saver().get_stats();
+	chat_handler_functions::show_info(player, [&](out_stream &message) {
+		message << "Saves: " << stats.saves << " (" << stats.failed_saves << " failed), "
+			<< "rows written: " << stats.rows_written << ", rows deleted: " << stats.rows_deleted << ", "
+			<< "last save: " << stats.last_rows_written << " written, " << stats.last_rows_deleted << " deleted";
+	});
+	return chat_result::handled_display;
+}
+
+auto info_functions::packet_stats(ref_ptr<player> player, const game_chat &args) -> chat_result {
+	match matches;
+	int32_t count = 10;
+	if (chat_handler_functions::run_regex_pattern(args, R"((\d+))", matches) == match_result::any_matches) {
+		string raw_count = matches[1];
+		count = ext::constrain_range(atoi(raw_count.c_str()), 1, 50);
+	}
+
+	auto entries = vana::packet_stats::snapshot();
+	if (entries.empty()) {
+		chat_handler_functions::show_info(player, "No packets have been handled yet");
+		return chat_result::handled_display;
+	}
+
+	for (const auto &entry : entries) {
+		if (count-- == 0) {
+			break;
+		}
+		chat_handler_functions::show_info(player, vana::packet_stats::describe(entry));
+	}
+	return chat_result::handled_display;
+}
+
 auto info_functions::variable(ref_ptr<player> player, const game_chat &args) -> chat_result {
 	match matches;
 	if (chat_handler_functions::run_regex_pattern(args, R"((\w+))", matches) == match_result::no_matches) {
@@ -28,6 +28,8 @@ namespace vana {
 			auto lookup(ref_ptr<player> player, const game_chat &args) -> chat_result;
 			auto pos(ref_ptr<player> player, const game_chat &args) -> chat_result;
 			auto online(ref_ptr<player> player, const game_chat &args) -> chat_result;
+			auto save_stats(ref_ptr<player> player, const game_chat &args) -> chat_result;
+			auto packet_stats(ref_ptr<player> player, const game_chat &args) -> chat_result;
 			auto variable(ref_ptr<player> player, const game_chat &args) -> chat_result;
 			auto quest_data(ref_ptr<player> player, const game_chat &args) -> chat_result;
 			auto quest_kills(ref_ptr<player> player, const game_chat &args) -> chat_result;
@@ -63,14 +63,14 @@ namespace lua {
 string lua_scriptable::s_api_version = "1.0.0";
 
 lua_scriptable::lua_scriptable(const string &filename, game_player_id player_id) :
-	lua_environment{filename},
+	lua_environment{filename, false, "channel_script"},
 	m_player_id{player_id}
 {
 	initialize();
 }
 
 lua_scriptable::lua_scriptable(const string &filename, game_player_id player_id, bool use_thread) :
-	lua_environment{filename, use_thread},
+	lua_environment{filename, use_thread, "channel_script"},
 	m_player_id{player_id}
 {
 	initialize();
@@ -80,7 +80,6 @@ auto lua_scriptable::initialize() -> void {
 	set<game_player_id>("system_player_id", m_player_id); // Pushing ID for reference from static functions
 	set<string>("system_script", get_script_name());
 	set<vector<string>>("system_path", get_script_path());
-	set_environment_variables();
 
 	auto player = channel_server::get_instance().get_player_data_provider().get_player(m_player_id);
 	if (player != nullptr && player->get_instance() != nullptr) {
@@ -90,6 +89,13 @@ auto lua_scriptable::initialize() -> void {
 		set<string>("system_instance_name", "");
 	}
 
+	set_up_shared_globals([&] {
+		set_environment_variables();
+		expose_api();
+	});
+}
+
+auto lua_scriptable::expose_api() -> void {
 	// Miscellanous
 	expose("consoleOutput", &lua_exports::console_output);
 	expose("getRandomNumber", &lua_exports::get_random_number);
@@ -50,6 +50,7 @@ namespace vana {
 			private:
 				auto initialize() -> void;
 				auto set_environment_variables() -> void;
+				auto expose_api() -> void;
 				// TODO FIXME msvc
 				// Remove this when MSVC supports static init
 				static string s_api_version/* = "1.0.0"*/;
@@ -20,12 +20,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common/data/provider/item.hpp"
 #include "common/exit_code.hpp"
 #include "common/io/database.hpp"
+#include "common/packet_capture.hpp"
 #include "common/util/string.hpp"
 #include "channel_server/channel_server.hpp"
 #include "channel_server/inventory.hpp"
 #include "channel_server/maps.hpp"
 #include "channel_server/mystic_door.hpp"
 #include "channel_server/npc_handler.hpp"
+#include "channel_server/packet_replayer.hpp"
 #include "channel_server/player.hpp"
 #include "channel_server/player_data_provider.hpp"
 #include "channel_server/player_packet.hpp"
@@ -962,5 +964,65 @@ auto management_functions::packet(ref_ptr<player> player, const game_chat &args)
 	return chat_result::show_syntax;
 }
 
+auto management_functions::capture(ref_ptr<player> player, const game_chat &args) -> chat_result {
+	if (args == "on") {
+		if (channel_server::get_instance().start_packet_capture() == result::failure) {
+			chat_handler_functions::show_error(player, "Unable to open a capture file");
+			return chat_result::handled_display;
+		}
+		channel_server::get_instance().log(vana::log::type::gm_command, "GM started a packet capture. GM: " + player->get_name());
+	}
+	else if (args == "off") {
+		vana::packet_capture::stop();
+	}
+	else if (!args.empty()) {
+		return chat_result::show_syntax;
+	}
+
+	if (vana::packet_capture::is_running()) {
+		chat_handler_functions::show_info(player, "Capturing the packets of clients that connect to " + vana::packet_capture::get_filename());
+	}
+	else {
+		chat_handler_functions::show_info(player, "No packets are being captured");
+	}
+	return chat_result::handled_display;
+}
+
+auto management_functions::replay(ref_ptr<player> player, const game_chat &args) -> chat_result {
+	if (!channel_server::get_instance().get_inter_server_config().replay_captures) {
+		chat_handler_functions::show_error(player, "Replaying captures is disabled, see replay_captures in connection_properties.lua");
+		return chat_result::handled_display;
+	}
+
+	match matches;
+	if (chat_handler_functions::run_regex_pattern(args, R"((\S+) ?(\d+(?:\.\d+)?)?)", matches) == match_result::no_matches) {
+		return chat_result::show_syntax;
+	}
+
+	opt_string found = vana::packet_capture::find(matches[1]);
+	if (!found.is_initialized()) {
+		chat_handler_functions::show_error(player, "Captures can only be replayed from logs/captures");
+		return chat_result::handled_display;
+	}
+
+	string filename = found.get();
+	string raw_speed = matches[2];
+	double speed = raw_speed.empty() ? 1 : atof(raw_speed.c_str());
+
+	auto &replayer = channel_server::get_instance().get_packet_replayer();
+	if (replayer.is_replaying()) {
+		chat_handler_functions::show_error(player, "A capture is already being replayed");
+		return chat_result::handled_display;
+	}
+	if (replayer.replay(filename, speed) == result::failure) {
+		chat_handler_functions::show_error(player, "Unable to read a capture from " + filename);
+		return chat_result::handled_display;
+	}
+
+	channel_server::get_instance().log(vana::log::type::gm_command, "GM started replaying " + filename + ". GM: " + player->get_name());
+	chat_handler_functions::show_info(player, "Replaying " + filename + ", the results are logged when it finishes");
+	return chat_result::handled_display;
+}
+
 }
 }
\ No newline at end of file
@@ -49,6 +49,8 @@ namespace vana {
 			auto rehash(ref_ptr<player> player, const game_chat &args) -> chat_result;
 			auto rates(ref_ptr<player> player, const game_chat &args) -> chat_result;
 			auto packet(ref_ptr<player> player, const game_chat &args) -> chat_result;
+			auto capture(ref_ptr<player> player, const game_chat &args) -> chat_result;
+			auto replay(ref_ptr<player> player, const game_chat &args) -> chat_result;
 		}
 	}
 }
\ No newline at end of file
@@ -69,6 +69,10 @@ map::map(ref_ptr<const data::type::map_info> info, game_map_id id) :
 	m_object_ids{1000},
 	m_music{info->default_music}
 {
+	// Everything that touches this map's state (its timers, mob timers, and the packets of players on it) is serialized on this strand
+	m_strand = make_ref_ptr<asio::io_service::strand>(channel_server::get_instance().get_io_service());
+	set_timer_dispatcher(get_timer_dispatcher());
+
 	point right_bottom = info->dimensions.right_bottom();
 	double map_height = std::max<double>(right_bottom.y - 450, 600);
 	double map_width = std::max<double>(right_bottom.x, 800);
@@ -80,7 +84,16 @@ map::map(ref_ptr<const data::type::map_info> info, game_map_id id) :
 		m_real_dimensions = info->dimensions;
 	}
 
-	for (const auto &foothold : info->link_info->footholds) add_foothold(foothold);
+	m_footholds = foothold_index{info->link_info->footholds};
+	if (m_infer_size_from_footholds) {
+		for (const auto &foothold : info->link_info->footholds) {
+			m_real_dimensions = m_real_dimensions.combine(foothold.line.make_rect());
+		}
+	}
+	game_coord aoi_radius = channel_server::get_instance().get_inter_server_config().map_aoi_radius;
+	if (aoi_radius > 0) {
+		m_aoi = make_owned_ptr<aoi_grid>(m_real_dimensions, aoi_radius);
+	}
 	for (const auto &mob : info->link_info->mobs) add_mob_spawn(mob);
 	for (const auto &npc : info->link_info->npcs) add_npc(npc);
 	for (const auto &portal : info->link_info->portals) add_portal(portal);
@@ -124,14 +137,14 @@ auto map::make_reactor_id() -> game_map_object {
 	return m_reactor_spawns.size() - 1 + reactor_start;
 }
 
-// Data initialization
-auto map::add_foothold(const data::type::foothold_info &foothold) -> void {
-	m_footholds.push_back(foothold);
-	if (m_infer_size_from_footholds) {
-		m_real_dimensions = m_real_dimensions.combine(foothold.line.make_rect());
-	}
+auto map::get_timer_dispatcher() const -> vana::timer::dispatcher {
+	ref_ptr<asio::io_service::strand> strand = m_strand;
+	return [strand](function<void()> work) {
+		strand->post(work);
+	};
 }
 
+// Data initialization
 auto map::add_seat(const data::type::seat_info &seat) -> void {
 	map_seat record;
 	record.info = seat;
@@ -182,11 +195,14 @@ auto map::add_time_mob(data::type::time_mob_info info) -> void {
 // Players
 auto map::add_player(ref_ptr<player> player) -> void {
 	m_players.push_back(player);
+	if (m_aoi != nullptr) {
+		m_aoi->add(player);
+	}
 	if (m_info->force_map_equip) {
 		player->send(packets::map::force_map_equip());
 	}
 	if (!player->is_using_gm_hide()) {
-		send(packets::map::player_packet(player), player);
+		send_nearby(packets::map::player_packet(player), player->get_pos(), player);
 	}
 	else {
 		player->send(packets::gm::begin_hide());
@@ -281,6 +297,9 @@ auto map::remove_player(ref_ptr<player> player) -> void {
 			break;
 		}
 	}
+	if (m_aoi != nullptr) {
+		m_aoi->remove(player);
+	}
 
 	player->get_active_buffs()->reset_homing_beacon_mob();
 
@@ -348,7 +367,7 @@ auto map::gm_hide_change(ref_ptr<player> player) -> void {
 		send(packets::map::remove_player(player->get_id()), player);
 	}
 	else {
-		send(packets::map::player_packet(player), player);
+		send_nearby(packets::map::player_packet(player), player->get_pos(), player);
 		for (const auto &kvp : m_mobs) {
 			if (auto mob = kvp.second) {
 				if (mob->get_controller() == nullptr && mob->get_control_status() != mob_control_status::none) {
@@ -412,13 +431,13 @@ auto map::find_floor(const point &pos, point &floor_pos, game_coord start_height
 	bool any_found = false;
 	data::type::foothold_info const * found_foothold = nullptr;
 
-	for (const auto &foothold : m_footholds) {
+	m_footholds.for_each_candidate(x, [&](const data::type::foothold_info &foothold) {
 		const line &line = foothold.line;
 
 		if (line.within_range_x(x)) {
 			if (search_area.area() != 0) {
 				if (!search_area.contains_any_part_of_line(line)) {
-					continue;
+					return;
 				}
 			}
 
@@ -432,7 +451,7 @@ auto map::find_floor(const point &pos, point &floor_pos, game_coord start_height
 				}
 			}
 		}
-	}
+	});
 
 	if (any_found) {
 		// We interpolate for X here because otherwise, the X value may not be on the same slope as the foothold
@@ -462,14 +481,11 @@ auto map::find_random_floor_pos() -> point {
 }
 
 auto map::find_random_floor_pos(const rect &area) -> point {
-	vector<const data::type::foothold_info *> valid_footholds;
 	rect inside_map_area = area.intersection(m_real_dimensions);
-	for (const auto &foothold : m_footholds) {
+	auto is_valid_floor = [&inside_map_area](const data::type::foothold_info &foothold) -> bool {
 		// Vertical lines can't be "floors"
-		if (!foothold.line.is_vertical() && inside_map_area.contains_any_part_of_line(foothold.line)) {
-			valid_footholds.push_back(&foothold);
-		}
-	}
+		return !foothold.line.is_vertical() && inside_map_area.contains_any_part_of_line(foothold.line);
+	};
 
 	point left_top = inside_map_area.left_top();
 	point right_bottom = inside_map_area.right_bottom();
@@ -477,7 +493,7 @@ auto map::find_random_floor_pos(const rect &area) -> point {
 	auto y_generate = [&right_bottom, &left_top]() -> game_coord { return vana::util::randomizer::rand<game_coord>(right_bottom.y, left_top.y); };
 
 	point ret;
-	if (valid_footholds.size() == 0) {
+	if (!m_footholds.any_in_range(left_top.x, right_bottom.x, is_valid_floor)) {
 		// There's no saving this, just use a random point in the area
 		ret.x = x_generate();
 		ret.y = y_generate();
@@ -490,9 +506,9 @@ auto map::find_random_floor_pos(const rect &area) -> point {
 		bool any_found = false;
 		game_coord closest_value = std::numeric_limits<game_coord>::max();
 
-		for (const auto &foothold : valid_footholds) {
-			if (foothold->line.within_range_x(x)) {
-				optional<game_coord> y_interpolation = foothold->line.interpolate_for_y(x);
+		m_footholds.for_each_candidate(x, [&](const data::type::foothold_info &foothold) {
+			if (foothold.line.within_range_x(x) && is_valid_floor(foothold)) {
+				optional<game_coord> y_interpolation = foothold.line.interpolate_for_y(x);
 				if (y_interpolation.is_initialized()) {
 					auto value = y_interpolation.get();
 					if (value <= closest_value && value >= y) {
@@ -501,7 +517,7 @@ auto map::find_random_floor_pos(const rect &area) -> point {
 					}
 				}
 			}
-		}
+		});
 
 		if (any_found) {
 			ret.x = x;
@@ -514,43 +530,27 @@ auto map::find_random_floor_pos(const rect &area) -> point {
 }
 
 auto map::get_foothold_at_position(const point &pos) -> game_foothold_id {
-	// TODO FIXME
-	// Consider refactoring
-	game_foothold_id foothold = 0;
-	for (const auto &cur : m_footholds) {
-		if (cur.line.contains(pos)) {
-			foothold = cur.id;
-			break;
+	const data::type::foothold_info *found = nullptr;
+	m_footholds.for_each_candidate(pos.x, [&](const data::type::foothold_info &cur) {
+		if (found == nullptr && cur.line.contains(pos)) {
+			found = &cur;
 		}
-	}
-	return foothold;
+	});
+	return found != nullptr ? found->id : 0;
 }
 
 auto map::is_valid_foothold(game_foothold_id id) -> bool {
-	for (const auto &cur : m_footholds) {
-		if (cur.id == id) {
-			return true;
-		}
-	}
-	return false;
+	return m_footholds.find(id) != nullptr;
 }
 
 auto map::is_vertical_foothold(game_foothold_id id) -> bool {
-	for (const auto &cur : m_footholds) {
-		if (cur.id == id) {
-			return cur.line.is_vertical();
-		}
-	}
-	return false;
+	auto foothold = m_footholds.find(id);
+	return foothold != nullptr && foothold->line.is_vertical();
 }
 
 auto map::get_position_at_foothold(game_foothold_id id) -> point {
-	for (const auto &cur : m_footholds) {
-		if (cur.id == id) {
-			return cur.line.center();
-		}
-	}
-	return point{-1, -1};
+	auto foothold = m_footholds.find(id);
+	return foothold != nullptr ? foothold->line.center() : point{-1, -1};
 }
 
 // Portals
@@ -680,6 +680,7 @@ auto map::spawn_mob(game_mob_id mob_id, const point &pos, game_foothold_id footh
 	game_map_object id = m_object_ids.lease();
 
 	auto value = make_ref_ptr<mob>(id, get_id(), mob_id, summon_effect != 0 ? owner : nullptr, pos, -1, false, foothold, mob_control_status::normal);
+	value->set_timer_dispatcher(get_timer_dispatcher());
 	if (summon_effect != 0) {
 		owner->add_spawn(id, value);
 	}
@@ -700,6 +701,7 @@ auto map::spawn_mob(int32_t spawn_id, const data::type::mob_spawn_info &info) ->
 
 	ref_ptr<mob> no_owner = nullptr;
 	auto value = make_ref_ptr<mob>(id, get_id(), info.id, no_owner, info.pos, spawn_id, info.faces_left, info.foothold, mob_control_status::normal);
+	value->set_timer_dispatcher(get_timer_dispatcher());
 	m_mobs[id] = value;
 	send(packets::mobs::spawn_mob(value, 0, nullptr, mob_spawn_type::spawn));
 	update_mob_control(value, mob_spawn_type::spawn);
@@ -716,6 +718,7 @@ auto map::spawn_shell(game_mob_id mob_id, const point &pos, game_foothold_id foo
 
 	ref_ptr<mob> no_owner = nullptr;
 	auto value = make_ref_ptr<mob>(id, get_id(), mob_id, no_owner, pos, -1, false, foothold, mob_control_status::none);
+	value->set_timer_dispatcher(get_timer_dispatcher());
 	m_mobs[id] = value;
 	send(packets::mobs::spawn_mob(value, -4, nullptr, mob_spawn_type::spawn));
 	update_mob_control(value, mob_spawn_type::spawn);
@@ -1309,7 +1312,8 @@ auto map::show_objects(ref_ptr<player> player) -> void {
 	}
 
 	// Players
-	for (const auto &map_player : m_players) {
+	auto visible_players = m_aoi != nullptr ? m_aoi->get_nearby(player->get_pos()) : m_players;
+	for (const auto &map_player : visible_players) {
 		if (player != map_player && !map_player->is_using_gm_hide()) {
 			player->send(packets::map::player_packet(map_player));
 			summon_handler::show_summons(map_player, player);
@@ -1380,6 +1384,7 @@ auto map::show_objects(ref_ptr<player> player) -> void {
 }
 
 auto map::send(const packet_builder &builder, ref_ptr<player> sender) -> void {
+	// Each recipient shares the builder's buffer, only sessions that encrypt make a (pooled) copy of it
 	for (const auto &map_player : m_players) {
 		if (map_player != sender) {
 			map_player->send(builder);
@@ -1403,6 +1408,51 @@ auto map::send(const split_packet_builder &builder, ref_ptr<player> sender) -> v
 	}
 }
 
+auto map::send_nearby(const packet_builder &builder, const point &pos, ref_ptr<player> sender) -> void {
+	if (m_aoi == nullptr) {
+		send(builder, sender);
+		return;
+	}
+
+	for (const auto &map_player : m_aoi->get_nearby(pos)) {
+		if (map_player != sender) {
+			map_player->send(builder);
+		}
+	}
+}
+
+auto map::update_player_position(ref_ptr<player> player) -> void {
+	if (m_aoi == nullptr) {
+		return;
+	}
+
+	vector<ref_ptr<vana::channel_server::player>> entered_view;
+	vector<ref_ptr<vana::channel_server::player>> left_view;
+	m_aoi->update(player, entered_view, left_view);
+
+	for (const auto &other : entered_view) {
+		if (!player->is_using_gm_hide()) {
+			other->send(packets::map::player_packet(player));
+			summon_handler::show_summons(player, other);
+		}
+		if (!other->is_using_gm_hide()) {
+			player->send(packets::map::player_packet(other));
+			summon_handler::show_summons(other, player);
+		}
+	}
+
+	for (const auto &other : left_view) {
+		if (!player->is_using_gm_hide()) {
+			summon_handler::hide_summons(player, other);
+			other->send(packets::map::remove_player(player->get_id()));
+		}
+		if (!other->is_using_gm_hide()) {
+			summon_handler::hide_summons(other, player);
+			player->send(packets::map::remove_player(other->get_id()));
+		}
+	}
+}
+
 auto map::create_weather(ref_ptr<player> player, bool admin_weather, int32_t time, int32_t item_id, const string &message) -> bool {
 	vana::timer::id timer_id{vana::timer::type::weather_timer}; // Just to check if there's already a weather item running and adding a new one
 	if (get_timers()->is_timer_running(timer_id)) {
@@ -30,8 +30,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common/timer/container_holder.hpp"
 #include "common/types.hpp"
 #include "common/util/id_pool.hpp"
+#include "channel_server/aoi_grid.hpp"
+#include "channel_server/foothold_index.hpp"
 #include "channel_server/map_factory.hpp"
 #include "channel_server/mob.hpp"
+#include <asio.hpp>
 #include <ctime>
 #include <functional>
 #include <map>
@@ -113,6 +116,10 @@ namespace vana {
 			auto get_dimensions() const -> rect { return m_real_dimensions; }
 			auto get_music() const -> string { return m_music; }
 
+			// Threading
+			auto get_strand() -> asio::io_service::strand & { return *m_strand; }
+			auto get_timer_dispatcher() const -> vana::timer::dispatcher;
+
 			// Footholds
 			auto find_floor(const point &pos, point &floor_pos, game_coord start_height_modifier = 0, const rect &search_area = rect{}) -> search_result;
 			auto get_foothold_at_position(const point &pos) -> game_foothold_id;
@@ -147,6 +154,8 @@ namespace vana {
 			auto run_function_players(const rect &dimensions, int16_t prop, int16_t count, function<void(ref_ptr<player>)> success_func) -> void;
 			auto run_function_players(function<void(ref_ptr<player>)> success_func) -> void;
 			auto gm_hide_change(ref_ptr<player> player) -> void;
+			// Spawns and despawns players for each other as they move in and out of each other's area of interest
+			auto update_player_position(ref_ptr<player> player) -> void;
 			auto get_all_player_ids() const -> vector<game_player_id>;
 
 			// NPCs
@@ -198,6 +207,8 @@ namespace vana {
 			// Packet stuff
 			auto send(const packet_builder &builder, ref_ptr<player> sender = nullptr) -> void;
 			auto send(const split_packet_builder &builder, ref_ptr<player> sender) -> void;
+			// Only sends to players whose area of interest includes pos, or to the whole map when AOI filtering is disabled
+			auto send_nearby(const packet_builder &builder, const point &pos, ref_ptr<player> sender = nullptr) -> void;
 
 			// Instance
 			auto set_instance(instance *inst) -> void { m_instance = inst; }
@@ -216,7 +227,6 @@ namespace vana {
 			// Remove this crap comment once MSVC supports static initializers
 			static int32_t s_map_unload_time/* = 0*/;
 
-			auto add_foothold(const data::type::foothold_info &foothold) -> void;
 			auto add_seat(const data::type::seat_info &seat) -> void;
 			auto add_portal(const data::type::portal_info &portal) -> void;
 			auto add_mob_spawn(const data::type::mob_spawn_info &spawn) -> void;
@@ -259,12 +269,14 @@ namespace vana {
 			time_point m_last_spawn = time_point{seconds{0}};
 			string m_music;
 			rect m_real_dimensions;
+			ref_ptr<asio::io_service::strand> m_strand;
 			vana::util::id_pool<game_map_object> m_object_ids;
 			vana::util::id_pool<game_mist_id> m_mist_ids;
+			owned_ptr<aoi_grid> m_aoi;
 			recursive_mutex m_drops_mutex;
 			recursive_mutex m_kites_mutex;
 			ref_ptr<const data::type::map_info> m_info;
-			vector<data::type::foothold_info> m_footholds;
+			foothold_index m_footholds;
 			vector<data::type::reactor_spawn_info> m_reactor_spawns;
 			vector<data::type::npc_spawn_info> m_npc_spawns;
 			vector<data::type::mob_spawn_info> m_mob_spawns;
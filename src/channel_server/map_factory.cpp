@@ -28,34 +28,68 @@ namespace vana {
 namespace channel_server {
 
 auto map_factory::get_map(game_map_id map_id) -> map * {
+	map *existing = find_map(map_id);
+	if (existing != nullptr) {
+		return existing;
+	}
+
 	owned_lock<mutex> l{m_load_mutex};
-	for (auto &map : m_maps) {
-		if (map->get_id() == map_id) {
-			return map;
-		}
+	// Someone else may have created it while we were waiting on the lock
+	existing = find_map(map_id);
+	if (existing != nullptr) {
+		return existing;
 	}
 
 	auto info = channel_server::get_instance().get_map_data_provider().get_map(map_id);
 	map *map = new vana::channel_server::map{info, map_id};
-	m_maps.push_back(map);
+
+	auto current = std::atomic_load(&m_maps);
+	auto copy = current == nullptr ?
+		make_ref_ptr<registry>() :
+		make_ref_ptr<registry>(*current);
+
+	copy->emplace(map_id, map);
+	std::atomic_store(&m_maps, ref_ptr<const registry>{copy});
 	return map;
 }
 
 auto map_factory::unload_map(game_map_id map_id) -> void {
+	if (find_map(map_id) == nullptr) {
+		return;
+	}
+
 	owned_lock<mutex> l{m_load_mutex};
-	for (size_t i = 0; i < m_maps.size(); i++) {
-		auto map = m_maps[i];
-		if (map->get_id() == map_id) {
-			// We could run into a situation where unload_map has been called while a lock is out on get_map
-			// Reasons for this might be: Starting an instance, adding a player
-			// Once the code here advances, we have to ensure that we're doing the right thing, otherwise there could be a serious problem
-			if (map->get_num_players() == 0 && map->get_instance() == nullptr) {
-				delete map;
-				m_maps.erase(std::begin(m_maps) + i);
-			}
-			break;
-		}
+	auto current = std::atomic_load(&m_maps);
+	auto kvp = current->find(map_id);
+	if (kvp == std::end(*current)) {
+		return;
+	}
+
+	auto map = kvp->second;
+	// We could run into a situation where unload_map has been called while a lock is out on get_map
+	// Reasons for this might be: Starting an instance, adding a player
+	// Once the code here advances, we have to ensure that we're doing the right thing, otherwise there could be a serious problem
+	if (map->get_num_players() != 0 || map->get_instance() != nullptr) {
+		return;
+	}
+
+	auto copy = make_ref_ptr<registry>(*current);
+	copy->erase(map_id);
+	std::atomic_store(&m_maps, ref_ptr<const registry>{copy});
+	delete map;
+}
+
+auto map_factory::find_map(game_map_id map_id) const -> map * {
+	auto maps = std::atomic_load(&m_maps);
+	if (maps == nullptr) {
+		return nullptr;
+	}
+
+	auto kvp = maps->find(map_id);
+	if (kvp == std::end(*maps)) {
+		return nullptr;
 	}
+	return kvp->second;
 }
 
 }
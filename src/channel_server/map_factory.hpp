@@ -36,8 +36,14 @@ namespace vana {
 			auto get_map(game_map_id map_id) -> map *;
 			auto unload_map(game_map_id map_id) -> void;
 		private:
+			using registry = hash_map<game_map_id, map *>;
+
+			auto find_map(game_map_id map_id) const -> map *;
+
+			// Lookups read an immutable snapshot of the registry without locking
+			// Creating and unloading maps copy it under the mutex and publish the copy
 			mutex m_load_mutex;
-			vector<map *> m_maps;
+			ref_ptr<const registry> m_maps;
 		};
 	}
 }
\ No newline at end of file
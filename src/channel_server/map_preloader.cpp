@@ -0,0 +1,157 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "map_preloader.hpp"
+#include "common/util/thread_pool.hpp"
+#include "channel_server/channel_server.hpp"
+#include <utility>
+
+namespace vana {
+namespace channel_server {
+
+auto map_preloader::start(const vector<game_map_id> &maps) -> void {
+	for (const auto &map_id : maps) {
+		prefetch(map_id);
+	}
+
+	m_thread = vana::util::thread_pool::lease(
+		[this](owned_lock<recursive_mutex> &lock) {
+			if (m_pending.empty()) {
+				m_pending_condition.wait(lock);
+				return;
+			}
+
+			game_map_id map_id = m_pending.front();
+			m_pending.pop_front();
+
+			lock.unlock();
+			bool loaded = load(map_id);
+			lock.lock();
+
+			m_queued.erase(map_id);
+			if (!loaded) {
+				m_failed.insert(map_id);
+			}
+
+			vector<function<void(bool)>> waiters;
+			auto kvp = m_waiters.find(map_id);
+			if (kvp != std::end(m_waiters)) {
+				waiters = std::move(kvp->second);
+				m_waiters.erase(kvp);
+			}
+
+			lock.unlock();
+			for (const auto &continuation : waiters) {
+				continuation(loaded);
+			}
+			lock.lock();
+		},
+		[this] {
+			// Taking the lock guarantees the loader is either waiting or has yet to check the queue
+			owned_lock<recursive_mutex> l{m_mutex};
+			m_pending_condition.notify_one();
+		},
+		m_mutex);
+}
+
+auto map_preloader::is_loaded(game_map_id map_id) -> bool {
+	return channel_server::get_instance().get_map_data_provider().is_loaded(map_id);
+}
+
+auto map_preloader::prefetch(game_map_id map_id) -> void {
+	if (is_loaded(map_id)) {
+		return;
+	}
+
+	owned_lock<recursive_mutex> l{m_mutex};
+	if (m_failed.find(map_id) == std::end(m_failed)) {
+		enqueue(map_id, false);
+	}
+}
+
+auto map_preloader::prefetch_neighbors(game_map_id map_id) -> void {
+	auto info = channel_server::get_instance().get_map_data_provider().get_map(map_id);
+	auto link_info = std::atomic_load(&info->link_info);
+	if (link_info == nullptr) {
+		return;
+	}
+
+	for (const auto &portal : link_info->portals) {
+		if (portal.to_map != map_id) {
+			prefetch(portal.to_map);
+		}
+	}
+}
+
+auto map_preloader::when_loaded(game_map_id map_id, function<void(bool)> continuation) -> void {
+	bool loaded = true;
+	{
+		owned_lock<recursive_mutex> l{m_mutex};
+		if (!is_loaded(map_id)) {
+			// Waiting on a map that already failed would only fail again, over and over for every portal use
+			loaded = false;
+			if (m_failed.find(map_id) == std::end(m_failed)) {
+				m_waiters[map_id].push_back(continuation);
+				enqueue(map_id, true);
+				return;
+			}
+		}
+	}
+
+	continuation(loaded);
+}
+
+auto map_preloader::clear_failures() -> void {
+	owned_lock<recursive_mutex> l{m_mutex};
+	m_failed.clear();
+}
+
+auto map_preloader::enqueue(game_map_id map_id, bool urgent) -> void {
+	if (urgent) {
+		// Someone is waiting on this one, so it skips ahead of the prefetches
+		// A stale copy further back in the queue is harmless, loading it again is a no-op
+		m_queued.insert(map_id);
+		m_pending.push_front(map_id);
+	}
+	else if (m_queued.insert(map_id).second) {
+		m_pending.push_back(map_id);
+	}
+	else {
+		return;
+	}
+
+	m_pending_condition.notify_one();
+}
+
+auto map_preloader::load(game_map_id map_id) -> bool {
+	try {
+		channel_server::get_instance().get_map_data_provider().get_map(map_id);
+	}
+	catch (codepath_invalid_exception &) {
+		// The map doesn't exist, anyone waiting on it finds that out the same way they would have without the preloader
+	}
+	catch (std::exception &e) {
+		channel_server::get_instance().log(vana::log::type::error, [&](out_stream &log) {
+			log << "Failed to preload map " << map_id << ": " << e.what();
+		});
+		return false;
+	}
+	return true;
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/types.hpp"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vana {
+	namespace channel_server {
+		// Loads map data (footholds, life, portals, seats, time mobs) on a background thread
+		// Loading a map takes several queries, so doing it inside a packet handler stalls everyone on that io thread
+		class map_preloader {
+			NONCOPYABLE(map_preloader);
+		public:
+			map_preloader() = default;
+
+			auto start(const vector<game_map_id> &maps) -> void;
+			auto is_loaded(game_map_id map_id) -> bool;
+			auto prefetch(game_map_id map_id) -> void;
+			auto prefetch_neighbors(game_map_id map_id) -> void;
+			// Runs the continuation on the loader thread once the map is loaded, or right away when it already is
+			// The continuation is told false when the map couldn't be loaded, it isn't tried again until clear_failures
+			auto when_loaded(game_map_id map_id, function<void(bool)> continuation) -> void;
+			auto clear_failures() -> void;
+		private:
+			auto enqueue(game_map_id map_id, bool urgent) -> void;
+			auto load(game_map_id map_id) -> bool;
+
+			queue<game_map_id> m_pending;
+			hash_set<game_map_id> m_queued;
+			hash_set<game_map_id> m_failed;
+			hash_map<game_map_id, vector<function<void(bool)>>> m_waiters;
+			std::condition_variable_any m_pending_condition;
+			recursive_mutex m_mutex;
+			ref_ptr<std::thread> m_thread;
+		};
+	}
+}
\ No newline at end of file
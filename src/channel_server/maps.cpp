@@ -16,8 +16,8 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "maps.hpp"
+#include "common/lua/chunk_cache.hpp"
 #include "common/packet_reader.hpp"
-#include "common/util/file.hpp"
 #include "channel_server/channel_server.hpp"
 #include "channel_server/instance.hpp"
 #include "channel_server/inventory.hpp"
@@ -56,7 +56,7 @@ auto maps::use_portal(ref_ptr<player> player, const data::type::portal_info * co
 
 		string filename = channel_server::get_instance().get_script_data_provider().build_script_path(data::type::script_type::portal, portal->script);
 
-		if (vana::util::file::exists(filename)) {
+		if (vana::lua::chunk_cache::exists(filename)) {
 			lua::lua_portal lua_env = {filename, player->get_id(), player->get_map_id(), portal};
 
 			if (!lua_env.player_map_changed()) {
@@ -76,6 +76,44 @@ auto maps::use_portal(ref_ptr<player> player, const data::type::portal_info * co
 	}
 	else {
 		// Normal portal
+		auto &preloader = channel_server::get_instance().get_map_preloader();
+		if (!preloader.is_loaded(portal->to_map)) {
+			// Loading the destination here would stall every other player on this thread
+			// The portal is looked up again afterwards since the player's map may have been reloaded in the meantime
+			view_ptr<vana::channel_server::player> weak_player = player;
+			game_map_id from_map = player->get_map_id();
+			string portal_name = portal->name;
+			preloader.when_loaded(portal->to_map, [weak_player, from_map, portal_name](bool loaded) {
+				auto player = weak_player.lock();
+				if (player == nullptr) {
+					return;
+				}
+
+				// This runs on the preloader thread, dispatch reads the player's map so it has to happen on the player's own strand
+				player->post([player, from_map, portal_name, loaded] {
+					player->dispatch([player, from_map, portal_name, loaded] {
+						if (player->is_disconnecting() || player->get_map_id() != from_map) {
+							return;
+						}
+
+						if (!loaded) {
+							// Going through the portal again would just wait on the same failed load
+							player->send(packets::player::show_message("bzzt. the map you're attempting to travel to doesn't exist.", packets::player::notice_types::red));
+							player->send(packets::map::portal_blocked(packets::map::portal_blocked_reason::no_reason));
+							return;
+						}
+
+						map *current_map = player->get_map();
+						const data::type::portal_info * const portal = current_map == nullptr ? nullptr : current_map->get_portal(portal_name);
+						if (portal != nullptr) {
+							use_portal(player, portal);
+						}
+					});
+				});
+			});
+			return;
+		}
+
 		map *to_map = get_map(portal->to_map);
 		if (to_map == nullptr) {
 			player->send(packets::player::show_message("bzzt. the map you're attempting to travel to doesn't exist.", packets::player::notice_types::red));
@@ -195,6 +233,7 @@ auto maps::use_scripted_portal(ref_ptr<player> player, packet_reader &reader) ->
 auto maps::add_player(ref_ptr<player> player, game_map_id map_id) -> void {
 	get_map(map_id)->add_player(player);
 	get_map(map_id)->show_objects(player);
+	channel_server::get_instance().get_map_preloader().prefetch_neighbors(map_id);
 	pet_handler::show_pets(player);
 	summon_handler::show_summon(player);
 	// Bug in global - would be fixed here:
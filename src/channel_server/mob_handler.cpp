@@ -160,6 +160,7 @@ auto mob_handler::monster_control(ref_ptr<player> player, packet_reader &reader)
 
 	player->send(packets::mobs::move_mob_response(mob_id, move_id, next_movement_could_be_skill, mob->get_mp(), next_cast_skill, next_cast_skill_level));
 	
+	// Mob movement goes to the whole map, players coming into range aren't sent the mobs again so they'd see them where they last moved in view
 	player->send_map(packets::mobs::move_mob(mob_id, next_movement_could_be_skill, raw_activity, use_skill_id, use_skill_level, option, path), true);
 }
 
@@ -17,8 +17,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "npc.hpp"
 #include "common/data/provider/script.hpp"
+#include "common/lua/chunk_cache.hpp"
 #include "common/session.hpp"
-#include "common/util/file.hpp"
 #include "channel_server/channel_server.hpp"
 #include "channel_server/lua/lua_npc.hpp"
 #include "channel_server/npc_packet.hpp"
@@ -60,7 +60,7 @@ auto npc::has_script(int32_t npc_id, game_quest_id quest_id, bool start) -> bool
 	else {
 		script = channel.get_script_data_provider().get_quest_script(&channel, quest_id, start ? 0 : 1);
 	}
-	return vana::util::file::exists(script);
+	return vana::lua::chunk_cache::exists(script);
 }
 
 auto npc::get_script(game_quest_id quest_id, bool start) -> string {
@@ -72,7 +72,7 @@ auto npc::get_script(game_quest_id quest_id, bool start) -> string {
 }
 
 auto npc::init_script(const string &filename) -> void {
-	if (vana::util::file::exists(filename)) {
+	if (vana::lua::chunk_cache::exists(filename)) {
 		m_lua_npc = make_owned_ptr<lua::lua_npc>(filename, m_player->get_id());
 		m_player->set_npc(this);
 	}
@@ -0,0 +1,159 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "packet_replayer.hpp"
+#include "common/packet_reader.hpp"
+#include "common/session.hpp"
+#include "common/util/thread_pool.hpp"
+#include "common/util/time.hpp"
+#include "channel_server/channel_server.hpp"
+#include "channel_server/cmsg_header.hpp"
+#include "channel_server/player_data_provider.hpp"
+
+namespace vana {
+namespace channel_server {
+
+auto packet_replayer::start() -> void {
+	m_thread = vana::util::thread_pool::lease(
+		[this](owned_lock<recursive_mutex> &lock) {
+			step(lock);
+		},
+		[this] {
+			owned_lock<recursive_mutex> l{m_mutex};
+			m_condition.notify_all();
+		},
+		m_mutex);
+}
+
+auto packet_replayer::replay(const string &filename, double speed) -> result {
+	auto reader = make_owned_ptr<packet_capture::reader>(filename);
+	if (!reader->is_valid()) {
+		return result::failure;
+	}
+
+	owned_lock<recursive_mutex> l{m_mutex};
+	if (m_reader != nullptr) {
+		return result::failure;
+	}
+
+	m_reader = std::move(reader);
+	m_filename = filename;
+	m_speed = speed;
+	m_packets = 0;
+	m_sessions_opened = 0;
+	m_has_pending = false;
+	m_has_base = false;
+	m_started = vana::util::time::get_now();
+	m_condition.notify_one();
+	return result::success;
+}
+
+auto packet_replayer::is_replaying() -> bool {
+	owned_lock<recursive_mutex> l{m_mutex};
+	return m_reader != nullptr;
+}
+
+auto packet_replayer::step(owned_lock<recursive_mutex> &lock) -> void {
+	if (m_reader == nullptr) {
+		m_condition.wait(lock);
+		return;
+	}
+
+	if (!m_has_pending) {
+		if (!m_reader->next(m_pending)) {
+			finish();
+			return;
+		}
+		m_has_pending = true;
+
+		if (!m_has_base) {
+			// Whatever time passed between starting the capture and the first client connecting isn't replayed
+			m_base = m_pending.offset;
+			m_has_base = true;
+		}
+	}
+
+	if (m_speed > 0) {
+		auto due = m_started + duration_cast<time_point::duration>(microseconds{static_cast<int64_t>((m_pending.offset - m_base).count() / m_speed)});
+		if (vana::util::time::get_now() < due) {
+			m_condition.wait_until(lock, due);
+			return;
+		}
+	}
+
+	m_has_pending = false;
+	apply(m_pending);
+}
+
+auto packet_replayer::apply(const packet_capture::record &record) -> void {
+	auto &channel = channel_server::get_instance();
+	switch (record.kind) {
+		case packet_capture::record_kind::open: {
+			m_sessions[record.session] = channel.open_replay_session(record.source);
+			m_sessions_opened++;
+			break;
+		}
+		case packet_capture::record_kind::packet: {
+			auto kvp = m_sessions.find(record.session);
+			if (kvp == std::end(m_sessions) || record.data.size() < sizeof(packet_header)) {
+				break;
+			}
+
+			ref_ptr<session> current = kvp->second;
+			packet_reader reader{const_cast<unsigned char *>(record.data.data()), record.data.size()};
+			if (reader.get<packet_header>() == CMSG_PLAYER_LOAD && reader.get_buffer_length() >= sizeof(game_player_id)) {
+				// The world server would normally have told us this player is on the way
+				game_player_id player_id = reader.get<game_player_id>();
+				ip source = current->get_ip();
+				current->post([player_id, source] {
+					channel_server::get_instance().get_player_data_provider().expect_player(player_id, source);
+				});
+			}
+
+			current->replay(record.data);
+			m_packets++;
+			break;
+		}
+		case packet_capture::record_kind::close: {
+			auto kvp = m_sessions.find(record.session);
+			if (kvp == std::end(m_sessions)) {
+				break;
+			}
+
+			kvp->second->replay_disconnect();
+			m_sessions.erase(kvp);
+			break;
+		}
+	}
+}
+
+auto packet_replayer::finish() -> void {
+	// Sessions that were still open when the capture stopped
+	for (const auto &kvp : m_sessions) {
+		kvp.second->replay_disconnect();
+	}
+	m_sessions.clear();
+
+	auto elapsed = vana::util::time::get_distance<milliseconds>(vana::util::time::get_now(), m_started);
+	channel_server::get_instance().log(vana::log::type::info, [&](out_stream &log) {
+		log << "Replayed " << m_packets << " packets from " << m_sessions_opened << " sessions in " << m_filename << " over " << elapsed << " ms";
+	});
+	m_reader.reset();
+}
+
+}
+}
\ No newline at end of file
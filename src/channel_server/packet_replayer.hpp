@@ -0,0 +1,65 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/packet_capture.hpp"
+#include "common/types.hpp"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace vana {
+	class session;
+
+	namespace channel_server {
+		// Plays a packet capture back through the same handlers real clients go through, only without sockets
+		// Every captured session gets a player of its own, so the characters need to exist in the database the channel is using
+		// The world server still has to know about the characters, they're let in without the world's usual go-ahead
+		class packet_replayer {
+			NONCOPYABLE(packet_replayer);
+		public:
+			packet_replayer() = default;
+
+			auto start() -> void;
+			// A speed of 2 replays twice as fast as the capture was recorded, 0 replays as fast as the packets are taken
+			auto replay(const string &filename, double speed) -> result;
+			auto is_replaying() -> bool;
+		private:
+			auto step(owned_lock<recursive_mutex> &lock) -> void;
+			auto apply(const packet_capture::record &record) -> void;
+			auto finish() -> void;
+
+			bool m_has_pending = false;
+			bool m_has_base = false;
+			double m_speed = 1;
+			uint64_t m_packets = 0;
+			uint64_t m_sessions_opened = 0;
+			microseconds m_base;
+			time_point m_started;
+			string m_filename;
+			packet_capture::record m_pending;
+			owned_ptr<packet_capture::reader> m_reader;
+			hash_map<uint32_t, ref_ptr<session>> m_sessions;
+			std::condition_variable_any m_condition;
+			recursive_mutex m_mutex;
+			ref_ptr<std::thread> m_thread;
+		};
+	}
+}
\ No newline at end of file
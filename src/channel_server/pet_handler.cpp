@@ -42,7 +42,7 @@ auto pet_handler::handle_movement(ref_ptr<player> player, packet_reader &reader)
 
 	move_path path(reader);
 	pet->reset_from_move_path(path);
-	player->send_map(packets::pets::show_movement(player->get_id(), pet, path));
+	player->send_nearby(packets::pets::show_movement(player->get_id(), pet, path));
 }
 
 auto pet_handler::handle_chat(ref_ptr<player> player, packet_reader &reader) -> void {
@@ -58,6 +58,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "channel_server/player_data_provider.hpp"
 #include "channel_server/player_handler.hpp"
 #include "channel_server/player_packet.hpp"
+#include "channel_server/player_saver.hpp"
 #include "channel_server/quests.hpp"
 #include "channel_server/reactor_handler.hpp"
 #include "channel_server/server_packet.hpp"
@@ -69,16 +70,31 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "channel_server/trade_handler.hpp"
 #include "channel_server/world_server_session.hpp"
 #include <array>
+#include <atomic>
 #include <stdexcept>
 
 namespace vana {
 namespace channel_server {
 
+// How often a disconnect save is tried before giving up on it
+const uint8_t offline_save_attempts = 3;
+
 player::player() :
 	movable_life{0, point{}, 0}
 {
 }
 
+auto player::dispatch(function<void()> work) -> void {
+	// Once the player is on a map, their packets are processed on the map's strand alongside its timers
+	if (m_is_connect) {
+		if (map *current_map = get_map()) {
+			current_map->get_strand().dispatch(work);
+			return;
+		}
+	}
+	work();
+}
+
 auto player::handle(packet_reader &reader) -> result {
 	try {
 		packet_header header = reader.get<packet_header>();
@@ -210,6 +226,10 @@ auto player::handle(packet_reader &reader) -> result {
 
 auto player::on_disconnect() -> void {
 	m_disconnecting = true;
+	if (!m_is_loaded) {
+		// Never made it in, so there's nothing to save or clean up
+		return;
+	}
 
 	map *cur_map = maps::get_map(m_map);
 	if (get_map_chair() != 0) {
@@ -244,14 +264,33 @@ auto player::on_disconnect() -> void {
 		m_map_pos = closest->id;
 	}
 
+	game_player_id player_id = get_id();
+	auto notify_world = [player_id] {
+		auto &channel = channel_server::get_instance();
+		if (channel.is_connected()) {
+			// Do not connect to worldserver if the worldserver has disconnected
+			channel.send_world(packets::interserver::player::disconnect(player_id));
+		}
+	};
+
 	if (m_save_on_dc) {
-		save_all(true);
-		set_online(false);
+		// The world only hears about the disconnect once the save is committed
+		// Until then it keeps treating the character as online, so neither a relog on another channel nor the login server reads rows that haven't landed
+		save_and_go_offline([player_id, notify_world](bool committed) {
+			if (!committed) {
+				// Letting the character back in would load the rows from before this session
+				channel_server::get_instance().log(vana::log::type::error, [&](out_stream &log) {
+					log << "Player " << player_id << " couldn't be saved on disconnect and stays online until the channel restarts";
+				});
+				return;
+			}
+			// on_saved runs on a save thread, the world connection belongs to the io thread
+			channel_server::get_instance().get_io_service().post(notify_world);
+		}, offline_save_attempts);
 	}
-
-	if (channel_server::get_instance().is_connected()) {
-		// Do not connect to worldserver if the worldserver has disconnected
-		channel_server::get_instance().send_world(packets::interserver::player::disconnect(get_id()));
+	else {
+		// Channel changes only send the client off once their save is committed, so it's already in
+		notify_world();
 	}
 
 	channel_server::get_instance().get_player_data_provider().remove_player(shared_from_this());
@@ -261,11 +300,33 @@ auto player::on_disconnect() -> void {
 	channel_server::get_instance().finalize_player(shared_from_this());
 }
 
+struct player::pending_load {
+	owned_ptr<soci::row> row;
+	owned_ptr<player_buddy_list> buddy_list;
+	owned_ptr<player_inventory> inventory;
+	owned_ptr<player_monster_book> monster_book;
+	owned_ptr<player_quests> quests;
+	owned_ptr<player_skills> skills;
+	owned_ptr<player_storage> storage;
+	owned_ptr<player_variables> variables;
+	key_maps keys;
+	skill_macros macros;
+	bool has_transfer_packet = false;
+	vector<unsigned char> transfer_packet;
+	std::atomic<size_t> remaining{0};
+	std::atomic<bool> failed{false};
+};
+
 auto player::player_connect(packet_reader &reader) -> void {
 	game_player_id id = reader.get<game_player_id>();
 	reader.get<int8_t>(); // GM level 4?
 	reader.skip<int8_t>(); // Constant '0'
 
+	if (m_is_loading) {
+		// Sent again before the character finished loading
+		return;
+	}
+
 	bool has_transfer_packet = false;
 	auto &channel = channel_server::get_instance();
 	auto &provider = channel.get_player_data_provider();
@@ -276,37 +337,86 @@ auto player::player_connect(packet_reader &reader) -> void {
 	}
 
 	m_id = id;
+	m_is_loading = true;
+	// The packets after this one would be dropped until the character is loaded
+	hold_replay();
+
+	auto load = make_ref_ptr<pending_load>();
+	if (has_transfer_packet) {
+		// The provider lets go of the packet once the player is established
+		packet_reader transfer = provider.get_packet(id);
+		load->has_transfer_packet = true;
+		load->transfer_packet.assign(transfer.get_buffer(), transfer.get_buffer() + transfer.get_buffer_length());
+	}
+
+	provider.player_established(id);
+
+	// Loading the inventory adds pets to this
+	m_pets = make_owned_ptr<player_pets>(shared_from_this());
+
+	// The queries run on the loader threads and the rest of the connect picks up on this session's strand once they're done
+	ref_ptr<player> self = shared_from_this();
+	ref_ptr<session> owner = m_session;
+	channel.get_player_loader().run([self, owner, load] {
+		self->load_character(owner, load);
+	});
+}
+
+auto player::load_character(ref_ptr<session> owner, ref_ptr<pending_load> load) -> void {
+	auto &channel = channel_server::get_instance();
+	ref_ptr<player> self = shared_from_this();
+	auto finish = [self, owner, load] {
+		owner->post([self, load] {
+			self->character_loaded(load);
+		});
+	};
+
+	// A quick relog can get here before the save from the last session is committed
+	channel.get_player_saver().wait_for(m_id);
+
 	auto &db = vana::io::database::get_char_db();
 	auto &sql = db.get_session();
-	soci::row row;
-	sql.once
-		<< "SELECT c.*, u.gm_level, u.admin "
-		<< "FROM " << db.make_table(vana::table::characters) << " c "
-		<< "INNER JOIN " << db.make_table(vana::table::accounts) << " u ON c.account_id = u.account_id "
-		<< "WHERE c.character_id = :char",
-		soci::use(id, "char"),
-		soci::into(row);
+	load->row = make_owned_ptr<soci::row>();
+	try {
+		sql.once
+			<< "SELECT c.*, u.gm_level, u.admin "
+			<< "FROM " << db.make_table(vana::table::characters) << " c "
+			<< "INNER JOIN " << db.make_table(vana::table::accounts) << " u ON c.account_id = u.account_id "
+			<< "WHERE c.character_id = :char",
+			soci::use(m_id, "char"),
+			soci::into(*load->row);
+	}
+	catch (...) {
+		load->failed = true;
+		finish();
+		throw;
+	}
 
 	if (!sql.got_data()) {
 		// Hacking
-		disconnect();
+		load->failed = true;
+		finish();
 		return;
 	}
 
-	m_name = row.get<string>("name");
+	// Everything below loads by these
+	const soci::row &row = *load->row;
 	m_account_id = row.get<game_account_id>("account_id");
+	m_world_id = row.get<game_world_id>("world_id");
+
+	// Inventory and skill loading reach back into the character's stats, so they're set up before any of the tasks run
+	// Nothing else sees the player until character_loaded, so filling these in from a loader thread is fine
+	m_name = row.get<string>("name");
 	m_map = row.get<game_map_id>("map");
 	m_gm_level = row.get<int32_t>("gm_level");
 	m_admin = row.get<bool>("admin");
 	m_face = row.get<game_face_id>("face");
 	m_hair = row.get<game_hair_id>("hair");
-	m_world_id = row.get<game_world_id>("world_id");
 	m_gender = row.get<game_gender_id>("gender");
 	m_skin = row.get<game_skin_id>("skin");
 	m_map_pos = row.get<game_portal_id>("pos");
 	m_buddylist_size = row.get<uint8_t>("buddylist_size");
 
-	// Stats
 	m_stats = make_owned_ptr<player_stats>(
 		shared_from_this(),
 		row.get<game_player_level>("level"),
@@ -326,29 +436,96 @@ auto player::player_connect(packet_reader &reader) -> void {
 		row.get<game_experience>("exp")
 	);
 
-	// Inventory
-	m_mounts = make_owned_ptr<player_mounts>(shared_from_this());
-	m_pets = make_owned_ptr<player_pets>(shared_from_this());
 	array<game_inventory_slot_count, constant::inventory::count> max_slots;
 	max_slots[0] = row.get<game_inventory_slot_count>("equip_slots");
 	max_slots[1] = row.get<game_inventory_slot_count>("use_slots");
 	max_slots[2] = row.get<game_inventory_slot_count>("setup_slots");
 	max_slots[3] = row.get<game_inventory_slot_count>("etc_slots");
 	max_slots[4] = row.get<game_inventory_slot_count>("cash_slots");
-	m_inventory = make_owned_ptr<player_inventory>(shared_from_this(), max_slots, row.get<game_mesos>("mesos"));
-	m_storage = make_owned_ptr<player_storage>(shared_from_this());
+	game_mesos mesos = row.get<game_mesos>("mesos");
+
+	// Likely to be needed by the time the rest is in
+	channel.get_map_preloader().prefetch(row.get<game_map_id>("map"));
+
+	// None of these depend on each other, so each is its own task
+	// The exception is the inventory, equipping a saddle sets the current mount while it loads
+	vector<function<void()>> tasks = {
+		[self, load, max_slots, mesos] {
+			self->m_mounts = make_owned_ptr<player_mounts>(self);
+			load->inventory = make_owned_ptr<player_inventory>(self, max_slots, mesos);
+		},
+		[self, load] { load->storage = make_owned_ptr<player_storage>(self); },
+		[self, load] { load->skills = make_owned_ptr<player_skills>(self); },
+		[self, load] { load->variables = make_owned_ptr<player_variables>(self); },
+		[self, load] { load->buddy_list = make_owned_ptr<player_buddy_list>(self); },
+		[self, load] { load->quests = make_owned_ptr<player_quests>(self); },
+		[self, load] { load->monster_book = make_owned_ptr<player_monster_book>(self); },
+		[self, load] { load->keys.load(self->get_id()); },
+		[self, load] { load->macros.load(self->get_id()); },
+	};
+
+	load->remaining = tasks.size();
+	auto &loader = channel.get_player_loader();
+	for (const auto &task : tasks) {
+		loader.run([load, task, finish] {
+			try {
+				task();
+			}
+			catch (...) {
+				load->failed = true;
+				if (--load->remaining == 0) {
+					finish();
+				}
+				throw;
+			}
+
+			if (--load->remaining == 0) {
+				finish();
+			}
+		});
+	}
+}
+
+auto player::character_loaded(ref_ptr<pending_load> load) -> void {
+	if (m_disconnected) {
+		// Gone while loading, whatever was loaded is simply dropped
+		return;
+	}
+	if (load->failed) {
+		disconnect();
+		return;
+	}
+
+	const soci::row &row = *load->row;
+	auto &channel = channel_server::get_instance();
+	auto &provider = channel.get_player_data_provider();
+
+	// Inventory
+	m_inventory = std::move(load->inventory);
+	m_storage = std::move(load->storage);
 
 	// Skills
-	m_skills = make_owned_ptr<player_skills>(shared_from_this());
+	m_skills = std::move(load->skills);
 
 	// Buffs/summons
 	m_active_buffs = make_owned_ptr<player_active_buffs>(shared_from_this());
 	m_summons = make_owned_ptr<player_summons>(shared_from_this());
 
-	bool first_connect = !has_transfer_packet;
+	// The rest
+	m_variables = std::move(load->variables);
+	m_buddy_list = std::move(load->buddy_list);
+	m_quests = std::move(load->quests);
+	m_monster_book = std::move(load->monster_book);
+	m_is_loaded = true;
+
+	opt_int32_t book_cover = row.get<opt_int32_t>("book_cover");
+	get_monster_book()->set_cover(book_cover.get(0));
+
+	bool first_connect = !load->has_transfer_packet;
 	auto &config = channel.get_config();
-	if (has_transfer_packet) {
-		parse_transfer_packet(provider.get_packet(m_id));
+	if (load->has_transfer_packet) {
+		packet_reader transfer{load->transfer_packet.data(), load->transfer_packet.size()};
+		parse_transfer_packet(transfer);
 	}
 	else {
 		// No packet, that means that they're connecting for the first time
@@ -356,24 +533,6 @@ auto player::player_connect(packet_reader &reader) -> void {
 		m_gm_chat = is_gm() && config.default_gm_chat_mode;
 	}
 
-	provider.player_established(id);
-
-	// The rest
-	m_variables = make_owned_ptr<player_variables>(shared_from_this());
-	m_buddy_list = make_owned_ptr<player_buddy_list>(shared_from_this());
-	m_quests = make_owned_ptr<player_quests>(shared_from_this());
-	m_monster_book = make_owned_ptr<player_monster_book>(shared_from_this());
-
-	opt_int32_t book_cover = row.get<opt_int32_t>("book_cover");
-	get_monster_book()->set_cover(book_cover.get(0));
-
-	// Key Maps and Macros
-	key_maps key_maps;
-	key_maps.load(id);
-
-	skill_macros skill_macros;
-	skill_macros.load(id);
-
 	// Adjust down HP or MP if necessary
 	get_stats()->check_hp_mp();
 
@@ -409,12 +568,12 @@ auto player::player_connect(packet_reader &reader) -> void {
 		}
 	}
 
-	send(packets::player::show_keys(&key_maps));
+	send(packets::player::show_keys(&load->keys));
 
 	send(packets::buddy::update(shared_from_this(), packets::buddy::action_types::add));
 	get_buddy_list()->check_for_pending_buddy();
 
-	send(packets::player::show_skill_macros(&skill_macros));
+	send(packets::player::show_skill_macros(&load->macros));
 	for (auto &packet : packets::npc::npc_set_script(channel_server::get_instance().get_config().npc_forced_script)) {
 		send(packet);
 	}
@@ -428,6 +587,14 @@ auto player::player_connect(packet_reader &reader) -> void {
 
 	set_online(true);
 	m_is_connect = true;
+	resume_replay();
+
+	view_ptr<player> self = shared_from_this();
+	set_timer_dispatcher([self](function<void()> work) {
+		if (auto player = self.lock()) {
+			player->dispatch(work);
+		}
+	});
 
 	player_data data;
 	const player_data * const existing_data = provider.get_player_data(m_id);
@@ -646,7 +813,7 @@ auto player::set_skin(game_skin_id id) -> void {
 	send(packets::player::update_stat(updates, constant::stat::skin));
 }
 
-auto player::save_stats() -> void {
+auto player::snapshot_stats() -> function<void()> {
 	player_stats *s = get_stats();
 	player_inventory *i = get_inventory();
 	// Need local bindings
@@ -679,88 +846,151 @@ auto player::save_stats() -> void {
 	if (raw_cover != 0) {
 		cover = raw_cover;
 	}
+	// Character
+	game_player_id char_id = m_id;
+	game_map_id map_id = m_map;
+	game_portal_id map_pos = m_map_pos;
+	auto gender = m_gender;
+	auto skin = m_skin;
+	auto face = m_face;
+	auto hair = m_hair;
+	auto buddylist = m_buddylist_size;
+
+	return [=]() {
+		auto &db = vana::io::database::get_char_db();
+		auto &sql = db.get_session();
+		sql.once
+			<< "UPDATE " << db.make_table(vana::table::characters) << " "
+			<< "SET "
+			<< "	level = :level, "
+			<< "	job = :job, "
+			<< "	str = :str, "
+			<< "	dex = :dex, "
+			<< "	`int` = :int, "
+			<< "	luk = :luk, "
+			<< "	chp = :hp, "
+			<< "	mhp = :maxhp, "
+			<< "	cmp = :mp, "
+			<< "	mmp = :maxmp, "
+			<< "	hpmp_ap = :hpmpap, "
+			<< "	ap = :ap, "
+			<< "	sp = :sp, "
+			<< "	exp = :exp, "
+			<< "	fame = :fame, "
+			<< "	map = :map, "
+			<< "	pos = :pos, "
+			<< "	gender = :gender, "
+			<< "	skin = :skin, "
+			<< "	face = :face, "
+			<< "	hair = :hair, "
+			<< "	mesos = :money, "
+			<< "	equip_slots = :equip, "
+			<< "	use_slots = :use, "
+			<< "	setup_slots = :setup, "
+			<< "	etc_slots = :etc, "
+			<< "	cash_slots = :cash, "
+			<< "	buddylist_size = :buddylist, "
+			<< "	book_cover = :cover "
+			<< "WHERE character_id = :char",
+			soci::use(char_id, "char"),
+			soci::use(level, "level"),
+			soci::use(job, "job"),
+			soci::use(str, "str"),
+			soci::use(dex, "dex"),
+			soci::use(intl, "int"),
+			soci::use(luk, "luk"),
+			soci::use(hp, "hp"),
+			soci::use(max_hp, "maxhp"),
+			soci::use(mp, "mp"),
+			soci::use(max_mp, "maxmp"),
+			soci::use(hp_mp_ap, "hpmpap"),
+			soci::use(ap, "ap"),
+			soci::use(sp, "sp"),
+			soci::use(exp, "exp"),
+			soci::use(fame, "fame"),
+			soci::use(map_id, "map"),
+			soci::use(map_pos, "pos"),
+			soci::use(gender, "gender"),
+			soci::use(skin, "skin"),
+			soci::use(face, "face"),
+			soci::use(hair, "hair"),
+			soci::use(money, "money"),
+			soci::use(equip, "equip"),
+			soci::use(use, "use"),
+			soci::use(setup, "setup"),
+			soci::use(etc, "etc"),
+			soci::use(cash, "cash"),
+			soci::use(buddylist, "buddylist"),
+			soci::use(cover, "cover");
+	};
+}
 
-	auto &db = vana::io::database::get_char_db();
-	auto &sql = db.get_session();
-	sql.once
-		<< "UPDATE " << db.make_table(vana::table::characters) << " "
-		<< "SET "
-		<< "	level = :level, "
-		<< "	job = :job, "
-		<< "	str = :str, "
-		<< "	dex = :dex, "
-		<< "	`int` = :int, "
-		<< "	luk = :luk, "
-		<< "	chp = :hp, "
-		<< "	mhp = :maxhp, "
-		<< "	cmp = :mp, "
-		<< "	mmp = :maxmp, "
-		<< "	hpmp_ap = :hpmpap, "
-		<< "	ap = :ap, "
-		<< "	sp = :sp, "
-		<< "	exp = :exp, "
-		<< "	fame = :fame, "
-		<< "	map = :map, "
-		<< "	pos = :pos, "
-		<< "	gender = :gender, "
-		<< "	skin = :skin, "
-		<< "	face = :face, "
-		<< "	hair = :hair, "
-		<< "	mesos = :money, "
-		<< "	equip_slots = :equip, "
-		<< "	use_slots = :use, "
-		<< "	setup_slots = :setup, "
-		<< "	etc_slots = :etc, "
-		<< "	cash_slots = :cash, "
-		<< "	buddylist_size = :buddylist, "
-		<< "	book_cover = :cover "
-		<< "WHERE character_id = :char",
-		soci::use(m_id, "char"),
-		soci::use(level, "level"),
-		soci::use(job, "job"),
-		soci::use(str, "str"),
-		soci::use(dex, "dex"),
-		soci::use(intl, "int"),
-		soci::use(luk, "luk"),
-		soci::use(hp, "hp"),
-		soci::use(max_hp, "maxhp"),
-		soci::use(mp, "mp"),
-		soci::use(max_mp, "maxmp"),
-		soci::use(hp_mp_ap, "hpmpap"),
-		soci::use(ap, "ap"),
-		soci::use(sp, "sp"),
-		soci::use(exp, "exp"),
-		soci::use(fame, "fame"),
-		soci::use(m_map, "map"),
-		soci::use(m_map_pos, "pos"),
-		soci::use(m_gender, "gender"),
-		soci::use(m_skin, "skin"),
-		soci::use(m_face, "face"),
-		soci::use(m_hair, "hair"),
-		soci::use(money, "money"),
-		soci::use(equip, "equip"),
-		soci::use(use, "use"),
-		soci::use(setup, "setup"),
-		soci::use(etc, "etc"),
-		soci::use(cash, "cash"),
-		soci::use(m_buddylist_size, "buddylist"),
-		soci::use(cover, "cover");
-}
-
-auto player::save_all(bool save_cooldowns) -> void {
-	save_stats();
-	get_inventory()->save();
-	get_storage()->save();
-	get_monster_book()->save();
-	get_mounts()->save();
-	get_pets()->save();
-	get_quests()->save();
-	get_skills()->save(save_cooldowns);
-	get_variables()->save();
+auto player::snapshot_all(bool save_cooldowns) -> function<void()> {
+	// Diffing against the loaded state is only safe once that state is known to be what the database holds
+	// A load can't prove that (e.g. it may have raced a save from another channel), so saves rewrite every row until one of those commits
+	auto full_save_committed = m_full_save_committed;
+	bool full = !full_save_committed->load();
+
+	vector<function<void()>> saves = {
+		snapshot_stats(),
+		get_inventory()->snapshot(full),
+		get_storage()->snapshot(full),
+		get_monster_book()->snapshot(),
+		get_mounts()->snapshot(),
+		get_pets()->snapshot(),
+		get_quests()->snapshot(full),
+		get_skills()->snapshot(full, save_cooldowns),
+		get_variables()->snapshot(full),
+	};
+
+	return [saves, full, full_save_committed]() {
+		for (const auto &save : saves) {
+			save();
+		}
+
+		if (full) {
+			player_saver::after_commit([full_save_committed] {
+				full_save_committed->store(true);
+			});
+		}
+	};
+}
+
+auto player::save_all(bool save_cooldowns, function<void(bool)> on_saved) -> void {
+	channel_server::get_instance().get_player_saver().enqueue(m_id, snapshot_all(save_cooldowns), on_saved);
+}
+
+auto player::save_and_go_offline(function<void(bool)> on_saved, uint8_t attempts) -> void {
+	game_player_id player_id = m_id;
+	auto save = snapshot_all(true);
+	enqueue_offline_save(
+		player_id,
+		[player_id, save]() {
+			save();
+			update_online_status(player_id, false, 0);
+		},
+		on_saved,
+		attempts);
+}
+
+auto player::enqueue_offline_save(game_player_id player_id, function<void()> save, function<void(bool)> on_saved, uint8_t attempts) -> void {
+	channel_server::get_instance().get_player_saver().enqueue(player_id, save, [player_id, save, on_saved, attempts](bool committed) {
+		if (!committed && attempts > 1) {
+			// The snapshot is complete on its own, so the same one is committed again
+			enqueue_offline_save(player_id, save, on_saved, attempts - 1);
+			return;
+		}
+		if (on_saved != nullptr) {
+			on_saved(committed);
+		}
+	});
 }
 
 auto player::set_online(bool online) -> void {
-	int32_t online_id = online ? channel_server::get_instance().get_online_id() : 0;
+	update_online_status(m_id, online, online ? channel_server::get_instance().get_online_id() : 0);
+}
+
+auto player::update_online_status(game_player_id player_id, bool online, int32_t online_id) -> void {
 	auto &db = vana::io::database::get_char_db();
 	auto &sql = db.get_session();
 	sql.once
@@ -770,7 +1000,7 @@ auto player::set_online(bool online) -> void {
 		<< "	u.online = :online_id, "
 		<< "	c.online = :online "
 		<< "WHERE c.character_id = :char",
-		soci::use(m_id, "char"),
+		soci::use(player_id, "char"),
 		soci::use(online, "online"),
 		soci::use(online_id, "online_id");
 }
@@ -870,5 +1100,9 @@ auto player::send_map(const split_packet_builder &builder) -> void {
 	get_map()->send(builder, shared_from_this());
 }
 
+auto player::send_nearby(const packet_builder &builder, bool exclude_self) -> void {
+	get_map()->send_nearby(builder, get_pos(), exclude_self ? shared_from_this() : nullptr);
+}
+
 }
 }
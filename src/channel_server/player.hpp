@@ -36,6 +36,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "channel_server/player_storage.hpp"
 #include "channel_server/player_summons.hpp"
 #include "channel_server/player_variables.hpp"
+#include <atomic>
 #include <ctime>
 #include <memory>
 #include <string>
@@ -150,7 +151,11 @@ namespace vana {
 			auto used_portal(game_portal_id portal_id) const -> bool { return m_used_portals.find(portal_id) != std::end(m_used_portals); }
 
 			auto change_channel(game_channel_id channel) -> void;
-			auto save_all(bool save_cooldowns = false) -> void;
+			// Saves are snapshotted here and committed on the channel's save threads, on_saved runs on the save thread and is told whether the save committed
+			auto save_all(bool save_cooldowns = false, function<void(bool)> on_saved = nullptr) -> void;
+			// Also marks the character offline, in the same transaction as the save
+			// A save that fails is tried again until attempts runs out, on_saved only hears about the last try
+			auto save_and_go_offline(function<void(bool)> on_saved = nullptr, uint8_t attempts = 1) -> void;
 			auto set_online(bool online) -> void;
 			auto set_level_date() -> void;
 			auto accept_death(bool wheel) -> void;
@@ -160,19 +165,31 @@ namespace vana {
 			auto send(const split_packet_builder &builder) -> void;
 			auto send_map(const packet_builder &builder, bool exclude_self = false) -> void;
 			auto send_map(const split_packet_builder &builder) -> void;
+			auto send_nearby(const packet_builder &builder, bool exclude_self = false) -> void;
+			auto dispatch(function<void()> work) -> void override;
 		protected:
 			auto handle(packet_reader &reader) -> result override;
 			auto on_disconnect() -> void override;
 		private:
+			struct pending_load;
+
 			auto player_connect(packet_reader &reader) -> void;
+			auto load_character(ref_ptr<session> owner, ref_ptr<pending_load> load) -> void;
+			auto character_loaded(ref_ptr<pending_load> load) -> void;
 			auto change_key(packet_reader &reader) -> void;
 			auto change_skill_macros(packet_reader &reader) -> void;
-			auto save_stats() -> void;
+			auto snapshot_stats() -> function<void()>;
+			auto snapshot_all(bool save_cooldowns) -> function<void()>;
+			static auto update_online_status(game_player_id player_id, bool online, int32_t online_id) -> void;
+			static auto enqueue_offline_save(game_player_id player_id, function<void()> save, function<void(bool)> on_saved, uint8_t attempts) -> void;
 			auto internal_set_map(game_map_id map_id, game_portal_id portal_id, const point &pos, bool from_position) -> void;
 
 			bool m_trade_state = false;
 			bool m_save_on_dc = true;
 			bool m_is_connect = false;
+			// Only touched on the session's strand while the character is loading
+			bool m_is_loading = false;
+			bool m_is_loaded = false;
 			bool m_changing_channel = false;
 			bool m_admin = false;
 			bool m_gm_chat = false;
@@ -219,6 +236,8 @@ namespace vana {
 			owned_ptr<player_variables> m_variables;
 			owned_ptr<vana::util::tausworthe_generator> m_rand_stream;
 			hash_set<game_portal_id> m_used_portals;
+			// Set on a save thread once a save that rewrote every row has committed
+			ref_ptr<std::atomic<bool>> m_full_save_committed = make_ref_ptr<std::atomic<bool>>(false);
 		};
 	}
 }
\ No newline at end of file
@@ -332,6 +332,14 @@ auto player_data_provider::player_established(game_player_id id) -> void {
 	m_connections.erase(id);
 }
 
+auto player_data_provider::expect_player(game_player_id id, const ip &ip) -> void {
+	connecting_player player;
+	player.connect_ip = ip;
+	player.connect_time = vana::util::time::get_now();
+	player.packet_size = 0;
+	m_connections[id] = player;
+}
+
 auto player_data_provider::handle_player_sync(packet_reader &reader) -> void {
 	switch (reader.get<protocol_sync>()) {
 		case sync::player::new_connectable: handle_new_connectable(reader); break;
@@ -392,10 +400,22 @@ auto player_data_provider::handle_change_channel(packet_reader &reader) -> void
 				m_followers.erase(kvp);
 			}
 
-			player->set_online(false); // Set online to false BEFORE CC packet is sent to player
-			player->send(packets::player::change_channel(ip_value, port));
-			player->save_all(true);
+			// The client is only told to change channels once the save (which also sets online to false) is committed
+			// Otherwise the other channel could load the character before it lands
 			player->set_save_on_dc(false);
+			packet_builder change_channel_packet = packets::player::change_channel(ip_value, port);
+			player->save_and_go_offline([player, change_channel_packet](bool committed) {
+				player->dispatch([player, change_channel_packet, committed] {
+					if (committed) {
+						player->send(change_channel_packet);
+						return;
+					}
+
+					// The next channel would load the rows from before the save, so the character stays here and is saved when they leave
+					player->set_save_on_dc(true);
+					player->send(packets::player::send_blocked_message(packets::player::block_messages::cannot_go));
+				});
+			});
 		}
 	}
 }
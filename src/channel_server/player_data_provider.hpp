@@ -81,6 +81,8 @@ namespace vana {
 			auto check_player(game_player_id id, const ip &ip, bool &has_packet) const -> result;
 			auto get_packet(game_player_id id) const -> packet_reader;
 			auto player_established(game_player_id id) -> void;
+			// Lets a player connect without the world server having sent them over, for replays
+			auto expect_player(game_player_id id, const ip &ip) -> void;
 		private:
 			auto parse_channel_connect_packet(packet_reader &reader) -> void;
 
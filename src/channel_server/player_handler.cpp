@@ -291,7 +291,7 @@ auto player_handler::handle_damage(ref_ptr<player> player, packet_reader &reader
 
 auto player_handler::handle_facial_expression(ref_ptr<player> player, packet_reader &reader) -> void {
 	int32_t face = reader.get<int32_t>();
-	player->send_map(packets::players::face_expression(player->get_id(), face));
+	player->send_nearby(packets::players::face_expression(player->get_id(), face));
 }
 
 auto player_handler::handle_get_info(ref_ptr<player> player, packet_reader &reader) -> void {
@@ -324,7 +324,8 @@ auto player_handler::handle_moving(ref_ptr<player> player, packet_reader &reader
 	
 	move_path path(reader);
 	player->reset_from_move_path(path);
-	player->send_map(packets::players::show_moving(player->get_id(), path));
+	player->get_map()->update_player_position(player);
+	player->send_nearby(packets::players::show_moving(player->get_id(), path));
 
 	if (player->get_foothold() == 0 && !player->is_using_gm_hide()) {
 		// Player is floating in the air
@@ -34,6 +34,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "channel_server/player.hpp"
 #include "channel_server/player_packet.hpp"
 #include "channel_server/player_packet_helper.hpp"
+#include "channel_server/player_saver.hpp"
 
 namespace vana {
 namespace channel_server {
@@ -99,67 +100,141 @@ auto player_inventory::load() -> void {
 				m_rock_locations.push_back(map_id);
 			}
 		}
+
+		m_saved = make_ref_ptr<saved_state>();
+		for (game_inventory i = constant::inventory::equip; i <= constant::inventory::count; ++i) {
+			for (const auto &kvp : m_items[i - 1]) {
+				m_saved->items.emplace(item_slot{i, kvp.first}, *kvp.second);
+			}
+		}
+		m_saved->rock_locations = m_rock_locations;
+		m_saved->vip_locations = m_vip_locations;
 	}
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
 
-auto player_inventory::save() -> void {
+auto player_inventory::snapshot(bool full) const -> function<void()> {
 	if (auto player = m_player.lock()) {
-		using namespace soci;
-		auto &db = vana::io::database::get_char_db();
-		auto &sql = db.get_session();
 		game_player_id char_id = player->get_id();
+		game_account_id account_id = player->get_account_id();
+		game_world_id world_id = player->get_world_id();
+		vector<game_map_id> rock_locations = m_rock_locations;
+		vector<game_map_id> vip_locations = m_vip_locations;
+		auto saved = m_saved;
+
+		// The records point into the copies so that the live items can keep changing while the save is queued
+		auto items = make_ref_ptr<ord_map<item_slot, item>>();
+		for (game_inventory i = constant::inventory::equip; i <= constant::inventory::count; ++i) {
+			for (const auto &kvp : m_items[i - 1]) {
+				items->emplace(item_slot{i, kvp.first}, *kvp.second);
+			}
+		}
+
+		return [=]() {
+			using namespace soci;
+			auto &db = vana::io::database::get_char_db();
+			auto &sql = db.get_session();
+			size_t written = 0;
+			size_t deleted = 0;
+
+			// A full save rewrites every row instead of trusting that the database still holds what was loaded
+			ord_map<item_slot, item> none;
+			const auto &baseline = full ? none : saved->items;
+			if (full) {
+				sql.once
+					<< "DELETE FROM " << db.make_table(vana::table::items) << " "
+					<< "WHERE location = :inv AND character_id = :char",
+					use(char_id, "char"),
+					use(item::inventory, "inv");
+			}
+
+			if (full || rock_locations != saved->rock_locations || vip_locations != saved->vip_locations) {
+				sql.once << "DELETE FROM " << db.make_table(vana::table::teleport_rock_locations) << " WHERE character_id = :char",
+					use(char_id, "char");
+				deleted += saved->rock_locations.size() + saved->vip_locations.size();
+
+				if (rock_locations.size() > 0 || vip_locations.size() > 0) {
+					game_map_id map_id = 0;
+					size_t rock_index = 0;
+
+					statement st = (sql.prepare
+						<< "INSERT INTO " << db.make_table(vana::table::teleport_rock_locations) << " "
+						<< "VALUES (:char, :i, :map)",
+						use(char_id, "char"),
+						use(map_id, "map"),
+						use(rock_index, "i"));
+
+					for (rock_index = 0; rock_index < rock_locations.size(); ++rock_index) {
+						map_id = rock_locations[rock_index];
+						st.execute(true);
+					}
 
-		sql.once << "DELETE FROM " << db.make_table(vana::table::teleport_rock_locations) << " WHERE character_id = :char",
-			use(char_id, "char");
-
-		if (m_rock_locations.size() > 0 || m_vip_locations.size() > 0) {
-			game_map_id map_id = 0;
-			size_t rock_index = 0;
-
-			statement st = (sql.prepare
-				<< "INSERT INTO " << db.make_table(vana::table::teleport_rock_locations) << " "
-				<< "VALUES (:char, :i, :map)",
-				use(char_id, "char"),
-				use(map_id, "map"),
-				use(rock_index, "i"));
-
-			for (rock_index = 0; rock_index < m_rock_locations.size(); ++rock_index) {
-				map_id = m_rock_locations[rock_index];
-				st.execute(true);
+					rock_index = constant::inventory::teleport_rock_max;
+					for (size_t i = 0; i < vip_locations.size(); ++i) {
+						map_id = vip_locations[i];
+						st.execute(true);
+						++rock_index;
+					}
+					written += rock_locations.size() + vip_locations.size();
+				}
 			}
 
-			rock_index = constant::inventory::teleport_rock_max;
-			for (size_t i = 0; i < m_vip_locations.size(); ++i) {
-				map_id = m_vip_locations[i];
-				st.execute(true);
-				++rock_index;
+			vector<item_slot> changed;
+			vector<item_slot> removed;
+			player_saver::diff(baseline, *items, [](const item &a, const item &b) { return a.has_same_data(b); }, changed, removed);
+
+			// Slots whose item changed are cleared along with the emptied ones and inserted again
+			vector<item_slot> stale = removed;
+			for (const auto &slot : changed) {
+				if (baseline.find(slot) != std::end(baseline)) {
+					stale.push_back(slot);
+				}
 			}
-		}
 
-		sql.once
-			<< "DELETE FROM " << db.make_table(vana::table::items) << " "
-			<< "WHERE location = :inv AND character_id = :char",
-			use(char_id, "char"),
-			use(item::inventory, "inv");
+			if (stale.size() > 0) {
+				uint8_t inventory = 0;
+				game_inventory_slot slot = 0;
+				statement st = (sql.prepare
+					<< "DELETE FROM " << db.make_table(vana::table::items) << " "
+					<< "WHERE location = :location AND character_id = :char AND inv = :inv AND slot = :slot",
+					use(item::inventory, "location"),
+					use(char_id, "char"),
+					use(inventory, "inv"),
+					use(slot, "slot"));
+
+				for (const auto &stale_slot : stale) {
+					inventory = static_cast<uint8_t>(stale_slot.first);
+					slot = stale_slot.second;
+					st.execute(true);
+				}
+				deleted += stale.size();
+			}
+
+			if (changed.size() > 0) {
+				vector<item_db_record> v;
+				for (const auto &slot : changed) {
+					item_db_record rec{
+						slot.second,
+						char_id,
+						account_id,
+						world_id,
+						item::inventory,
+						&items->find(slot)->second
+					};
+					v.push_back(rec);
+				}
 
-		vector<item_db_record> v;
-		for (game_inventory i = constant::inventory::equip; i <= constant::inventory::count; ++i) {
-			const auto &items_inv = m_items[i - 1];
-			for (const auto &kvp : items_inv) {
-				item_db_record rec{
-					kvp.first,
-					char_id,
-					player->get_account_id(),
-					player->get_world_id(),
-					item::inventory,
-					kvp.second
-				};
-				v.push_back(rec);
+				item::database_insert(db, v);
+				written += changed.size();
 			}
-		}
 
-		item::database_insert(db, v);
+			player_saver::count_rows(written, deleted);
+			player_saver::after_commit([saved, items, rock_locations, vip_locations] {
+				saved->items = *items;
+				saved->rock_locations = rock_locations;
+				saved->vip_locations = vip_locations;
+			});
+		};
 	}
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
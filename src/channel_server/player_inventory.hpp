@@ -41,7 +41,7 @@ namespace vana {
 			~player_inventory();
 
 			auto load() -> void;
-			auto save() -> void;
+			auto snapshot(bool full) const -> function<void()>;
 
 			auto connect_packet(packet_builder &builder) -> void;
 			auto add_equipped_packet(packet_builder &builder) -> void;
@@ -93,6 +93,14 @@ namespace vana {
 			auto add_wish_list_item(game_item_id item_id) -> void;
 			auto check_expired_items() -> void;
 		private:
+			using item_slot = pair<game_inventory, game_inventory_slot>;
+			// What the database holds, only touched by this player's saves once loaded
+			struct saved_state {
+				ord_map<item_slot, item> items;
+				vector<game_map_id> rock_locations;
+				vector<game_map_id> vip_locations;
+			};
+
 			auto add_equipped(game_inventory_slot slot, game_item_id item_id) -> void;
 			auto modify_mesos_internal(vana::util::meso_modify_result query, bool send_packet) -> vana::util::meso_modify_result;
 
@@ -108,6 +116,7 @@ namespace vana {
 			vector<game_map_id> m_rock_locations;
 			vector<game_item_id> m_wishlist;
 			hash_map<game_item_id, game_slot_qty> m_item_amounts;
+			ref_ptr<saved_state> m_saved;
 		};
 	}
 }
\ No newline at end of file
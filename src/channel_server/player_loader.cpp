@@ -0,0 +1,64 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "player_loader.hpp"
+#include "common/util/thread_pool.hpp"
+#include "channel_server/channel_server.hpp"
+#include <exception>
+
+namespace vana {
+namespace channel_server {
+
+auto player_loader::start(uint16_t thread_count) -> void {
+	for (uint16_t i = 0; i < thread_count; i++) {
+		m_threads.push_back(vana::util::thread_pool::lease(
+			[this](owned_lock<recursive_mutex> &lock) {
+				if (m_tasks.empty()) {
+					m_tasks_condition.wait(lock);
+					return;
+				}
+
+				function<void()> task = m_tasks.front();
+				m_tasks.pop_front();
+
+				lock.unlock();
+				try {
+					task();
+				}
+				catch (std::exception &e) {
+					channel_server::get_instance().log(vana::log::type::error, [&](out_stream &log) {
+						log << "Failed to load a player: " << e.what();
+					});
+				}
+				lock.lock();
+			},
+			[this] {
+				owned_lock<recursive_mutex> l{m_mutex};
+				m_tasks_condition.notify_all();
+			},
+			m_mutex));
+	}
+}
+
+auto player_loader::run(function<void()> task) -> void {
+	owned_lock<recursive_mutex> l{m_mutex};
+	m_tasks.push_back(task);
+	m_tasks_condition.notify_one();
+}
+
+}
+}
\ No newline at end of file
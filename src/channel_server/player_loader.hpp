@@ -0,0 +1,45 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/types.hpp"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vana {
+	namespace channel_server {
+		// Runs the queries that load characters on dedicated threads, each with its own database connection
+		// A character load is split into independent tasks (inventory, skills, quests, etc.) so that the queries for a single character run side by side
+		class player_loader {
+			NONCOPYABLE(player_loader);
+		public:
+			player_loader() = default;
+
+			auto start(uint16_t thread_count) -> void;
+			auto run(function<void()> task) -> void;
+		private:
+			queue<function<void()>> m_tasks;
+			std::condition_variable_any m_tasks_condition;
+			recursive_mutex m_mutex;
+			vector<ref_ptr<std::thread>> m_threads;
+		};
+	}
+}
\ No newline at end of file
@@ -31,8 +31,16 @@ auto player_mod_functions::disconnect(ref_ptr<player> player, const game_chat &a
 }
 
 auto player_mod_functions::save(ref_ptr<player> player, const game_chat &args) -> chat_result {
-	player->save_all();
-	chat_handler_functions::show_info(player, "Your progress has been saved");
+	player->save_all(false, [player](bool committed) {
+		player->dispatch([player, committed] {
+			if (committed) {
+				chat_handler_functions::show_info(player, "Your progress has been saved");
+			}
+			else {
+				chat_handler_functions::show_error(player, "Your progress couldn't be saved");
+			}
+		});
+	});
 	return chat_result::handled_display;
 }
 
@@ -54,33 +54,36 @@ auto player_monster_book::load() -> void {
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
 
-auto player_monster_book::save() -> void {
-	auto &db = vana::io::database::get_char_db();
-	auto &sql = db.get_session();
+auto player_monster_book::snapshot() const -> function<void()> {
 	if (auto player = m_player.lock()) {
 		game_player_id char_id = player->get_id();
-
-		sql.once << "DELETE FROM " << db.make_table(vana::table::monster_book) << " WHERE character_id = :char",
-			soci::use(char_id, "char");
-
-		if (m_cards.size() > 0) {
-			game_item_id card_id = 0;
-			uint8_t level = 0;
-
-			soci::statement st = (sql.prepare
-				<< "INSERT INTO " << db.make_table(vana::table::monster_book) << " "
-				<< "VALUES (:char, :card, :level) ",
-				soci::use(char_id, "char"),
-				soci::use(card_id, "card"),
-				soci::use(level, "level"));
-
-			for (const auto &kvp : m_cards) {
-				const monster_card &c = kvp.second;
-				card_id = c.id;
-				level = c.level;
-				st.execute(true);
+		hash_map<game_item_id, monster_card> cards = m_cards;
+
+		return [=]() {
+			auto &db = vana::io::database::get_char_db();
+			auto &sql = db.get_session();
+			sql.once << "DELETE FROM " << db.make_table(vana::table::monster_book) << " WHERE character_id = :char",
+				soci::use(char_id, "char");
+
+			if (cards.size() > 0) {
+				game_item_id card_id = 0;
+				uint8_t level = 0;
+
+				soci::statement st = (sql.prepare
+					<< "INSERT INTO " << db.make_table(vana::table::monster_book) << " "
+					<< "VALUES (:char, :card, :level) ",
+					soci::use(char_id, "char"),
+					soci::use(card_id, "card"),
+					soci::use(level, "level"));
+
+				for (const auto &kvp : cards) {
+					const monster_card &c = kvp.second;
+					card_id = c.id;
+					level = c.level;
+					st.execute(true);
+				}
 			}
-		}
+		};
 	}
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
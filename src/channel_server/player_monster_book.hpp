@@ -42,7 +42,7 @@ namespace vana {
 			player_monster_book(ref_ptr<player> player);
 
 			auto load() -> void;
-			auto save() -> void;
+			auto snapshot() const -> function<void()>;
 			auto connect_packet(packet_builder &builder) -> void;
 			auto info_packet(packet_builder &builder) -> void;
 
@@ -28,38 +28,42 @@ player_mounts::player_mounts(ref_ptr<player> player) :
 	load();
 }
 
-auto player_mounts::save() -> void {
-	auto &db = vana::io::database::get_char_db();
-	auto &sql = db.get_session();
+auto player_mounts::snapshot() const -> function<void()> {
 	if (auto player = m_player.lock()) {
 		game_player_id char_id = player->get_id();
-		game_item_id item_id = 0;
-		int16_t exp = 0;
-		uint8_t tiredness = 0;
-		uint8_t level = 0;
-
-		sql.once << "DELETE FROM " << db.make_table(vana::table::mounts) << " WHERE character_id = :char",
-			soci::use(char_id, "char");
-
-		if (m_mounts.size() > 0) {
-			soci::statement st = (sql.prepare
-				<< "INSERT INTO " << db.make_table(vana::table::mounts) << " "
-				<< "VALUES (:char, :item, :exp, :level, :tiredness) ",
-				soci::use(char_id, "char"),
-				soci::use(item_id, "item"),
-				soci::use(exp, "exp"),
-				soci::use(level, "level"),
-				soci::use(tiredness, "tiredness"));
-
-			for (const auto &kvp : m_mounts) {
-				const mount_data &c = kvp.second;
-				item_id = kvp.first;
-				exp = c.exp;
-				level = c.level;
-				tiredness = c.tiredness;
-				st.execute(true);
+		hash_map<game_item_id, mount_data> mounts = m_mounts;
+
+		return [=]() {
+			auto &db = vana::io::database::get_char_db();
+			auto &sql = db.get_session();
+			game_item_id item_id = 0;
+			int16_t exp = 0;
+			uint8_t tiredness = 0;
+			uint8_t level = 0;
+
+			sql.once << "DELETE FROM " << db.make_table(vana::table::mounts) << " WHERE character_id = :char",
+				soci::use(char_id, "char");
+
+			if (mounts.size() > 0) {
+				soci::statement st = (sql.prepare
+					<< "INSERT INTO " << db.make_table(vana::table::mounts) << " "
+					<< "VALUES (:char, :item, :exp, :level, :tiredness) ",
+					soci::use(char_id, "char"),
+					soci::use(item_id, "item"),
+					soci::use(exp, "exp"),
+					soci::use(level, "level"),
+					soci::use(tiredness, "tiredness"));
+
+				for (const auto &kvp : mounts) {
+					const mount_data &c = kvp.second;
+					item_id = kvp.first;
+					exp = c.exp;
+					level = c.level;
+					tiredness = c.tiredness;
+					st.execute(true);
+				}
 			}
-		}
+		};
 	}
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
@@ -38,7 +38,7 @@ namespace vana {
 		public:
 			player_mounts(ref_ptr<player> player);
 
-			auto save() -> void;
+			auto snapshot() const -> function<void()>;
 			auto load() -> void;
 
 			auto mount_info_packet(packet_builder &builder) -> void;
@@ -48,44 +48,67 @@ auto player_pets::get_summoned(int8_t index) -> pet * {
 	return m_summoned[index] > 0 ? m_pets[m_summoned[index]] : nullptr;
 }
 
-auto player_pets::save() -> void {
-	if (m_pets.size() > 0) {
-		auto &db = vana::io::database::get_char_db();
-		auto &sql = db.get_session();
-		opt_int8_t index = 0;
-		string name = "";
-		int8_t level = 0;
-		int16_t closeness = 0;
-		int8_t fullness = 0;
-		game_pet_id pet_id = 0;
-
-		soci::statement st = (sql.prepare
-			<< "UPDATE " << db.make_table(vana::table::pets) << " "
-			<< "SET "
-			<< "	`index` = :index, "
-			<< "	name = :name, "
-			<< "	level = :level, "
-			<< "	closeness = :closeness, "
-			<< "	fullness = :fullness "
-			<< "WHERE pet_id = :pet",
-			soci::use(pet_id, "pet"),
-			soci::use(index, "index"),
-			soci::use(name, "name"),
-			soci::use(level, "level"),
-			soci::use(closeness, "closeness"),
-			soci::use(fullness, "fullness"));
-
-		for (const auto &kvp : m_pets) {
-			pet *p = kvp.second;
-			index = p->get_index();
-			name = p->get_name();
-			level = p->get_level();
-			closeness = p->get_closeness();
-			fullness = p->get_fullness();
-			pet_id = p->get_id();
-			st.execute(true);
-		}
+auto player_pets::snapshot() const -> function<void()> {
+	struct pet_record {
+		opt_int8_t index;
+		string name;
+		int8_t level;
+		int16_t closeness;
+		int8_t fullness;
+		game_pet_id pet_id;
+	};
+
+	vector<pet_record> records;
+	for (const auto &kvp : m_pets) {
+		pet *p = kvp.second;
+		pet_record record;
+		record.index = p->get_index();
+		record.name = p->get_name();
+		record.level = p->get_level();
+		record.closeness = p->get_closeness();
+		record.fullness = p->get_fullness();
+		record.pet_id = p->get_id();
+		records.push_back(record);
 	}
+
+	return [records]() {
+		if (records.size() > 0) {
+			auto &db = vana::io::database::get_char_db();
+			auto &sql = db.get_session();
+			opt_int8_t index = 0;
+			string name = "";
+			int8_t level = 0;
+			int16_t closeness = 0;
+			int8_t fullness = 0;
+			game_pet_id pet_id = 0;
+
+			soci::statement st = (sql.prepare
+				<< "UPDATE " << db.make_table(vana::table::pets) << " "
+				<< "SET "
+				<< "	`index` = :index, "
+				<< "	name = :name, "
+				<< "	level = :level, "
+				<< "	closeness = :closeness, "
+				<< "	fullness = :fullness "
+				<< "WHERE pet_id = :pet",
+				soci::use(pet_id, "pet"),
+				soci::use(index, "index"),
+				soci::use(name, "name"),
+				soci::use(level, "level"),
+				soci::use(closeness, "closeness"),
+				soci::use(fullness, "fullness"));
+
+			for (const auto &record : records) {
+				index = record.index;
+				name = record.name;
+				level = record.level;
+				closeness = record.closeness;
+				fullness = record.fullness;
+				pet_id = record.pet_id;
+				st.execute(true);
+			}
+		}
+	};
 }
 
 auto player_pets::pet_info_packet(packet_builder &builder) -> void {
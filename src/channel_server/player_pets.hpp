@@ -33,7 +33,7 @@ namespace vana {
 		public:
 			player_pets(ref_ptr<player> player);
 
-			auto save() -> void;
+			auto snapshot() const -> function<void()>;
 			auto pet_info_packet(packet_builder &builder) -> void;
 			auto connect_packet(packet_builder &builder) -> void;
 
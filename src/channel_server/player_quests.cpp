@@ -25,6 +25,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "channel_server/channel_server.hpp"
 #include "channel_server/inventory.hpp"
 #include "channel_server/player.hpp"
+#include "channel_server/player_saver.hpp"
 #include "channel_server/quests_packet.hpp"
 #include <array>
 
@@ -37,78 +38,151 @@ player_quests::player_quests(ref_ptr<player> player) :
 	load();
 }
 
-auto player_quests::save() -> void {
-	auto &db = vana::io::database::get_char_db();
-	auto &sql = db.get_session();
+auto player_quests::snapshot(bool full) const -> function<void()> {
 	if (auto player = m_player.lock()) {
 		game_player_id char_id = player->get_id();
-		game_quest_id quest_id = 0;
-
-		sql.once << "DELETE FROM " << db.make_table(vana::table::active_quests) << " WHERE character_id = :char",
-			soci::use(char_id, "char");
-		sql.once << "DELETE FROM " << db.make_table(vana::table::completed_quests) << " WHERE character_id = :char",
-			soci::use(char_id, "char");
-
-		if (m_quests.size() > 0) {
-			game_mob_id mob_id = 0;
-			uint16_t killed = 0;
-			int64_t id = 0;
-			opt_string data;
-			// GCC, as usual, bad with operators
-			data = "";
-
-			soci::statement st = (sql.prepare
-				<< "INSERT INTO " << db.make_table(vana::table::active_quests) << " (character_id, quest_id, data) "
-				<< "VALUES (:char, :quest, :data)",
-				soci::use(char_id, "char"),
-				soci::use(quest_id, "quest"),
-				soci::use(data, "data"));
-
-			soci::statement st_mobs = (sql.prepare
-				<< "INSERT INTO " << db.make_table(vana::table::active_quests_mobs) << " (active_quest_id, mob_id, quantity_killed) "
-				<< "VALUES (:id, :mob, :killed)",
-				soci::use(id, "id"),
-				soci::use(mob_id, "mob"),
-				soci::use(killed, "killed"));
-
-			for (const auto &kvp : m_quests) {
-				const string &d = kvp.second.data;
-				quest_id = kvp.first;
-				if (d.empty()) {
-					data.reset();
+		ord_map<game_quest_id, active_quest> quests = m_quests;
+		ord_map<game_quest_id, file_time> completed = m_completed;
+		auto saved_quests = m_saved_quests;
+		auto saved_completed = m_saved_completed;
+
+		return [=]() {
+			auto &db = vana::io::database::get_char_db();
+			auto &sql = db.get_session();
+			game_quest_id quest_id = 0;
+			size_t written = 0;
+			size_t deleted = 0;
+
+			// A full save rewrites every row instead of trusting that the database still holds what was loaded
+			ord_map<game_quest_id, active_quest> no_quests;
+			ord_map<game_quest_id, file_time> no_completed;
+			const auto &baseline_quests = full ? no_quests : *saved_quests;
+			const auto &baseline_completed = full ? no_completed : *saved_completed;
+			if (full) {
+				sql.once << "DELETE FROM " << db.make_table(vana::table::active_quests) << " WHERE character_id = :char",
+					soci::use(char_id, "char");
+				sql.once << "DELETE FROM " << db.make_table(vana::table::completed_quests) << " WHERE character_id = :char",
+					soci::use(char_id, "char");
+			}
+
+			vector<game_quest_id> changed;
+			vector<game_quest_id> removed;
+			player_saver::diff(baseline_quests, quests, [](const active_quest &a, const active_quest &b) {
+				return a.data == b.data && a.kills == b.kills;
+			}, changed, removed);
+
+			// Changed quests are deleted along with their mob rows (through the cascade) and inserted again
+			vector<game_quest_id> stale = removed;
+			for (const auto &changed_id : changed) {
+				if (baseline_quests.find(changed_id) != std::end(baseline_quests)) {
+					stale.push_back(changed_id);
 				}
-				else {
-					data = d;
+			}
+
+			if (stale.size() > 0) {
+				soci::statement st = (sql.prepare
+					<< "DELETE FROM " << db.make_table(vana::table::active_quests) << " "
+					<< "WHERE character_id = :char AND quest_id = :quest",
+					soci::use(char_id, "char"),
+					soci::use(quest_id, "quest"));
+
+				for (const auto &stale_id : stale) {
+					quest_id = stale_id;
+					st.execute(true);
 				}
-				st.execute(true);
-
-				if (kvp.second.kills.size() > 0) {
-					id = db.get_last_id<int64_t>();
-					for (const auto &kill_pair : kvp.second.kills) {
-						mob_id = kill_pair.first;
-						killed = kill_pair.second;
-						st_mobs.execute(true);
+				deleted += stale.size();
+			}
+
+			if (changed.size() > 0) {
+				game_mob_id mob_id = 0;
+				uint16_t killed = 0;
+				int64_t id = 0;
+				opt_string data;
+				// GCC, as usual, bad with operators
+				data = "";
+
+				soci::statement st = (sql.prepare
+					<< "INSERT INTO " << db.make_table(vana::table::active_quests) << " (character_id, quest_id, data) "
+					<< "VALUES (:char, :quest, :data)",
+					soci::use(char_id, "char"),
+					soci::use(quest_id, "quest"),
+					soci::use(data, "data"));
+
+				soci::statement st_mobs = (sql.prepare
+					<< "INSERT INTO " << db.make_table(vana::table::active_quests_mobs) << " (active_quest_id, mob_id, quantity_killed) "
+					<< "VALUES (:id, :mob, :killed)",
+					soci::use(id, "id"),
+					soci::use(mob_id, "mob"),
+					soci::use(killed, "killed"));
+
+				for (const auto &changed_id : changed) {
+					const active_quest &quest = quests.find(changed_id)->second;
+					const string &d = quest.data;
+					quest_id = changed_id;
+					if (d.empty()) {
+						data.reset();
+					}
+					else {
+						data = d;
+					}
+					st.execute(true);
+					written++;
+
+					if (quest.kills.size() > 0) {
+						id = db.get_last_id<int64_t>();
+						for (const auto &kill_pair : quest.kills) {
+							mob_id = kill_pair.first;
+							killed = kill_pair.second;
+							st_mobs.execute(true);
+						}
+						written += quest.kills.size();
 					}
 				}
 			}
-		}
 
-		if (m_completed.size() > 0) {
-			int64_t time = 0;
+			changed.clear();
+			removed.clear();
+			player_saver::diff(baseline_completed, completed, [](const file_time &a, const file_time &b) { return a == b; }, changed, removed);
 
-			soci::statement st = (sql.prepare
-				<< "INSERT INTO " << db.make_table(vana::table::completed_quests) << " "
-				<< "VALUES (:char, :quest, :time)",
-				soci::use(char_id, "char"),
-				soci::use(quest_id, "quest"),
-				soci::use(time, "time"));
+			if (removed.size() > 0) {
+				soci::statement st = (sql.prepare
+					<< "DELETE FROM " << db.make_table(vana::table::completed_quests) << " "
+					<< "WHERE character_id = :char AND quest_id = :quest",
+					soci::use(char_id, "char"),
+					soci::use(quest_id, "quest"));
 
-			for (const auto &kvp : m_completed) {
-				quest_id = kvp.first;
-				time = kvp.second.get_value();
-				st.execute(true);
+				for (const auto &removed_id : removed) {
+					quest_id = removed_id;
+					st.execute(true);
+				}
+				deleted += removed.size();
 			}
-		}
+
+			if (changed.size() > 0) {
+				int64_t time = 0;
+
+				soci::statement st = (sql.prepare
+					<< "INSERT INTO " << db.make_table(vana::table::completed_quests) << " "
+					<< "VALUES (:char, :quest, :time) "
+					<< "ON DUPLICATE KEY UPDATE end_time = VALUES(end_time)",
+					soci::use(char_id, "char"),
+					soci::use(quest_id, "quest"),
+					soci::use(time, "time"));
+
+				for (const auto &changed_id : changed) {
+					quest_id = changed_id;
+					time = completed.find(changed_id)->second.get_value();
+					st.execute(true);
+				}
+				written += changed.size();
+			}
+
+			player_saver::count_rows(written, deleted);
+			player_saver::after_commit([saved_quests, saved_completed, quests, completed] {
+				*saved_quests = quests;
+				*saved_completed = completed;
+			});
+		};
 	}
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
@@ -163,6 +237,9 @@ auto player_quests::load() -> void {
 		for (const auto &row : rs) {
 			m_completed[row.get<game_quest_id>("quest_id")] = file_time{row.get<int64_t>("end_time")};
 		}
+
+		m_saved_quests = make_ref_ptr<ord_map<game_quest_id, active_quest>>(m_quests);
+		m_saved_completed = make_ref_ptr<ord_map<game_quest_id, file_time>>(m_completed);
 	}
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
@@ -68,7 +68,7 @@ namespace vana {
 			player_quests(ref_ptr<player> player);
 
 			auto load() -> void;
-			auto save() -> void;
+			auto snapshot(bool full) const -> function<void()>;
 			auto connect_packet(packet_builder &builder) -> void;
 
 			auto item_drop_allowed(game_item_id item_id, game_quest_id quest_id) -> allow_quest_item_result;
@@ -88,6 +88,9 @@ namespace vana {
 			hash_map<game_mob_id, vector<game_quest_id>> m_mob_to_quest_mapping;
 			ord_map<game_quest_id, active_quest> m_quests;
 			ord_map<game_quest_id, file_time> m_completed;
+			// What the database holds, only touched by this player's saves once loaded
+			ref_ptr<ord_map<game_quest_id, active_quest>> m_saved_quests;
+			ref_ptr<ord_map<game_quest_id, file_time>> m_saved_completed;
 		};
 	}
 }
\ No newline at end of file
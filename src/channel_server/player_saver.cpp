@@ -0,0 +1,164 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "player_saver.hpp"
+#include "common/io/database.hpp"
+#include "common/util/thread_pool.hpp"
+#include "channel_server/channel_server.hpp"
+#include <exception>
+
+namespace vana {
+namespace channel_server {
+
+thread_local player_saver::commit_context *player_saver::m_current_commit = nullptr;
+
+auto player_saver::start(uint16_t thread_count) -> void {
+	for (uint16_t i = 0; i < thread_count; i++) {
+		m_threads.push_back(vana::util::thread_pool::lease(
+			[this](owned_lock<recursive_mutex> &lock) {
+				if (m_ready.empty()) {
+					m_ready_condition.wait(lock);
+					return;
+				}
+
+				game_player_id player_id = m_ready.front();
+				m_ready.pop_front();
+				pending_save current = m_pending[player_id].front();
+
+				lock.unlock();
+				commit(player_id, current);
+				lock.lock();
+
+				auto kvp = m_pending.find(player_id);
+				kvp->second.pop_front();
+				if (kvp->second.empty()) {
+					m_pending.erase(kvp);
+				}
+				else {
+					m_ready.push_back(player_id);
+				}
+
+				m_committed_condition.notify_all();
+			},
+			[this] {
+				owned_lock<recursive_mutex> l{m_mutex};
+				m_ready_condition.notify_all();
+			},
+			m_mutex));
+	}
+}
+
+auto player_saver::enqueue(game_player_id player_id, function<void()> save, function<void(bool)> on_saved) -> void {
+	pending_save value;
+	value.save = save;
+	value.on_saved = on_saved;
+
+	owned_lock<recursive_mutex> l{m_mutex};
+	auto &saves = m_pending[player_id];
+	saves.push_back(value);
+	if (saves.size() == 1) {
+		// Otherwise a save thread already has this character and picks the new save up once it's done with the current one
+		m_ready.push_back(player_id);
+		m_ready_condition.notify_one();
+	}
+}
+
+auto player_saver::wait_for(game_player_id player_id) -> void {
+	owned_lock<recursive_mutex> l{m_mutex};
+	m_committed_condition.wait(l, [&] {
+		return m_pending.find(player_id) == std::end(m_pending);
+	});
+}
+
+auto player_saver::flush() -> void {
+	owned_lock<recursive_mutex> l{m_mutex};
+	while (!m_ready.empty()) {
+		game_player_id player_id = m_ready.front();
+		m_ready.pop_front();
+
+		// on_saved may queue another save for the character, e.g. to retry one that failed
+		auto &saves = m_pending[player_id];
+		while (!saves.empty()) {
+			pending_save value = saves.front();
+			commit(player_id, value);
+			saves.pop_front();
+		}
+		m_pending.erase(player_id);
+	}
+	m_committed_condition.notify_all();
+}
+
+auto player_saver::get_stats() -> save_stats {
+	owned_lock<recursive_mutex> l{m_mutex};
+	return m_stats;
+}
+
+auto player_saver::count_rows(size_t written, size_t deleted) -> void {
+	m_current_commit->rows_written += written;
+	m_current_commit->rows_deleted += deleted;
+}
+
+auto player_saver::after_commit(function<void()> func) -> void {
+	m_current_commit->on_committed.push_back(func);
+}
+
+auto player_saver::commit(game_player_id player_id, const pending_save &value) -> void {
+	commit_context context;
+	bool committed = false;
+	m_current_commit = &context;
+	try {
+		auto &sql = vana::io::database::get_char_db().get_session();
+		soci::transaction transaction{sql};
+		value.save();
+		transaction.commit();
+		committed = true;
+	}
+	catch (std::exception &e) {
+		channel_server::get_instance().log(vana::log::type::error, [&](out_stream &log) {
+			log << "Failed to save player " << player_id << ": " << e.what();
+		});
+	}
+	m_current_commit = nullptr;
+
+	if (committed) {
+		// A failed save leaves the last saved state alone, so the next save writes everything that has changed since the last one that made it
+		for (const auto &func : context.on_committed) {
+			func();
+		}
+	}
+
+	{
+		owned_lock<recursive_mutex> l{m_mutex};
+		if (committed) {
+			m_stats.saves++;
+			m_stats.rows_written += context.rows_written;
+			m_stats.rows_deleted += context.rows_deleted;
+			m_stats.last_rows_written = context.rows_written;
+			m_stats.last_rows_deleted = context.rows_deleted;
+		}
+		else {
+			m_stats.failed_saves++;
+		}
+	}
+
+	if (value.on_saved != nullptr) {
+		value.on_saved(committed);
+	}
+}
+
+}
+}
\ No newline at end of file
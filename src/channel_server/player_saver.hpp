@@ -0,0 +1,106 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/types.hpp"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vana {
+	namespace channel_server {
+		// Commits player saves on dedicated threads, each with its own database connection, so that packet handling never waits on MySQL
+		// A save is a snapshot of the player taken on the player's strand and is committed as a single transaction
+		// Saves for the same character commit one at a time in the order they were queued
+		class player_saver {
+			NONCOPYABLE(player_saver);
+		public:
+			player_saver() = default;
+
+			auto start(uint16_t thread_count) -> void;
+			// on_saved runs on the save thread once the transaction is done and is told whether it committed
+			auto enqueue(game_player_id player_id, function<void()> save, function<void(bool)> on_saved = nullptr) -> void;
+			// Blocks until every save queued for the character has been committed
+			auto wait_for(game_player_id player_id) -> void;
+			// Commits anything still queued on the calling thread, used once the save threads have stopped
+			auto flush() -> void;
+
+			struct save_stats {
+				uint64_t saves = 0;
+				uint64_t failed_saves = 0;
+				uint64_t rows_written = 0;
+				uint64_t rows_deleted = 0;
+				size_t last_rows_written = 0;
+				size_t last_rows_deleted = 0;
+			};
+			auto get_stats() -> save_stats;
+
+			// The following may only be called from within a save function
+			// Adds to the number of rows the current save wrote and deleted
+			static auto count_rows(size_t written, size_t deleted) -> void;
+			// Runs func if and once the current save commits, which is where subsystems move their last saved state forward
+			// Since saves for a character never overlap, that state is only ever touched by one save thread at a time
+			static auto after_commit(function<void()> func) -> void;
+
+			// Collects the keys in current that are new or not equal to their saved value and the keys in saved that are no longer in current
+			template <typename TMap, typename TEqual>
+			static auto diff(const TMap &saved, const TMap &current, TEqual equal, vector<typename TMap::key_type> &changed, vector<typename TMap::key_type> &removed) -> void;
+		private:
+			struct pending_save {
+				function<void()> save;
+				function<void(bool)> on_saved;
+			};
+
+			struct commit_context {
+				size_t rows_written = 0;
+				size_t rows_deleted = 0;
+				vector<function<void()>> on_committed;
+			};
+
+			auto commit(game_player_id player_id, const pending_save &value) -> void;
+
+			static thread_local commit_context *m_current_commit;
+
+			queue<game_player_id> m_ready;
+			// The front of each queue is the save that's being committed
+			hash_map<game_player_id, queue<pending_save>> m_pending;
+			std::condition_variable_any m_ready_condition;
+			std::condition_variable_any m_committed_condition;
+			recursive_mutex m_mutex;
+			vector<ref_ptr<std::thread>> m_threads;
+			save_stats m_stats;
+		};
+
+		template <typename TMap, typename TEqual>
+		auto player_saver::diff(const TMap &saved, const TMap &current, TEqual equal, vector<typename TMap::key_type> &changed, vector<typename TMap::key_type> &removed) -> void {
+			for (const auto &kvp : current) {
+				auto old = saved.find(kvp.first);
+				if (old == std::end(saved) || !equal(old->second, kvp.second)) {
+					changed.push_back(kvp.first);
+				}
+			}
+			for (const auto &kvp : saved) {
+				if (current.find(kvp.first) == std::end(current)) {
+					removed.push_back(kvp.first);
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
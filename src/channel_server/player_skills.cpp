@@ -32,6 +32,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "channel_server/party.hpp"
 #include "channel_server/party_packet.hpp"
 #include "channel_server/player.hpp"
+#include "channel_server/player_saver.hpp"
 #include "channel_server/skills.hpp"
 #include "channel_server/skills_packet.hpp"
 
@@ -71,6 +72,8 @@ auto player_skills::load() -> void {
 			m_skills[skill_id] = skill;
 		}
 
+		m_saved_skills = make_ref_ptr<hash_map<game_skill_id, player_skill_info>>(m_skills);
+
 		rs = (sql.prepare
 			<< "SELECT c.* "
 			<< "FROM " << db.make_table(vana::table::cooldowns) << " c "
@@ -79,7 +82,8 @@ auto player_skills::load() -> void {
 
 		for (const auto &row : rs) {
 			game_skill_id skill_id = row.get<game_skill_id>("skill_id");
-			seconds time_left = seconds{row.get<int16_t>("remaining_time")};
+			int16_t remaining_time = row.get<int16_t>("remaining_time");
+			seconds time_left = seconds{remaining_time};
 			skills::start_cooldown(player, skill_id, time_left, true);
 			m_cooldowns[skill_id] = time_left;
 		}
@@ -119,53 +123,90 @@ auto player_skills::load() -> void {
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
 
-auto player_skills::save(bool save_cooldowns) -> void {
+auto player_skills::snapshot(bool full, bool save_cooldowns) const -> function<void()> {
 	if (auto player = m_player.lock()) {
-		using namespace soci;
 		game_player_id player_id = player->get_id();
-		auto &db = vana::io::database::get_char_db();
-		auto &sql = db.get_session();
-
-		game_skill_id skill_id = 0;
-		game_skill_level level = 0;
-		game_skill_level max_level = 0;
-		statement st = (sql.prepare
-			<< "REPLACE INTO " << db.make_table(vana::table::skills) << " VALUES (:player, :skill, :level, :max_level)",
-			use(player_id, "player"),
-			use(skill_id, "skill"),
-			use(level, "level"),
-			use(max_level, "max_level"));
-
+		hash_map<game_skill_id, player_skill_info> skill_levels;
 		for (const auto &kvp : m_skills) {
-			if (vana::util::game_logic::player_skill::is_blessing_of_the_fairy(kvp.first)) {
-				continue;
+			if (!vana::util::game_logic::player_skill::is_blessing_of_the_fairy(kvp.first)) {
+				skill_levels[kvp.first] = kvp.second;
 			}
-			skill_id = kvp.first;
-			level = kvp.second.level;
-			max_level = kvp.second.player_max_skill_level;
-			st.execute(true);
 		}
 
+		hash_map<game_skill_id, int16_t> cooldowns;
 		if (save_cooldowns) {
-			sql.once << "DELETE FROM " << db.make_table(vana::table::cooldowns) << " WHERE character_id = :char",
-				soci::use(player_id, "char");
-
-			if (m_cooldowns.size() > 0) {
-				int16_t remaining_time = 0;
-				st = (sql.prepare
-					<< "INSERT INTO " << db.make_table(vana::table::cooldowns) << " (character_id, skill_id, remaining_time) "
-					<< "VALUES (:char, :skill, :time)",
-					use(player_id, "char"),
-					use(skill_id, "skill"),
-					use(remaining_time, "time"));
+			for (const auto &kvp : m_cooldowns) {
+				cooldowns[kvp.first] = skills::get_cooldown_time_left(player, kvp.first);
+			}
+		}
+
+		auto saved_skills = m_saved_skills;
+
+		return [=]() {
+			using namespace soci;
+			auto &db = vana::io::database::get_char_db();
+			auto &sql = db.get_session();
 
-				for (const auto &kvp : m_cooldowns) {
-					skill_id = kvp.first;
-					remaining_time = skills::get_cooldown_time_left(player, kvp.first);
+			// A full save rewrites every row instead of trusting that the database still holds what was loaded
+			// Skills are never deleted, a skill that's gone keeps its row like it always has
+			hash_map<game_skill_id, player_skill_info> no_skills;
+			const auto &baseline_skills = full ? no_skills : *saved_skills;
+
+			vector<game_skill_id> changed;
+			vector<game_skill_id> removed;
+			player_saver::diff(baseline_skills, skill_levels, [](const player_skill_info &a, const player_skill_info &b) {
+				return a.level == b.level && a.player_max_skill_level == b.player_max_skill_level;
+			}, changed, removed);
+
+			game_skill_id skill_id = 0;
+			if (changed.size() > 0) {
+				game_skill_level level = 0;
+				game_skill_level max_level = 0;
+				statement st = (sql.prepare
+					<< "REPLACE INTO " << db.make_table(vana::table::skills) << " VALUES (:player, :skill, :level, :max_level)",
+					use(player_id, "player"),
+					use(skill_id, "skill"),
+					use(level, "level"),
+					use(max_level, "max_level"));
+
+				for (const auto &changed_id : changed) {
+					const auto &info = skill_levels.find(changed_id)->second;
+					skill_id = changed_id;
+					level = info.level;
+					max_level = info.player_max_skill_level;
 					st.execute(true);
 				}
 			}
-		}
+
+			player_saver::count_rows(changed.size(), 0);
+			player_saver::after_commit([saved_skills, skill_levels] {
+				*saved_skills = skill_levels;
+			});
+
+			if (save_cooldowns) {
+				// Cooldowns are only saved when the character leaves the channel, so there's never an earlier cooldown save in this session to diff against
+				sql.once << "DELETE FROM " << db.make_table(vana::table::cooldowns) << " WHERE character_id = :char",
+					use(player_id, "char");
+
+				if (cooldowns.size() > 0) {
+					int16_t remaining_time = 0;
+					statement st = (sql.prepare
+						<< "INSERT INTO " << db.make_table(vana::table::cooldowns) << " (character_id, skill_id, remaining_time) "
+						<< "VALUES (:char, :skill, :time)",
+						use(player_id, "char"),
+						use(skill_id, "skill"),
+						use(remaining_time, "time"));
+
+					for (const auto &kvp : cooldowns) {
+						skill_id = kvp.first;
+						remaining_time = kvp.second;
+						st.execute(true);
+					}
+				}
+
+				player_saver::count_rows(cooldowns.size(), 0);
+			}
+		};
 	}
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
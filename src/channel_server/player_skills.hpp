@@ -47,7 +47,7 @@ namespace vana {
 			player_skills(ref_ptr<player> player);
 
 			auto load() -> void;
-			auto save(bool save_cooldowns = false) -> void;
+			auto snapshot(bool full, bool save_cooldowns = false) const -> function<void()>;
 			auto connect_packet(packet_builder &builder) const -> void;
 			auto connect_packet_for_blessing(packet_builder &builder) const -> void;
 
@@ -105,6 +105,8 @@ namespace vana {
 			view_ptr<player> m_player;
 			hash_map<game_skill_id, player_skill_info> m_skills;
 			hash_map<game_skill_id, seconds> m_cooldowns;
+			// What the database holds, only touched by this player's saves once loaded
+			ref_ptr<hash_map<game_skill_id, player_skill_info>> m_saved_skills;
 			ref_ptr<mystic_door> m_mystic_door;
 			string m_blessing_player;
 		};
@@ -23,12 +23,21 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "channel_server/channel_server.hpp"
 #include "channel_server/inventory.hpp"
 #include "channel_server/player.hpp"
+#include "channel_server/player_saver.hpp"
 #include "channel_server/storage_packet.hpp"
 #include <algorithm>
 
 namespace vana {
 namespace channel_server {
 
+struct player_storage::saved_state {
+	game_storage_slot slots = 0;
+	int32_t char_slots = 0;
+	game_mesos mesos = 0;
+	// Keyed by the slot column, which is the item's position in storage
+	ord_map<game_inventory_slot, item> items;
+};
+
 player_storage::player_storage(ref_ptr<player> player) :
 	m_player{player}
 {
@@ -131,6 +140,10 @@ auto player_storage::load() -> void {
 		}
 
 		m_items.reserve(m_slots);
+		m_saved = make_ref_ptr<saved_state>();
+		m_saved->slots = m_slots;
+		m_saved->char_slots = m_char_slots;
+		m_saved->mesos = m_mesos.get_mesos();
 
 		string location = "storage";
 
@@ -146,47 +159,106 @@ auto player_storage::load() -> void {
 		for (const auto &row : rs) {
 			item *value = new item{row};
 			add_item(value);
+			m_saved->items.emplace(row.get<game_inventory_slot>("slot"), *value);
 		}
 	}
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
 
-auto player_storage::save() -> void {
+auto player_storage::snapshot(bool full) const -> function<void()> {
 	if (auto player = m_player.lock()) {
-		using namespace soci;
 		game_world_id world_id = player->get_world_id();
 		game_account_id account_id = player->get_account_id();
 		game_player_id player_id = player->get_id();
+		game_storage_slot slots = m_slots;
+		int32_t char_slots = m_char_slots;
+		game_mesos mesos = m_mesos.get_mesos();
+		auto saved = m_saved;
 
-		auto &db = vana::io::database::get_char_db();
-		auto &sql = db.get_session();
-		sql.once
-			<< "UPDATE " << db.make_table(vana::table::storage) << " "
-			<< "SET slots = :slots, mesos = :mesos, char_slots = :chars "
-			<< "WHERE account_id = :account AND world_id = :world",
-			use(account_id, "account"),
-			use(world_id, "world"),
-			use(m_slots, "slots"),
-			use(m_mesos.get_mesos(), "mesos"),
-			use(m_char_slots, "chars");
+		auto items = make_ref_ptr<ord_map<game_inventory_slot, item>>();
+		for (game_storage_slot i = 0; i < m_items.size(); ++i) {
+			items->emplace(i, *m_items[i]);
+		}
 
-		sql.once
-			<< "DELETE FROM " << db.make_table(vana::table::items) << " "
-			<< "WHERE location = :location AND account_id = :account AND world_id = :world",
-			use(item::storage, "location"),
-			use(account_id, "account"),
-			use(world_id, "world");
-
-		game_storage_slot max = get_num_items();
-
-		if (max > 0) {
-			vector<item_db_record> v;
-			for (game_storage_slot i = 0; i < max; ++i) {
-				item_db_record rec{i, player_id, account_id, world_id, item::storage, get_item(i)};
-				v.push_back(rec);
+		return [=]() {
+			using namespace soci;
+			auto &db = vana::io::database::get_char_db();
+			auto &sql = db.get_session();
+			size_t written = 0;
+			size_t deleted = 0;
+
+			if (full || slots != saved->slots || char_slots != saved->char_slots || mesos != saved->mesos) {
+				sql.once
+					<< "UPDATE " << db.make_table(vana::table::storage) << " "
+					<< "SET slots = :slots, mesos = :mesos, char_slots = :chars "
+					<< "WHERE account_id = :account AND world_id = :world",
+					use(account_id, "account"),
+					use(world_id, "world"),
+					use(slots, "slots"),
+					use(mesos, "mesos"),
+					use(char_slots, "chars");
+				written++;
 			}
-			item::database_insert(db, v);
-		}
+
+			// A full save rewrites every row instead of trusting that the database still holds what was loaded
+			ord_map<game_inventory_slot, item> none;
+			const auto &baseline = full ? none : saved->items;
+			if (full) {
+				sql.once
+					<< "DELETE FROM " << db.make_table(vana::table::items) << " "
+					<< "WHERE location = :location AND account_id = :account AND world_id = :world",
+					use(item::storage, "location"),
+					use(account_id, "account"),
+					use(world_id, "world");
+			}
+
+			// Taking an item out shifts everything after it, so those slots show up as changed too
+			vector<game_inventory_slot> changed;
+			vector<game_inventory_slot> removed;
+			player_saver::diff(baseline, *items, [](const item &a, const item &b) { return a.has_same_data(b); }, changed, removed);
+
+			vector<game_inventory_slot> stale = removed;
+			for (const auto &slot : changed) {
+				if (baseline.find(slot) != std::end(baseline)) {
+					stale.push_back(slot);
+				}
+			}
+
+			if (stale.size() > 0) {
+				game_inventory_slot slot = 0;
+				statement st = (sql.prepare
+					<< "DELETE FROM " << db.make_table(vana::table::items) << " "
+					<< "WHERE location = :location AND account_id = :account AND world_id = :world AND slot = :slot",
+					use(item::storage, "location"),
+					use(account_id, "account"),
+					use(world_id, "world"),
+					use(slot, "slot"));
+
+				for (const auto &stale_slot : stale) {
+					slot = stale_slot;
+					st.execute(true);
+				}
+				deleted += stale.size();
+			}
+
+			if (changed.size() > 0) {
+				vector<item_db_record> v;
+				for (const auto &slot : changed) {
+					item_db_record rec{slot, player_id, account_id, world_id, item::storage, &items->find(slot)->second};
+					v.push_back(rec);
+				}
+				item::database_insert(db, v);
+				written += changed.size();
+			}
+
+			player_saver::count_rows(written, deleted);
+			player_saver::after_commit([saved, items, slots, char_slots, mesos] {
+				saved->slots = slots;
+				saved->char_slots = char_slots;
+				saved->mesos = mesos;
+				saved->items = *items;
+			});
+		};
 	}
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
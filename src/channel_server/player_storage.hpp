@@ -54,13 +54,17 @@ namespace vana {
 			}
 
 			auto load() -> void;
-			auto save() -> void;
+			auto snapshot(bool full) const -> function<void()>;
 		private:
+			struct saved_state;
+
 			game_storage_slot m_slots = 0;
 			int32_t m_char_slots = 0;
 			vana::util::meso_inventory m_mesos;
 			vector<item *> m_items;
 			view_ptr<player> m_player;
+			// What the database holds, only touched by this player's saves once loaded
+			ref_ptr<saved_state> m_saved;
 		};
 	}
 }
\ No newline at end of file
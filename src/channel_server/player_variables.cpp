@@ -18,6 +18,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "player_variables.hpp"
 #include "common/io/database.hpp"
 #include "channel_server/player.hpp"
+#include "channel_server/player_saver.hpp"
 
 namespace vana {
 namespace channel_server {
@@ -28,32 +29,65 @@ player_variables::player_variables(ref_ptr<player> player) :
 	load();
 }
 
-auto player_variables::save() -> void {
+auto player_variables::snapshot(bool full) const -> function<void()> {
 	if (auto player = m_player.lock()) {
-		auto &db = vana::io::database::get_char_db();
-		auto &sql = db.get_session();
 		game_player_id char_id = player->get_id();
+		hash_map<string, string> variables = m_variables;
+		auto saved = m_saved;
+
+		return [=]() {
+			auto &db = vana::io::database::get_char_db();
+			auto &sql = db.get_session();
 
-		sql.once << "DELETE FROM " << db.make_table(vana::table::character_variables) << " WHERE character_id = :char",
-			soci::use(char_id, "char");
+			// A full save rewrites every row instead of trusting that the database still holds what was loaded
+			hash_map<string, string> none;
+			const auto &baseline = full ? none : *saved;
+			if (full) {
+				sql.once << "DELETE FROM " << db.make_table(vana::table::character_variables) << " WHERE character_id = :char",
+					soci::use(char_id, "char");
+			}
+
+			vector<string> changed;
+			vector<string> removed;
+			player_saver::diff(baseline, variables, [](const string &a, const string &b) { return a == b; }, changed, removed);
 
-		if (m_variables.size() > 0) {
 			string key = "";
 			string value = "";
 
-			soci::statement st = (sql.prepare
-				<< "INSERT INTO " << db.make_table(vana::table::character_variables) << " "
-				<< "VALUES (:char, :key, :value)",
-				soci::use(char_id, "char"),
-				soci::use(key, "key"),
-				soci::use(value, "value"));
-
-			for (const auto &kvp : m_variables) {
-				key = kvp.first;
-				value = kvp.second;
-				st.execute(true);
+			if (removed.size() > 0) {
+				soci::statement st = (sql.prepare
+					<< "DELETE FROM " << db.make_table(vana::table::character_variables) << " "
+					<< "WHERE character_id = :char AND `key` = :key",
+					soci::use(char_id, "char"),
+					soci::use(key, "key"));
+
+				for (const auto &removed_key : removed) {
+					key = removed_key;
+					st.execute(true);
+				}
 			}
-		}
+
+			if (changed.size() > 0) {
+				soci::statement st = (sql.prepare
+					<< "INSERT INTO " << db.make_table(vana::table::character_variables) << " "
+					<< "VALUES (:char, :key, :value) "
+					<< "ON DUPLICATE KEY UPDATE value = VALUES(value)",
+					soci::use(char_id, "char"),
+					soci::use(key, "key"),
+					soci::use(value, "value"));
+
+				for (const auto &changed_key : changed) {
+					key = changed_key;
+					value = variables.find(changed_key)->second;
+					st.execute(true);
+				}
+			}
+
+			player_saver::count_rows(changed.size(), removed.size());
+			player_saver::after_commit([saved, variables] {
+				*saved = variables;
+			});
+		};
 	}
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
@@ -68,6 +102,8 @@ auto player_variables::load() -> void {
 		for (const auto &row : rs) {
 			m_variables[row.get<string>("key")] = row.get<string>("value");
 		}
+
+		m_saved = make_ref_ptr<hash_map<string, string>>(m_variables);
 	}
 	else THROW_CODE_EXCEPTION(invalid_operation_exception, "This should never be thrown");
 }
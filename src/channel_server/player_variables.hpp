@@ -28,10 +28,12 @@ namespace vana {
 			NO_DEFAULT_CONSTRUCTOR(player_variables);
 		public:
 			player_variables(ref_ptr<player> player);
-			auto save() -> void;
+			auto snapshot(bool full) const -> function<void()>;
 			auto load() -> void;
 		private:
 			view_ptr<player> m_player;
+			// What the database holds, only touched by this player's saves once loaded
+			ref_ptr<hash_map<string, string>> m_saved;
 		};
 	}
 }
\ No newline at end of file
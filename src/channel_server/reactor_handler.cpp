@@ -18,11 +18,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "reactor_handler.hpp"
 #include "common/data/provider/reactor.hpp"
 #include "common/data/provider/script.hpp"
+#include "common/lua/chunk_cache.hpp"
 #include "common/packet_reader.hpp"
 #include "common/point.hpp"
 #include "common/timer/thread.hpp"
 #include "common/timer/timer.hpp"
-#include "common/util/file.hpp"
 #include "common/util/time.hpp"
 #include "channel_server/channel_server.hpp"
 #include "channel_server/drop.hpp"
@@ -79,7 +79,7 @@ auto reactor_handler::hit_reactor(ref_ptr<player> player, packet_reader &reader)
 				// Reactor is finished
 				filename = channel.get_script_data_provider().get_script(&channel, reactor->get_reactor_id(), data::type::script_type::reactor);
 
-				if (vana::util::file::exists(filename)) {
+				if (vana::lua::chunk_cache::exists(filename)) {
 					lua::lua_reactor{filename, player->get_id(), id, reactor->get_map_id()};
 				}
 				else {
@@ -95,7 +95,7 @@ auto reactor_handler::hit_reactor(ref_ptr<player> player, packet_reader &reader)
 				util::str::lexical_cast<string>(reactor->get_reactor_id())
 			);
 
-			if (util::file::exists(filename)) {
+			if (vana::lua::chunk_cache::exists(filename)) {
 				lua::lua_reactor{filename, player->get_id(), id, reactor->get_map_id()};
 			}
 #ifdef _DEBUG
@@ -144,6 +144,12 @@ auto summon_handler::show_summons(ref_ptr<player> from_player, ref_ptr<player> t
 	});
 }
 
+auto summon_handler::hide_summons(ref_ptr<player> from_player, ref_ptr<player> to_player) -> void {
+	from_player->get_summons()->for_each([from_player, to_player](summon *summon) {
+		to_player->send(packets::remove_summon(from_player->get_id(), summon, summon_messages::none));
+	});
+}
+
 auto summon_handler::move_summon(ref_ptr<player> player, packet_reader &reader) -> void {
 	game_summon_id summon_id = reader.get<game_summon_id>();
 
@@ -155,7 +161,7 @@ auto summon_handler::move_summon(ref_ptr<player> player, packet_reader &reader)
 
 	move_path path(reader);
 	summon->reset_from_move_path(path);
-	player->send_map(packets::move_summon(player->get_id(), summon, path), true);
+	player->send_nearby(packets::move_summon(player->get_id(), summon, path), true);
 }
 
 auto summon_handler::damage_summon(ref_ptr<player> player, packet_reader &reader) -> void {
@@ -50,6 +50,7 @@ namespace vana {
 			auto remove_summon(ref_ptr<player> player, game_summon_id summon_id, bool packet_only, int8_t show_message, bool from_timer = false) -> void;
 			auto show_summon(ref_ptr<player> player) -> void;
 			auto show_summons(ref_ptr<player> from_player, ref_ptr<player> to_player) -> void;
+			auto hide_summons(ref_ptr<player> from_player, ref_ptr<player> to_player) -> void;
 			auto move_summon(ref_ptr<player> player, packet_reader &reader) -> void;
 			auto damage_summon(ref_ptr<player> player, packet_reader &reader) -> void;
 			auto make_buff(ref_ptr<player> player, game_item_id item_id) -> data::type::buff_info;
@@ -0,0 +1,135 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "common/encrypted_packet_transformer.hpp"
+#include "common/types.hpp"
+#include "cipher_tools/reference_transformer.hpp"
+#include <botan/botan.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Times encrypted_packet_transformer against the reference code (a Botan::Pipe per AES chunk) across packet sizes
+// Usage: cipher_bench [megabytes per size]
+
+namespace vana {
+namespace cipher_tools {
+
+// The header length sessions pass in
+const uint16_t header_size = 4;
+const uint32_t default_megabytes = 16;
+// From movement and attack sized packets up to ones that span several AES chunks
+const int32_t packet_sizes[] = {16, 64, 256, 1024, 1456, 4096, 16384};
+
+struct timing {
+	double encrypt_ns = 0;
+	double decrypt_ns = 0;
+};
+
+template <typename TTransformer>
+auto measure(int32_t size, uint64_t packets, uint32_t &checksum) -> timing {
+	using clock = std::chrono::steady_clock;
+
+	vector<unsigned char> buffer(size);
+	for (int32_t i = 0; i < size; ++i) {
+		buffer[i] = static_cast<unsigned char>(i * 31 + 7);
+	}
+
+	TTransformer codec{0x52A8F1C3, 0x52A8F1C3};
+	timing ret;
+
+	auto start = clock::now();
+	for (uint64_t i = 0; i < packets; ++i) {
+		codec.encrypt_packet(buffer.data(), size, header_size);
+	}
+	ret.encrypt_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count()) / packets;
+	checksum += buffer[size / 2];
+
+	start = clock::now();
+	for (uint64_t i = 0; i < packets; ++i) {
+		codec.decrypt_packet(buffer.data(), size, header_size);
+	}
+	ret.decrypt_ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count()) / packets;
+	checksum += buffer[size / 2];
+
+	return ret;
+}
+
+auto megabytes_per_second(int32_t size, double ns) -> double {
+	return size / ns * 1e9 / (1024 * 1024);
+}
+
+auto bench(uint32_t megabytes) -> void {
+	uint32_t checksum = 0;
+	std::cout << std::left
+		<< std::setw(8) << "Size"
+		<< std::setw(10) << "Packets"
+		<< std::setw(14) << "Direction"
+		<< std::setw(16) << "Pipe ns/pkt"
+		<< std::setw(16) << "New ns/pkt"
+		<< std::setw(14) << "Pipe MB/s"
+		<< std::setw(14) << "New MB/s"
+		<< "Speedup" << std::endl;
+
+	std::cout << std::fixed << std::setprecision(1);
+	for (int32_t size : packet_sizes) {
+		uint64_t packets = std::max<uint64_t>(static_cast<uint64_t>(megabytes) * 1024 * 1024 / size, 1000);
+		timing reference = measure<reference_transformer>(size, packets, checksum);
+		timing optimized = measure<encrypted_packet_transformer>(size, packets, checksum);
+
+		auto print = [&](const char *direction, double reference_ns, double optimized_ns) {
+			std::cout << std::setw(8) << size
+				<< std::setw(10) << packets
+				<< std::setw(14) << direction
+				<< std::setw(16) << reference_ns
+				<< std::setw(16) << optimized_ns
+				<< std::setw(14) << megabytes_per_second(size, reference_ns)
+				<< std::setw(14) << megabytes_per_second(size, optimized_ns)
+				<< reference_ns / optimized_ns << "x" << std::endl;
+		};
+		print("encrypt", reference.encrypt_ns, optimized.encrypt_ns);
+		print("decrypt", reference.decrypt_ns, optimized.decrypt_ns);
+	}
+
+	// Keeps the packets observable so the loops can't be dropped
+	std::cout << "Checksum " << checksum << std::endl;
+}
+
+}
+}
+
+auto main(int argc, char *argv[]) -> int {
+	Botan::LibraryInitializer init{"thread_safe=true"};
+
+	try {
+		uint32_t megabytes = argc > 1 ?
+			static_cast<uint32_t>(std::stoul(argv[1])) :
+			vana::cipher_tools::default_megabytes;
+
+		vana::cipher_tools::bench(megabytes);
+		return EXIT_SUCCESS;
+	}
+	catch (std::exception &e) {
+		std::cerr << "PROGRAM ERROR: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "common/encrypted_packet_transformer.hpp"
+#include "common/types.hpp"
+#include "cipher_tools/reference_transformer.hpp"
+#include <botan/botan.h>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Runs encrypted_packet_transformer and the reference code over the same random packets and requires byte-exact output
+// Usage: cipher_fuzz [iterations] [seed], a failure prints the seed so it can be reproduced
+
+namespace vana {
+namespace cipher_tools {
+
+// The header length sessions pass in, the first AES chunk of a packet is shorter by this much
+const uint16_t header_size = 4;
+const int32_t chunk_size = 1460;
+const int32_t max_packet_size = chunk_size * 3;
+const uint32_t default_iterations = 20000;
+
+auto pick_size(std::mt19937 &engine) -> int32_t {
+	std::uniform_int_distribution<int32_t> kind{0, 3};
+	switch (kind(engine)) {
+		case 0: {
+			// Short packets, every length modulo 8 hits a different forward rotation
+			std::uniform_int_distribution<int32_t> size{1, 32};
+			return size(engine);
+		}
+		case 1: {
+			// Around the end of the first and second AES chunk
+			std::uniform_int_distribution<int32_t> chunks{1, 2};
+			std::uniform_int_distribution<int32_t> offset{-2, 2};
+			return chunks(engine) * chunk_size - header_size + offset(engine);
+		}
+		default: {
+			std::uniform_int_distribution<int32_t> size{1, max_packet_size};
+			return size(engine);
+		}
+	}
+}
+
+auto first_difference(const vector<unsigned char> &left, const vector<unsigned char> &right) -> size_t {
+	size_t i = 0;
+	while (i < left.size() && left[i] == right[i]) {
+		++i;
+	}
+	return i;
+}
+
+auto report(const char *step, uint32_t seed, uint32_t iteration, int32_t packet, int32_t size, crypto_iv iv, size_t offset) -> void {
+	std::cerr << step << " mismatch: seed " << seed
+		<< ", iteration " << iteration
+		<< ", packet " << packet
+		<< ", size " << size
+		<< ", IV 0x" << std::hex << iv << std::dec
+		<< ", first differing byte " << offset << std::endl;
+}
+
+auto fuzz(uint32_t iterations, uint32_t seed) -> bool {
+	std::mt19937 engine{seed};
+	std::uniform_int_distribution<crypto_iv> iv_distribution;
+	std::uniform_int_distribution<int32_t> byte_distribution{0, 255};
+	std::uniform_int_distribution<int32_t> packet_distribution{1, 8};
+
+	vector<unsigned char> plain;
+	vector<unsigned char> optimized;
+	vector<unsigned char> reference;
+	uint64_t packets_checked = 0;
+
+	for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+		// Both directions start from the same IV, so the ciphertext can be decrypted by the same pair again
+		crypto_iv iv = iv_distribution(engine);
+		encrypted_packet_transformer optimized_codec{iv, iv};
+		reference_transformer reference_codec{iv, iv};
+
+		// Several packets per pair so the IVs are shuffled between them like they are in a session
+		int32_t packets = packet_distribution(engine);
+		for (int32_t packet = 0; packet < packets; ++packet) {
+			int32_t size = pick_size(engine);
+			plain.resize(size);
+			for (auto &value : plain) {
+				value = static_cast<unsigned char>(byte_distribution(engine));
+			}
+
+			optimized = plain;
+			reference = plain;
+			optimized_codec.encrypt_packet(optimized.data(), size, header_size);
+			reference_codec.encrypt_packet(reference.data(), size, header_size);
+			if (optimized != reference) {
+				report("Encrypt", seed, iteration, packet, size, iv, first_difference(optimized, reference));
+				return false;
+			}
+
+			optimized_codec.decrypt_packet(optimized.data(), size, header_size);
+			reference_codec.decrypt_packet(reference.data(), size, header_size);
+			if (optimized != reference) {
+				report("Decrypt", seed, iteration, packet, size, iv, first_difference(optimized, reference));
+				return false;
+			}
+			if (optimized != plain) {
+				report("Round trip", seed, iteration, packet, size, iv, first_difference(optimized, plain));
+				return false;
+			}
+
+			++packets_checked;
+		}
+	}
+
+	std::cout << packets_checked << " packets matched the reference byte for byte (seed " << seed << ")" << std::endl;
+	return true;
+}
+
+}
+}
+
+auto main(int argc, char *argv[]) -> int {
+	Botan::LibraryInitializer init{"thread_safe=true"};
+
+	try {
+		uint32_t iterations = argc > 1 ?
+			static_cast<uint32_t>(std::stoul(argv[1])) :
+			vana::cipher_tools::default_iterations;
+		uint32_t seed = argc > 2 ?
+			static_cast<uint32_t>(std::stoul(argv[2])) :
+			std::random_device{}();
+
+		return vana::cipher_tools::fuzz(iterations, seed) ?
+			EXIT_SUCCESS :
+			EXIT_FAILURE;
+	}
+	catch (std::exception &e) {
+		std::cerr << "PROGRAM ERROR: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
\ No newline at end of file
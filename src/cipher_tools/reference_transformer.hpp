@@ -0,0 +1,40 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/block_cipher_iv.hpp"
+#include "common/types.hpp"
+#include <botan/lookup.h>
+
+namespace vana {
+	namespace cipher_tools {
+		// The packet encryption exactly as it was before encrypted_packet_transformer was optimized
+		// The custom layer computes every rotation per byte and AES goes through a new Botan::Pipe for every chunk
+		// Only used to check the optimized transformer against and to measure it by, never by the servers
+		class reference_transformer {
+		public:
+			reference_transformer(crypto_iv recv_iv, crypto_iv send_iv);
+			auto encrypt_packet(unsigned char *packet_data, int32_t real_packet_size, uint16_t header_size) -> void;
+			auto decrypt_packet(unsigned char *packet_data, int32_t real_packet_size, uint16_t header_size) -> void;
+		private:
+			block_cipher_iv m_recv;
+			block_cipher_iv m_send;
+			Botan::OctetString m_botan_key;
+		};
+	}
+}
\ No newline at end of file
@@ -28,8 +28,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common/log/base_logger.hpp"
 #include "common/log/sql_logger.hpp"
 #include "common/lua/config_file.hpp"
+#include "common/packet_stats.hpp"
 #include "common/session.hpp"
 #include "common/timer/thread.hpp"
+#include "common/timer/timer.hpp"
 #include "common/util/misc.hpp"
 #include "common/util/thread_pool.hpp"
 #include "common/util/time.hpp"
@@ -99,8 +101,9 @@ auto abstract_server::initialize() -> result {
 		return result::failure;
 	}
 	init_complete();
+	start_packet_stats_timer();
 
-	m_connection_manager.run();
+	m_connection_manager.run(get_io_thread_count());
 
 	return result::success;
 }
@@ -117,6 +120,27 @@ auto abstract_server::load_log_config() -> void {
 	}
 }
 
+auto abstract_server::start_packet_stats_timer() -> void {
+	if (m_inter_server_config.packet_stats_interval == 0) {
+		return;
+	}
+
+	seconds interval{m_inter_server_config.packet_stats_interval};
+	vana::timer::timer::create(
+		[this](const time_point &now) {
+			string title = get_log_prefix();
+			opt_string identifier = make_log_identifier();
+			if (identifier.is_initialized()) {
+				title += " " + identifier.get();
+			}
+			packet_stats::dump("logs/" + get_log_prefix() + "_packet_stats.log", title);
+		},
+		vana::timer::id{vana::timer::type::packet_stats_timer},
+		nullptr,
+		interval,
+		interval);
+}
+
 auto abstract_server::shutdown() -> void {
 	m_connection_manager.stop();
 	vana::util::thread_pool::wait();
@@ -147,6 +171,12 @@ auto abstract_server::init_complete() -> void {
 	// Intentionally left blank
 }
 
+auto abstract_server::get_io_thread_count() const -> uint16_t {
+	// Every server keeps its shared state on a single thread
+	// The channel already runs maps on their own strands, but map changes, disconnects and the systems shared between maps (parties, buddies, trades) still cross them
+	return 1;
+}
+
 auto abstract_server::send_auth(ref_ptr<session> session) const -> void {
 	session->send(
 		packets::send_password(
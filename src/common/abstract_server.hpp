@@ -44,6 +44,8 @@ namespace vana {
 		auto get_server_type() const -> server_type;
 		auto get_inter_password() const -> string;
 		auto get_interserver_salting_policy() const -> const config::salt &;
+		auto get_inter_server_config() const -> const config::inter_server &;
+		auto get_io_service() -> asio::io_service & { return m_connection_manager.get_io_service(); }
 	protected:
 		abstract_server(server_type type);
 		virtual auto load_config() -> result;
@@ -51,14 +53,15 @@ namespace vana {
 		virtual auto load_data() -> result = 0;
 		virtual auto make_log_identifier() const -> opt_string = 0;
 		virtual auto get_log_prefix() const -> string = 0;
+		virtual auto get_io_thread_count() const -> uint16_t;
 
-		auto get_inter_server_config() const -> const config::inter_server &;
 		auto send_auth(ref_ptr<session> session) const -> void;
 		auto display_launch_time() const -> void;
 		auto build_log_identifier(function<void(out_stream &)> produce_id) const -> opt_string;
 		auto get_connection_manager() -> connection_manager & { return m_connection_manager; }
 	private:
 		auto load_log_config() -> void;
+		auto start_packet_stats_timer() -> void;
 		auto create_logger(const config::log &conf) -> void;
 
 		server_type m_server_type = server_type::none;
@@ -110,7 +110,7 @@ namespace vana {
 			if (map == nullptr) {
 				return nullptr;
 			}
-			return find_value_ptr(*map, pred);
+			return find_value_ptr_if(*map, pred);
 		}
 
 		template <typename TValue, typename TPred>
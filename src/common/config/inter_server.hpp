@@ -22,6 +22,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common/lua/config_file.hpp"
 #include "common/types.hpp"
 #include <string>
+#include <vector>
 
 namespace vana {
 	namespace config {
@@ -32,6 +33,15 @@ namespace vana {
 			}
 
 			bool client_encryption = true;
+			uint16_t channel_save_threads = 2;
+			uint16_t channel_load_threads = 4;
+			uint32_t client_send_queue_limit = 512 * 1024;
+			uint32_t packet_stats_interval = 300;
+			bool capture_client_packets = false;
+			bool replay_captures = false;
+			bool preload_all_maps = false;
+			vector<game_map_id> preload_maps;
+			game_coord map_aoi_radius = 0;
 			ping client_ping;
 			ping server_ping;
 			connection_port login_port = 0;
@@ -48,6 +58,15 @@ namespace vana {
 			ret.server_ping = config.get<config::ping>("inter_ping");
 			ret.login_ip = ip{ip::string_to_ipv4(config.get<string>("login_ip"))};
 			ret.login_port = config.get<connection_port>("login_inter_port");
+			ret.channel_save_threads = std::max<uint16_t>(config.get<uint16_t>("channel_save_threads", ret.channel_save_threads), 1);
+			ret.channel_load_threads = std::max<uint16_t>(config.get<uint16_t>("channel_load_threads", ret.channel_load_threads), 1);
+			ret.client_send_queue_limit = config.get<uint32_t>("client_send_queue_limit", ret.client_send_queue_limit);
+			ret.packet_stats_interval = config.get<uint32_t>("packet_stats_interval", ret.packet_stats_interval);
+			ret.capture_client_packets = config.get<bool>("capture_client_packets", false);
+			ret.replay_captures = config.get<bool>("replay_captures", false);
+			ret.preload_all_maps = config.get<bool>("preload_all_maps", false);
+			ret.preload_maps = config.get<vector<game_map_id>>("preload_maps", {});
+			ret.map_aoi_radius = std::max<game_coord>(config.get<game_coord>("map_aoi_radius", 0), 0);
 			return ret;
 		}
 	};
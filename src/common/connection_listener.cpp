@@ -53,12 +53,12 @@ void connection_listener::begin_accept() {
 			crypto_iv recv_iv = 0;
 			crypto_iv send_iv = 0;
 			if (!m_config.encrypt) {
-				new_session->start(m_config.ping, make_ref_ptr<packet_transformer>());
+				new_session->start(m_config.ping, make_ref_ptr<packet_transformer>(), m_config.send_queue_limit);
 			}
 			else {
 				recv_iv = vana::util::randomizer::rand<crypto_iv>();
 				send_iv = vana::util::randomizer::rand<crypto_iv>();
-				new_session->start(m_config.ping, make_ref_ptr<encrypted_packet_transformer>(recv_iv, send_iv));
+				new_session->start(m_config.ping, make_ref_ptr<encrypted_packet_transformer>(recv_iv, send_iv), m_config.send_queue_limit);
 			}
 
 			new_session->send(
@@ -31,6 +31,7 @@ namespace vana {
 		string subversion;
 		connection_port port;
 		ip::type ip_type;
+		size_t send_queue_limit;
 
 		connection_listener_config(
 			const config::ping &ping,
@@ -38,13 +39,15 @@ namespace vana {
 			connection_type type,
 			string subversion,
 			connection_port port,
-			ip::type ip_type) :
+			ip::type ip_type,
+			size_t send_queue_limit = 0) :
 			ping{ping},
 			encrypt{encrypt},
 			type{type},
 			subversion{subversion},
 			port{port},
-			ip_type{ip_type}
+			ip_type{ip_type},
+			send_queue_limit{send_queue_limit}
 		{
 		}
 	};
@@ -37,7 +37,7 @@ connection_manager::~connection_manager() {
 	// m_work.reset() needs to be a pre-wait hook and in the destructor for the cases where the thread is never leased (e.g. DB unavailable)
 	// Doing this a second time doesn't harm an already-reset m_work pointer, so we're in the clear
 	m_work.reset();
-	m_thread.reset();
+	m_threads.clear();
 }
 
 auto connection_manager::listen(const connection_listener_config &config, handler_creator handler_creator) -> void {
@@ -102,7 +102,10 @@ auto connection_manager::connect(const ip &destination, connection_port port, co
 					new_session->set_type(vana::util::misc::get_connection_type(source_type));
 					new_session->start(ping, make_ref_ptr<encrypted_packet_transformer>(recv_iv, send_iv));
 
-					m_sessions.insert(new_session);
+					{
+						owned_lock<mutex> l{m_sessions_mutex};
+						m_sessions.insert(new_session);
+					}
 
 					return std::make_pair(result::success, new_session);
 				}
@@ -122,6 +125,19 @@ auto connection_manager::connect(const ip &destination, connection_port port, co
 	return std::make_pair(result::failure, ref_ptr<session>{nullptr});
 }
 
+auto connection_manager::open_replay_session(const ip &source, handler_creator handler_creator) -> ref_ptr<session> {
+	auto handler = handler_creator();
+	auto new_session = make_ref_ptr<session>(
+		m_io_service,
+		*this,
+		handler);
+
+	start(new_session);
+	new_session->set_type(connection_type::end_user);
+	new_session->start_replay(source);
+	return new_session;
+}
+
 auto connection_manager::stop() -> void {
 	m_stopping = true;
 	for (auto &server : m_servers) {
@@ -129,19 +145,26 @@ auto connection_manager::stop() -> void {
 	}
 	m_servers.clear();
 
-	for (auto &session : m_sessions) {
+	hash_set<ref_ptr<session>> sessions;
+	{
+		owned_lock<mutex> l{m_sessions_mutex};
+		sessions.swap(m_sessions);
+	}
+
+	for (auto &session : sessions) {
 		session->disconnect();
 	}
-	m_sessions.clear();
 }
 
 auto connection_manager::stop(ref_ptr<session> session) -> void {
 	if (m_stopping) return;
+	owned_lock<mutex> l{m_sessions_mutex};
 	m_sessions.erase(session);
 }
 
 auto connection_manager::start(ref_ptr<session> session) -> void {
 	if (m_stopping) THROW_CODE_EXCEPTION(codepath_invalid_exception);
+	owned_lock<mutex> l{m_sessions_mutex};
 	m_sessions.insert(session);
 }
 
@@ -149,10 +172,17 @@ auto connection_manager::get_server() -> abstract_server * {
 	return m_server;
 }
 
-auto connection_manager::run() -> void {
-	m_thread = vana::util::thread_pool::lease(
-		[this] { m_io_service.run(); },
-		[this] { m_work.reset(); });
+auto connection_manager::get_io_service() -> asio::io_service & {
+	return m_io_service;
+}
+
+auto connection_manager::run(uint16_t io_threads) -> void {
+	// Every thread services the same io_service, anything that needs serialization must go through a strand
+	for (uint16_t i = 0; i < io_threads; i++) {
+		m_threads.push_back(vana::util::thread_pool::lease(
+			[this] { m_io_service.run(); },
+			[this] { m_work.reset(); }));
+	}
 }
 
 }
\ No newline at end of file
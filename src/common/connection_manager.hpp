@@ -44,15 +44,19 @@ namespace vana {
 		~connection_manager();
 		auto listen(const connection_listener_config &listener, handler_creator handler_creator) -> void;
 		auto connect(const ip &destination, connection_port port, const config::ping &ping, server_type source_type, handler_creator handler_creator) -> pair<result, ref_ptr<session>>;
-		auto run() -> void;
+		// A client session without a socket that's fed recorded packets, see packet_capture
+		auto open_replay_session(const ip &source, handler_creator handler_creator) -> ref_ptr<session>;
+		auto run(uint16_t io_threads) -> void;
 		auto stop() -> void;
 		auto stop(ref_ptr<session> session) -> void;
 		auto start(ref_ptr<session> session) -> void;
 		auto get_server() -> abstract_server *;
+		auto get_io_service() -> asio::io_service &;
 	private:
 		vector<ref_ptr<connection_listener>> m_servers;
 		hash_set<ref_ptr<session>> m_sessions;
-		ref_ptr<std::thread> m_thread;
+		mutex m_sessions_mutex;
+		vector<ref_ptr<std::thread>> m_threads;
 		owned_ptr<asio::io_service::work> m_work;
 		asio::io_service m_io_service;
 		abstract_server *m_server;
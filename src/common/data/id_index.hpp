@@ -0,0 +1,86 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/types.hpp"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace vana {
+	namespace data {
+		// Immutable game ID => value table for the data providers
+		// Providers gather their rows however is convenient and build one of these once loading is done
+		// Entries live sorted in a single flat block, so lookups are a binary search over contiguous memory
+		// Nothing mutates it after construction, so any number of threads may read it without locking
+		template <typename TKey, typename TValue>
+		class id_index {
+		public:
+			using value_type = pair<TKey, TValue>;
+			using const_iterator = typename vector<value_type>::const_iterator;
+
+			id_index() = default;
+
+			// When a key appears more than once the first entry wins, like the linear scans this replaces
+			explicit id_index(vector<value_type> entries) :
+				m_entries{std::move(entries)}
+			{
+				std::stable_sort(std::begin(m_entries), std::end(m_entries), [](const value_type &a, const value_type &b) {
+					return a.first < b.first;
+				});
+
+				auto last = std::unique(std::begin(m_entries), std::end(m_entries), [](const value_type &a, const value_type &b) {
+					return a.first == b.first;
+				});
+
+				m_entries.erase(last, std::end(m_entries));
+				m_entries.shrink_to_fit();
+			}
+
+			explicit id_index(hash_map<TKey, TValue> entries) :
+				id_index{vector<value_type>{std::make_move_iterator(std::begin(entries)), std::make_move_iterator(std::end(entries))}}
+			{
+			}
+
+			auto find(const TKey &key) const -> const TValue * const {
+				auto iter = lower_bound(key);
+				if (iter == std::end(m_entries) || iter->first != key) {
+					return nullptr;
+				}
+				return &iter->second;
+			}
+
+			auto contains(const TKey &key) const -> bool {
+				return find(key) != nullptr;
+			}
+
+			auto size() const -> size_t { return m_entries.size(); }
+			auto empty() const -> bool { return m_entries.empty(); }
+			auto begin() const -> const_iterator { return std::begin(m_entries); }
+			auto end() const -> const_iterator { return std::end(m_entries); }
+		private:
+			auto lower_bound(const TKey &key) const -> const_iterator {
+				return std::lower_bound(std::begin(m_entries), std::end(m_entries), key, [](const value_type &entry, const TKey &key) {
+					return entry.first < key;
+				});
+			}
+
+			vector<value_type> m_entries;
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "loader.hpp"
+#include "common/data/initialize.hpp"
+#include "common/util/time.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace vana {
+namespace data {
+
+auto loader::add(const string &name, function<void()> load, init_list<string> dependencies) -> loader & {
+	task value;
+	value.name = name;
+	value.load = load;
+	value.dependencies = dependencies;
+	m_tasks.push_back(value);
+	return *this;
+}
+
+auto loader::run() -> void {
+	time_point start_time = vana::util::time::get_now();
+
+	hash_map<string, size_t> indices;
+	for (size_t i = 0; i < m_tasks.size(); i++) {
+		if (!indices.emplace(m_tasks[i].name, i).second) {
+			THROW_CODE_EXCEPTION(codepath_invalid_exception);
+		}
+	}
+
+	vector<size_t> waiting_on(m_tasks.size(), 0);
+	vector<vector<size_t>> dependents(m_tasks.size());
+	for (size_t i = 0; i < m_tasks.size(); i++) {
+		for (const auto &dependency : m_tasks[i].dependencies) {
+			auto kvp = indices.find(dependency);
+			if (kvp != std::end(indices)) {
+				dependents[kvp->second].push_back(i);
+				waiting_on[i]++;
+			}
+		}
+	}
+
+	queue<size_t> ready;
+	for (size_t i = 0; i < m_tasks.size(); i++) {
+		if (waiting_on[i] == 0) {
+			ready.push_back(i);
+		}
+	}
+
+	// Loading is dominated by waiting on the database, so there's no reason to stop at one thread per core on small machines
+	size_t max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 4);
+	size_t running = 0;
+	size_t completed = 0;
+	vector<size_t> finished;
+	std::exception_ptr failure;
+	vector<std::thread> threads;
+	mutex lock_mutex;
+	std::condition_variable finished_condition;
+
+	owned_lock<mutex> lock{lock_mutex};
+	while (completed < m_tasks.size()) {
+		while (failure == nullptr && !ready.empty() && running < max_threads) {
+			size_t index = ready.front();
+			ready.pop_front();
+			running++;
+
+			threads.emplace_back([&, index] {
+				const task &current = m_tasks[index];
+				time_point task_start = vana::util::time::get_now();
+				std::exception_ptr error;
+				try {
+					current.load();
+				}
+				catch (...) {
+					error = std::current_exception();
+				}
+				auto loading_time = vana::util::time::get_distance<milliseconds>(vana::util::time::get_now(), task_start);
+
+				owned_lock<mutex> l{lock_mutex};
+				std::cout << std::setw(vana::data::initialize::output_width) << std::left << ("Initializing " + current.name + "... ");
+				if (error == nullptr) {
+					std::cout << "DONE in " << std::setprecision(3) << loading_time / 1000.f << " seconds" << std::endl;
+				}
+				else {
+					std::cout << "FAILED" << std::endl;
+					if (failure == nullptr) {
+						failure = error;
+					}
+				}
+
+				finished.push_back(index);
+				finished_condition.notify_one();
+			});
+		}
+
+		if (running == 0) {
+			// Either something failed and there's nothing left to wait for, or the remaining providers depend on each other
+			break;
+		}
+
+		finished_condition.wait(lock, [&finished] { return !finished.empty(); });
+		for (const auto &index : finished) {
+			running--;
+			completed++;
+			for (const auto &dependent : dependents[index]) {
+				if (--waiting_on[dependent] == 0) {
+					ready.push_back(dependent);
+				}
+			}
+		}
+		finished.clear();
+	}
+	lock.unlock();
+
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	if (failure != nullptr) {
+		std::rethrow_exception(failure);
+	}
+	if (completed < m_tasks.size()) {
+		THROW_CODE_EXCEPTION(codepath_invalid_exception);
+	}
+
+	auto loading_time = vana::util::time::get_distance<milliseconds>(vana::util::time::get_now(), start_time);
+	std::cout << "Loaded " << m_tasks.size() << " data providers in " << std::setprecision(3) << loading_time / 1000.f << " seconds" << std::endl;
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/types.hpp"
+#include <string>
+#include <vector>
+
+namespace vana {
+	namespace data {
+		// Loads data providers concurrently, each on its own thread with its own MCDB session
+		// A provider starts as soon as every provider it depends on has finished
+		class loader {
+			NONCOPYABLE(loader);
+		public:
+			loader() = default;
+
+			// Dependencies that aren't part of this run (e.g. a single provider being reloaded) are assumed to be loaded already
+			auto add(const string &name, function<void()> load, init_list<string> dependencies = {}) -> loader &;
+			// Blocks until everything is loaded and prints how long each provider took
+			// If any provider throws, nothing else is started and the first exception is rethrown
+			auto run() -> void;
+		private:
+			struct task {
+				string name;
+				function<void()> load;
+				vector<string> dependencies;
+			};
+
+			vector<task> m_tasks;
+		};
+	}
+}
\ No newline at end of file
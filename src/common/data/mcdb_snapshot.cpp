@@ -0,0 +1,424 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "mcdb_snapshot.hpp"
+#include "common/abstract_server.hpp"
+#include "common/data/initialize.hpp"
+#include "common/data/table.hpp"
+#include "common/io/database.hpp"
+#include "common/lua/config_file.hpp"
+#ifdef WIN32
+#include <Windows.h>
+#endif
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+
+namespace vana {
+namespace data {
+namespace mcdb {
+
+namespace {
+
+const char snapshot_magic[8] = {'V', 'A', 'N', 'A', 'M', 'C', 'D', 'B'};
+// Bump whenever the file or block layout changes
+const uint32_t snapshot_format = 1;
+
+struct table_query {
+	string table;
+	string alias;
+	string columns;
+	string join_table;
+	string join;
+	string order_by;
+	string key_column;
+};
+
+struct stamp {
+	int32_t major_version = 0;
+	int32_t minor_version = 0;
+	game_version maple_version = 0;
+	bool test_server = false;
+	string maple_locale;
+};
+
+struct snapshot {
+	hash_map<string, mcdb_table> tables;
+};
+
+ref_ptr<const snapshot> s_snapshot;
+
+auto make_query(const string &table, const string &order_by = "", const string &key_column = "") -> table_query {
+	table_query query;
+	query.table = table;
+	query.columns = "*";
+	query.order_by = order_by;
+	query.key_column = key_column;
+	return query;
+}
+
+auto get_queries() -> const vector<table_query> & {
+	static const vector<table_query> queries = [] {
+		vector<table_query> ret;
+
+		ret.push_back(make_query(vana::data::table::character_creation_data));
+		ret.push_back(make_query(vana::data::table::character_face_data, "faceid ASC"));
+		ret.push_back(make_query(vana::data::table::character_forbidden_names));
+		ret.push_back(make_query(vana::data::table::character_hair_data, "hairid ASC"));
+		ret.push_back(make_query(vana::data::table::character_skin_data, "skinid ASC"));
+		ret.push_back(make_query(vana::data::table::curse_data));
+		ret.push_back(make_query(vana::data::table::drop_data));
+		ret.push_back(make_query(vana::data::table::drop_global_data));
+		ret.push_back(make_query(vana::data::table::item_consume_data));
+
+		table_query items = make_query(vana::data::table::item_data);
+		items.alias = "id";
+		items.columns = "id.*, s.label";
+		items.join_table = vana::data::table::strings;
+		items.join = "s ON id.itemid = s.objectid AND s.object_type = 'item'";
+		ret.push_back(items);
+
+		// Ugly hack to get the integers instead of scientific notation
+		// Note: This is MySQL's crappy behavior
+		// It displays scientific notation for only very large values, meaning it's wildly inconsistent and hard to parse
+		// We just use the string and send it to a translation function
+		table_query equips = make_query(vana::data::table::item_equip_data);
+		equips.columns = "*, REPLACE(FORMAT(equip_slots + 0, 0), \",\", \"\") AS equip_slot_flags";
+		ret.push_back(equips);
+
+		ret.push_back(make_query(vana::data::table::item_monster_card_map_ranges));
+		ret.push_back(make_query(vana::data::table::item_pet_data));
+		ret.push_back(make_query(vana::data::table::item_pet_interactions));
+		ret.push_back(make_query(vana::data::table::item_random_morphs));
+		ret.push_back(make_query(vana::data::table::item_reward_data));
+		ret.push_back(make_query(vana::data::table::item_scroll_data));
+		ret.push_back(make_query(vana::data::table::item_skills));
+		ret.push_back(make_query(vana::data::table::item_summons));
+		ret.push_back(make_query(vana::data::table::map_continent_data));
+		ret.push_back(make_query(vana::data::table::map_data));
+		ret.push_back(make_query(vana::data::table::map_footholds, "mapid", "mapid"));
+		ret.push_back(make_query(vana::data::table::map_life, "mapid", "mapid"));
+		ret.push_back(make_query(vana::data::table::map_portals, "mapid", "mapid"));
+		ret.push_back(make_query(vana::data::table::map_seats, "mapid", "mapid"));
+		ret.push_back(make_query(vana::data::table::map_time_mob, "mapid", "mapid"));
+		ret.push_back(make_query(vana::data::table::mob_attacks));
+		ret.push_back(make_query(vana::data::table::mob_data));
+		ret.push_back(make_query(vana::data::table::mob_skills));
+		ret.push_back(make_query(vana::data::table::mob_summons));
+		ret.push_back(make_query(vana::data::table::monster_card_data));
+		ret.push_back(make_query(vana::data::table::morph_data));
+		ret.push_back(make_query(vana::data::table::npc_data));
+		ret.push_back(make_query(vana::data::table::quest_data));
+		ret.push_back(make_query(vana::data::table::quest_requests));
+		ret.push_back(make_query(vana::data::table::quest_required_jobs));
+		ret.push_back(make_query(vana::data::table::quest_rewards));
+		ret.push_back(make_query(vana::data::table::reactor_data));
+		ret.push_back(make_query(vana::data::table::reactor_event_trigger_skills));
+		ret.push_back(make_query(vana::data::table::reactor_events, "reactorId, state ASC"));
+		ret.push_back(make_query(vana::data::table::scripts));
+		ret.push_back(make_query(vana::data::table::shop_data));
+		ret.push_back(make_query(vana::data::table::shop_items, "shopid, sort DESC"));
+		ret.push_back(make_query(vana::data::table::shop_recharge_data));
+		ret.push_back(make_query(vana::data::table::skill_mob_banish_data));
+		ret.push_back(make_query(vana::data::table::skill_mob_data));
+		ret.push_back(make_query(vana::data::table::skill_mob_summons));
+		ret.push_back(make_query(vana::data::table::skill_player_data));
+		ret.push_back(make_query(vana::data::table::skill_player_level_data));
+		ret.push_back(make_query(vana::data::table::user_drop_data, "dropperid"));
+		ret.push_back(make_query(vana::data::table::user_shop_data));
+		ret.push_back(make_query(vana::data::table::user_shop_items, "shopid, sort DESC"));
+
+		return ret;
+	}();
+	return queries;
+}
+
+auto find_query(const string &table) -> table_query {
+	for (const auto &query : get_queries()) {
+		if (query.table == table) {
+			return query;
+		}
+	}
+	return make_query(table);
+}
+
+auto build_sql(vana::io::database &db, const table_query &query, bool keyed) -> string {
+	out_stream sql;
+	sql << "SELECT " << query.columns << " FROM " << db.make_table(query.table);
+	if (!query.alias.empty()) {
+		sql << " " << query.alias;
+	}
+	if (!query.join_table.empty()) {
+		sql << " LEFT JOIN " << db.make_table(query.join_table) << " " << query.join;
+	}
+	if (keyed) {
+		sql << " WHERE " << query.key_column << " = :key";
+	}
+	if (!query.order_by.empty()) {
+		sql << " ORDER BY " << query.order_by;
+	}
+	return sql.str();
+}
+
+auto get_snapshot_path() -> string {
+	auto config = lua::config_file::get_database_config();
+	config->run();
+	return config->get<string>("mcdb_snapshot", "");
+}
+
+auto read_stamp() -> stamp {
+	auto &db = vana::io::database::get_data_db();
+	auto &sql = db.get_session();
+	soci::row row;
+	sql.once << "SELECT * FROM " << db.make_table(vana::data::table::mcdb_info), soci::into(row);
+
+	stamp ret;
+	ret.major_version = row.get<int32_t>("version");
+	ret.minor_version = row.get<int32_t>("subversion");
+	ret.maple_version = row.get<game_version>("maple_version");
+	ret.test_server = row.get<bool>("test_server");
+	ret.maple_locale = row.get<string>("maple_locale");
+	return ret;
+}
+
+template <typename TValue>
+auto append(vector<char> &out, TValue value) -> void {
+	const char *bytes = reinterpret_cast<const char *>(&value);
+	out.insert(std::end(out), bytes, bytes + sizeof(value));
+}
+
+template <typename TValue>
+auto read(const vector<char> &buffer, size_t &offset) -> TValue {
+	if (offset + sizeof(TValue) > buffer.size()) {
+		throw std::out_of_range{"MCDB snapshot is truncated"};
+	}
+
+	TValue value;
+	std::memcpy(&value, buffer.data() + offset, sizeof(value));
+	offset += sizeof(value);
+	return value;
+}
+
+auto append_string(vector<char> &out, const string &value) -> void {
+	append<uint16_t>(out, static_cast<uint16_t>(value.size()));
+	out.insert(std::end(out), std::begin(value), std::end(value));
+}
+
+auto read_string(const vector<char> &buffer, size_t &offset) -> string {
+	uint16_t length = read<uint16_t>(buffer, offset);
+	if (offset + length > buffer.size()) {
+		throw std::out_of_range{"MCDB snapshot is truncated"};
+	}
+
+	string value{buffer.data() + offset, length};
+	offset += length;
+	return value;
+}
+
+auto append_header(vector<char> &out, const stamp &current) -> void {
+	out.insert(std::end(out), std::begin(snapshot_magic), std::end(snapshot_magic));
+	append<uint32_t>(out, snapshot_format);
+	append<int32_t>(out, current.major_version);
+	append<int32_t>(out, current.minor_version);
+	append<game_version>(out, current.maple_version);
+	append<uint8_t>(out, current.test_server ? 1 : 0);
+	append_string(out, current.maple_locale);
+}
+
+// Returns whether the header describes a snapshot of the current MCDB, the offset is left just past the header
+auto read_header(const vector<char> &buffer, size_t &offset, const stamp &current) -> bool {
+	if (buffer.size() < sizeof(snapshot_magic) || std::memcmp(buffer.data(), snapshot_magic, sizeof(snapshot_magic)) != 0) {
+		return false;
+	}
+
+	offset = sizeof(snapshot_magic);
+	if (read<uint32_t>(buffer, offset) != snapshot_format) return false;
+	if (read<int32_t>(buffer, offset) != current.major_version) return false;
+	if (read<int32_t>(buffer, offset) != current.minor_version) return false;
+	if (read<game_version>(buffer, offset) != current.maple_version) return false;
+	if ((read<uint8_t>(buffer, offset) != 0) != current.test_server) return false;
+	if (read_string(buffer, offset) != current.maple_locale) return false;
+	return true;
+}
+
+auto read_file(const string &path, vector<char> &out) -> bool {
+	std::ifstream file{path, std::ios::binary | std::ios::ate};
+	if (!file) {
+		return false;
+	}
+
+	std::streamoff size = file.tellg();
+	file.seekg(0, std::ios::beg);
+	out.resize(static_cast<size_t>(size));
+	return static_cast<bool>(file.read(out.data(), size));
+}
+
+}
+
+auto compile_snapshot(abstract_server *server) -> void {
+	string path = get_snapshot_path();
+	if (path.empty()) {
+		return;
+	}
+
+	try {
+		stamp current = read_stamp();
+
+		vector<char> existing;
+		size_t offset = 0;
+		if (read_file(path, existing) && read_header(existing, offset, current)) {
+			return;
+		}
+		existing.clear();
+		existing.shrink_to_fit();
+
+		std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Compiling MCDB Snapshot... ";
+
+		auto &db = vana::io::database::get_data_db();
+		auto &sql = db.get_session();
+
+		vector<char> out;
+		append_header(out, current);
+		append<uint32_t>(out, static_cast<uint32_t>(get_queries().size()));
+
+		for (const auto &query : get_queries()) {
+			append_string(out, query.table);
+			size_t size_offset = out.size();
+			append<uint64_t>(out, 0);
+
+			soci::rowset<> rs = (sql.prepare << build_sql(db, query, false));
+			mcdb_table::compile(rs, out);
+
+			uint64_t block_size = out.size() - size_offset - sizeof(uint64_t);
+			std::memcpy(out.data() + size_offset, &block_size, sizeof(block_size));
+		}
+
+		// Channels may be reading the old file, so the new one only replaces it once it's complete
+		string temp_path = path + ".tmp";
+		{
+			std::ofstream file{temp_path, std::ios::binary | std::ios::trunc};
+			file.write(out.data(), out.size());
+			if (!file) {
+				throw std::runtime_error{"unable to write " + temp_path};
+			}
+		}
+
+		// Replaced in one step so there's never a moment without a snapshot file
+#ifdef WIN32
+		bool replaced = MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+		bool replaced = std::rename(temp_path.c_str(), path.c_str()) == 0;
+#endif
+		if (!replaced) {
+			std::remove(temp_path.c_str());
+			throw std::runtime_error{"unable to replace " + path};
+		}
+
+		std::cout << "DONE" << std::endl;
+	}
+	catch (std::exception &e) {
+		std::cout << "FAILED" << std::endl;
+		server->log(vana::log::type::warning, [&](out_stream &log) {
+			log << "Unable to compile the MCDB snapshot, servers will load from SQL: " << e.what();
+		});
+	}
+}
+
+auto load_snapshot(abstract_server *server) -> void {
+	string path = get_snapshot_path();
+	if (path.empty()) {
+		return;
+	}
+
+	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Loading MCDB Snapshot... ";
+
+	try {
+		auto buffer = make_ref_ptr<vector<char>>();
+		if (!read_file(path, *buffer)) {
+			std::cout << "MISSING" << std::endl;
+			return;
+		}
+
+		size_t offset = 0;
+		if (!read_header(*buffer, offset, read_stamp())) {
+			std::cout << "STALE" << std::endl;
+			server->log(vana::log::type::warning, "The MCDB snapshot does not match the MCDB version, loading from SQL. Restart the LoginServer to recompile it.");
+			return;
+		}
+
+		auto loaded = make_ref_ptr<snapshot>();
+
+		uint32_t table_count = read<uint32_t>(*buffer, offset);
+		for (uint32_t i = 0; i < table_count; i++) {
+			string table = read_string(*buffer, offset);
+			uint64_t block_size = read<uint64_t>(*buffer, offset);
+			loaded->tables.emplace(table, mcdb_table::parse(buffer, offset));
+			offset += static_cast<size_t>(block_size);
+		}
+
+		std::atomic_store(&s_snapshot, ref_ptr<const snapshot>{loaded});
+		std::cout << "DONE" << std::endl;
+	}
+	catch (std::exception &e) {
+		std::cout << "FAILED" << std::endl;
+		server->log(vana::log::type::warning, [&](out_stream &log) {
+			log << "Unable to load the MCDB snapshot, loading from SQL: " << e.what();
+		});
+	}
+}
+
+auto discard_snapshot() -> void {
+	std::atomic_store(&s_snapshot, ref_ptr<const snapshot>{});
+}
+
+auto select(const string &table) -> mcdb_table {
+	if (auto loaded = std::atomic_load(&s_snapshot)) {
+		auto kvp = loaded->tables.find(table);
+		if (kvp != std::end(loaded->tables)) {
+			return kvp->second;
+		}
+	}
+
+	auto &db = vana::io::database::get_data_db();
+	auto &sql = db.get_session();
+	soci::rowset<> rs = (sql.prepare << build_sql(db, find_query(table), false));
+	return mcdb_table::from_rowset(rs);
+}
+
+auto select(const string &table, int32_t key) -> mcdb_table {
+	table_query query = find_query(table);
+
+	if (auto loaded = std::atomic_load(&s_snapshot)) {
+		auto kvp = loaded->tables.find(table);
+		if (kvp != std::end(loaded->tables)) {
+			return kvp->second.equal_range(query.key_column, key);
+		}
+	}
+
+	auto &db = vana::io::database::get_data_db();
+	auto &sql = db.get_session();
+	soci::rowset<> rs = (sql.prepare << build_sql(db, query, true), soci::use(key, "key"));
+	return mcdb_table::from_rowset(rs);
+}
+
+}
+}
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/data/mcdb_table.hpp"
+#include "common/data/table.hpp"
+#include "common/types.hpp"
+#include <string>
+
+namespace vana {
+	class abstract_server;
+
+	namespace data {
+		// The providers read MCDB through here instead of issuing queries themselves
+		// When a snapshot matching the MCDB version is loaded, tables come straight out of it
+		// Otherwise, or for tables it doesn't have, the same query the snapshot was compiled from runs against SQL
+		namespace mcdb {
+			// Writes every table the providers use to the configured snapshot file unless it's already current
+			auto compile_snapshot(abstract_server *server) -> void;
+			auto load_snapshot(abstract_server *server) -> void;
+			// Reloads exist to pick up edits made to the database, so they must not be served from the snapshot
+			auto discard_snapshot() -> void;
+
+			auto select(const string &table) -> mcdb_table;
+			// Only rows whose key column (e.g. mapid) matches
+			auto select(const string &table, int32_t key) -> mcdb_table;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,242 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "mcdb_table.hpp"
+#include <ctime>
+#include <typeinfo>
+
+namespace vana {
+namespace data {
+
+namespace {
+
+template <typename TValue>
+auto append(vector<char> &out, TValue value) -> void {
+	const char *bytes = reinterpret_cast<const char *>(&value);
+	out.insert(std::end(out), bytes, bytes + sizeof(value));
+}
+
+template <typename TValue>
+auto overwrite(vector<char> &out, size_t offset, TValue value) -> void {
+	std::memcpy(out.data() + offset, &value, sizeof(value));
+}
+
+template <typename TValue>
+auto read(const vector<char> &buffer, size_t &offset) -> TValue {
+	if (offset + sizeof(TValue) > buffer.size()) {
+		throw std::out_of_range{"MCDB table block is truncated"};
+	}
+
+	TValue value;
+	std::memcpy(&value, buffer.data() + offset, sizeof(value));
+	offset += sizeof(value);
+	return value;
+}
+
+auto get_column_type(soci::data_type type) -> mcdb_column_type {
+	switch (type) {
+		case soci::dt_double: return mcdb_column_type::floating;
+		case soci::dt_string: return mcdb_column_type::text;
+		default: return mcdb_column_type::integer;
+	}
+}
+
+}
+
+auto mcdb_table::compile(soci::rowset<> &rows, vector<char> &out) -> void {
+	vector<mcdb_column_type> types;
+	vector<uint8_t> nulls;
+	vector<char> cells;
+	vector<char> heap;
+	uint32_t row_count = 0;
+
+	size_t header_offset = out.size();
+	append<uint32_t>(out, 0);
+
+	for (const auto &row : rows) {
+		if (row_count == 0) {
+			// SOCI only describes the columns once there's a row to describe
+			for (size_t i = 0; i < row.size(); i++) {
+				const auto &properties = row.get_properties(i);
+				const string &name = properties.get_name();
+				types.push_back(get_column_type(properties.get_data_type()));
+				append<uint8_t>(out, static_cast<uint8_t>(types.back()));
+				append<uint16_t>(out, static_cast<uint16_t>(name.size()));
+				out.insert(std::end(out), std::begin(name), std::end(name));
+			}
+			overwrite<uint32_t>(out, header_offset, static_cast<uint32_t>(types.size()));
+		}
+
+		for (size_t i = 0; i < types.size(); i++) {
+			bool is_null = row.get_indicator(i) == soci::i_null;
+			nulls.push_back(is_null ? 1 : 0);
+			if (is_null) {
+				append<int64_t>(cells, 0);
+				continue;
+			}
+
+			switch (types[i]) {
+				case mcdb_column_type::floating:
+					append<double>(cells, row.get<double>(i));
+					break;
+				case mcdb_column_type::text: {
+					string value = row.get<string>(i);
+					append<uint32_t>(cells, static_cast<uint32_t>(heap.size()));
+					append<uint32_t>(cells, static_cast<uint32_t>(value.size()));
+					heap.insert(std::end(heap), std::begin(value), std::end(value));
+					break;
+				}
+				case mcdb_column_type::integer: {
+					int64_t value = 0;
+					switch (row.get_properties(i).get_data_type()) {
+						case soci::dt_integer: value = row.get<int32_t>(i); break;
+						case soci::dt_long_long: value = row.get<int64_t>(i); break;
+						case soci::dt_unsigned_long_long: value = static_cast<int64_t>(row.get<unsigned long long>(i)); break;
+						case soci::dt_date: {
+							std::tm time = row.get<std::tm>(i);
+							value = static_cast<int64_t>(std::mktime(&time));
+							break;
+						}
+						default: break;
+					}
+					append<int64_t>(cells, value);
+					break;
+				}
+			}
+		}
+
+		row_count++;
+	}
+
+	append<uint32_t>(out, row_count);
+	append<uint32_t>(out, static_cast<uint32_t>(heap.size()));
+	out.insert(std::end(out), std::begin(nulls), std::end(nulls));
+	out.insert(std::end(out), std::begin(cells), std::end(cells));
+	out.insert(std::end(out), std::begin(heap), std::end(heap));
+}
+
+auto mcdb_table::parse(ref_ptr<const vector<char>> buffer, size_t offset) -> mcdb_table {
+	auto table = make_ref_ptr<layout>();
+	table->buffer = buffer;
+
+	uint32_t column_count = read<uint32_t>(*buffer, offset);
+	for (uint32_t i = 0; i < column_count; i++) {
+		table->types.push_back(static_cast<mcdb_column_type>(read<uint8_t>(*buffer, offset)));
+		uint16_t length = read<uint16_t>(*buffer, offset);
+		if (offset + length > buffer->size()) {
+			throw std::out_of_range{"MCDB table block is truncated"};
+		}
+		table->columns.emplace(string{buffer->data() + offset, length}, i);
+		offset += length;
+	}
+
+	uint32_t row_count = read<uint32_t>(*buffer, offset);
+	uint32_t heap_size = read<uint32_t>(*buffer, offset);
+	size_t cell_count = static_cast<size_t>(row_count) * column_count;
+	if (offset + cell_count * 9 + heap_size > buffer->size()) {
+		throw std::out_of_range{"MCDB table block is truncated"};
+	}
+
+	table->nulls = reinterpret_cast<const uint8_t *>(buffer->data() + offset);
+	table->cells = buffer->data() + offset + cell_count;
+	table->heap = table->cells + cell_count * 8;
+
+	return mcdb_table{table, 0, row_count};
+}
+
+auto mcdb_table::from_rowset(soci::rowset<> &rows) -> mcdb_table {
+	auto buffer = make_ref_ptr<vector<char>>();
+	compile(rows, *buffer);
+	return parse(buffer, 0);
+}
+
+auto mcdb_table::equal_range(const string &column, int64_t value) const -> mcdb_table {
+	if (empty()) {
+		return *this;
+	}
+
+	auto get_key = [&](uint32_t index) -> int64_t {
+		return row{m_layout.get(), index}.get<int64_t>(column);
+	};
+
+	uint32_t first = m_first;
+	uint32_t count = m_count;
+	while (count > 0) {
+		uint32_t step = count / 2;
+		if (get_key(first + step) < value) {
+			first += step + 1;
+			count -= step + 1;
+		}
+		else {
+			count = step;
+		}
+	}
+
+	uint32_t last = first;
+	uint32_t end = m_first + m_count;
+	while (last < end && get_key(last) == value) {
+		last++;
+	}
+
+	return mcdb_table{m_layout, first, last - first};
+}
+
+auto mcdb_table::row::get_value(size_t cell, mcdb_column_type type, string *) const -> string {
+	if (is_null(cell)) {
+		return "";
+	}
+	if (type != mcdb_column_type::text) {
+		throw std::bad_cast{};
+	}
+
+	uint32_t offset;
+	uint32_t length;
+	std::memcpy(&offset, m_layout->cells + cell * 8, sizeof(offset));
+	std::memcpy(&length, m_layout->cells + cell * 8 + sizeof(offset), sizeof(length));
+	return string{m_layout->heap + offset, length};
+}
+
+auto mcdb_table::row::get_value(size_t cell, mcdb_column_type type, bool *) const -> bool {
+	return !is_null(cell) && get_integer(cell, type) == 1;
+}
+
+auto mcdb_table::row::get_integer(size_t cell, mcdb_column_type type) const -> int64_t {
+	if (type != mcdb_column_type::integer) {
+		throw std::bad_cast{};
+	}
+
+	int64_t value;
+	std::memcpy(&value, m_layout->cells + cell * 8, sizeof(value));
+	return value;
+}
+
+auto mcdb_table::row::get_cell(const string &column, mcdb_column_type &type) const -> size_t {
+	auto kvp = m_layout->columns.find(column);
+	if (kvp == std::end(m_layout->columns)) {
+		throw std::out_of_range{"Column '" + column + "' not found"};
+	}
+
+	type = m_layout->types[kvp->second];
+	return static_cast<size_t>(m_index) * m_layout->types.size() + kvp->second;
+}
+
+auto mcdb_table::row::is_null(size_t cell) const -> bool {
+	return m_layout->nulls[cell] != 0;
+}
+
+}
+}
\ No newline at end of file
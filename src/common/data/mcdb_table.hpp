@@ -0,0 +1,164 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/soci_extensions.hpp"
+#include "common/types.hpp"
+#include "common/util/optional.hpp"
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace vana {
+	namespace data {
+		enum class mcdb_column_type : uint8_t {
+			integer = 0,
+			floating = 1,
+			text = 2,
+		};
+
+		// Read-only rows of an MCDB table in the snapshot layout
+		// Cells are fixed-width slots read straight out of the buffer, so a table costs the same to read whether it came from SQL or from disk
+		// Layout of a block:
+		// u32 column count, then each column as u8 type, u16 name length, name
+		// u32 row count, u32 string heap size
+		// row count * column count u8 null flags
+		// row count * column count 8 byte cells, integers and doubles inline, strings as u32 offset and u32 length into the heap
+		// String heap
+		class mcdb_table {
+		private:
+			struct layout;
+		public:
+			class row {
+			public:
+				template <typename TValue>
+				auto get(const string &column) const -> TValue;
+			private:
+				friend class mcdb_table;
+				row(const layout *table_layout, uint32_t index) : m_layout{table_layout}, m_index{index} { }
+
+				template <typename TValue>
+				auto get_value(size_t cell, mcdb_column_type type, TValue *) const -> TValue;
+				template <typename TValue>
+				auto get_value(size_t cell, mcdb_column_type type, optional<TValue> *) const -> optional<TValue>;
+				auto get_value(size_t cell, mcdb_column_type type, string *) const -> string;
+				auto get_value(size_t cell, mcdb_column_type type, bool *) const -> bool;
+				auto get_integer(size_t cell, mcdb_column_type type) const -> int64_t;
+				auto get_cell(const string &column, mcdb_column_type &type) const -> size_t;
+				auto is_null(size_t cell) const -> bool;
+
+				const layout *m_layout;
+				uint32_t m_index;
+			};
+
+			class const_iterator : public std::iterator<std::forward_iterator_tag, row> {
+			public:
+				auto operator*() const -> row { return row{m_layout, m_index}; }
+				auto operator++() -> const_iterator & { ++m_index; return *this; }
+				auto operator==(const const_iterator &other) const -> bool { return m_index == other.m_index; }
+				auto operator!=(const const_iterator &other) const -> bool { return m_index != other.m_index; }
+			private:
+				friend class mcdb_table;
+				const_iterator(const layout *table_layout, uint32_t index) : m_layout{table_layout}, m_index{index} { }
+
+				const layout *m_layout;
+				uint32_t m_index;
+			};
+
+			mcdb_table() = default;
+
+			// Runs the query and packs every row into a block
+			static auto compile(soci::rowset<> &rows, vector<char> &out) -> void;
+			// Reads the block at offset, which must stay alive as long as the table does
+			static auto parse(ref_ptr<const vector<char>> buffer, size_t offset) -> mcdb_table;
+			static auto from_rowset(soci::rowset<> &rows) -> mcdb_table;
+
+			// Rows whose integer key column is equal to value, the table must be sorted by that column
+			auto equal_range(const string &column, int64_t value) const -> mcdb_table;
+
+			auto size() const -> size_t { return m_count; }
+			auto empty() const -> bool { return m_count == 0; }
+			auto begin() const -> const_iterator { return const_iterator{m_layout.get(), m_first}; }
+			auto end() const -> const_iterator { return const_iterator{m_layout.get(), m_first + m_count}; }
+		private:
+			struct layout {
+				ref_ptr<const vector<char>> buffer;
+				vector<mcdb_column_type> types;
+				hash_map<string, uint32_t> columns;
+				const uint8_t *nulls = nullptr;
+				const char *cells = nullptr;
+				const char *heap = nullptr;
+			};
+
+			mcdb_table(ref_ptr<const layout> table_layout, uint32_t first, uint32_t count) :
+				m_layout{table_layout},
+				m_first{first},
+				m_count{count}
+			{
+			}
+
+			ref_ptr<const layout> m_layout;
+			uint32_t m_first = 0;
+			uint32_t m_count = 0;
+		};
+
+		template <typename TValue>
+		auto mcdb_table::row::get(const string &column) const -> TValue {
+			mcdb_column_type type;
+			size_t cell = get_cell(column, type);
+			return get_value(cell, type, static_cast<TValue *>(nullptr));
+		}
+
+		template <typename TValue>
+		auto mcdb_table::row::get_value(size_t cell, mcdb_column_type type, TValue *) const -> TValue {
+			static_assert(std::is_arithmetic<TValue>::value, "TValue must be arithmetic, bool, string, or optional");
+
+			// Mirrors the SOCI conversions, NULL turns into 0
+			if (is_null(cell)) {
+				return TValue{};
+			}
+
+			if (type == mcdb_column_type::floating) {
+				double value;
+				std::memcpy(&value, m_layout->cells + cell * 8, sizeof(value));
+				return static_cast<TValue>(value);
+			}
+
+			int64_t value = get_integer(cell, type);
+			if (std::is_integral<TValue>::value) {
+				if (value < static_cast<int64_t>((std::numeric_limits<TValue>::min)()) ||
+					(value > 0 && static_cast<uint64_t>(value) > static_cast<uint64_t>((std::numeric_limits<TValue>::max)()))) {
+					throw std::out_of_range{"Value outside of allowed range"};
+				}
+			}
+			return static_cast<TValue>(value);
+		}
+
+		template <typename TValue>
+		auto mcdb_table::row::get_value(size_t cell, mcdb_column_type type, optional<TValue> *) const -> optional<TValue> {
+			if (is_null(cell)) {
+				return optional<TValue>{};
+			}
+			return get_value(cell, type, static_cast<TValue *>(nullptr));
+		}
+	}
+}
\ No newline at end of file
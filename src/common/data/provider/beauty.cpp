@@ -18,13 +18,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "beauty.hpp"
 #include "common/algorithm.hpp"
 #include "common/constant/gender.hpp"
-#include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/util/game_logic/player.hpp"
 #include "common/util/randomizer.hpp"
 #include <algorithm>
-#include <iomanip>
-#include <iostream>
 
 namespace vana {
 namespace data {
@@ -41,26 +38,17 @@ auto beauty::load_data() -> void {
 }
 
 auto beauty::load_skins() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Skins... ";
 	m_skins.clear();
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::character_skin_data) << " ORDER BY skinid ASC");
+	auto rs = mcdb::select(vana::data::table::character_skin_data);
 
 	for (const auto &row : rs) {
 		m_skins.push_back(row.get<game_skin_id>("skinid"));
 	}
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto beauty::load_hair() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Hair... ";
-
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::character_hair_data) << " ORDER BY hairid ASC");
+	auto rs = mcdb::select(vana::data::table::character_hair_data);
 
 	for (const auto &row : rs) {
 		game_gender_id gender_id = vana::util::game_logic::player::get_gender_id(row.get<string>("gender"));
@@ -68,16 +56,10 @@ auto beauty::load_hair() -> void {
 		auto &gender = gender_id == constant::gender::female ? m_female : m_male;
 		gender.hair.push_back(hair);
 	}
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto beauty::load_faces() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Faces... ";
-
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::character_face_data) << " ORDER BY faceid ASC");
+	auto rs = mcdb::select(vana::data::table::character_face_data);
 
 	for (const auto &row : rs) {
 		game_gender_id gender_id = vana::util::game_logic::player::get_gender_id(row.get<string>("gender"));
@@ -85,8 +67,6 @@ auto beauty::load_faces() -> void {
 		auto &gender = gender_id == constant::gender::female ? m_female : m_male;
 		gender.faces.push_back(face);
 	}
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto beauty::get_random_skin() const -> game_skin_id {
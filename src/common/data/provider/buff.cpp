@@ -19,28 +19,26 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common/algorithm.hpp"
 #include "common/constant/mob_skill.hpp"
 #include "common/constant/skill.hpp"
-#include "common/data/initialize.hpp"
 #include "common/data/provider/item.hpp"
 #include "common/data/type/buff_source.hpp"
-#include <iomanip>
-#include <iostream>
 
 namespace vana {
 namespace data {
 namespace provider {
 
-auto buff::process_skills(data::type::buff value, const init_list<game_skill_id> &skills) -> void {
-	for (const auto &skill_id : skills) {
-		for (const auto &existing : m_buffs) {
-			if (existing.first == skill_id) throw std::invalid_argument{"skill is already present"};
-		}
+auto buff::load_data() -> void {
+	vector<pair<game_skill_id, data::type::buff>> buffs;
+	vector<pair<game_mob_skill_id, data::type::buff>> mob_skill_info;
 
-		m_buffs.emplace_back(skill_id, value);
-	}
-}
+	auto process_skills = [&buffs](data::type::buff value, const init_list<game_skill_id> &skills) {
+		for (const auto &skill_id : skills) {
+			for (const auto &existing : buffs) {
+				if (existing.first == skill_id) throw std::invalid_argument{"skill is already present"};
+			}
 
-auto buff::load_data() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Buffs... ";
+			buffs.emplace_back(skill_id, value);
+		}
+	};
 
 	auto physical_attack = data::type::buff_info::from_player_only(1, data::type::buff_skill_value::watk);
 	auto physical_defense = data::type::buff_info::from_player_only(2, data::type::buff_skill_value::wdef);
@@ -591,16 +589,19 @@ auto buff::load_data() -> void {
 			constant::skill::corsair::battleship,
 		});
 
-	m_mob_skill_info.emplace_back(constant::mob_skill::stun, data::type::buff{stun});
-	m_mob_skill_info.emplace_back(constant::mob_skill::poison, data::type::buff{poison});
-	m_mob_skill_info.emplace_back(constant::mob_skill::seal, data::type::buff{seal});
-	m_mob_skill_info.emplace_back(constant::mob_skill::darkness, data::type::buff{darkness});
-	m_mob_skill_info.emplace_back(constant::mob_skill::weakness, data::type::buff{weakness});
-	m_mob_skill_info.emplace_back(constant::mob_skill::curse, data::type::buff{curse});
-	m_mob_skill_info.emplace_back(constant::mob_skill::slow, data::type::buff{slow});
-	m_mob_skill_info.emplace_back(constant::mob_skill::seduce, data::type::buff{seduce});
-	m_mob_skill_info.emplace_back(constant::mob_skill::crazy_skull, data::type::buff{crazy_skull});
-	m_mob_skill_info.emplace_back(constant::mob_skill::zombify, data::type::buff{zombify});
+	mob_skill_info.emplace_back(constant::mob_skill::stun, data::type::buff{stun});
+	mob_skill_info.emplace_back(constant::mob_skill::poison, data::type::buff{poison});
+	mob_skill_info.emplace_back(constant::mob_skill::seal, data::type::buff{seal});
+	mob_skill_info.emplace_back(constant::mob_skill::darkness, data::type::buff{darkness});
+	mob_skill_info.emplace_back(constant::mob_skill::weakness, data::type::buff{weakness});
+	mob_skill_info.emplace_back(constant::mob_skill::curse, data::type::buff{curse});
+	mob_skill_info.emplace_back(constant::mob_skill::slow, data::type::buff{slow});
+	mob_skill_info.emplace_back(constant::mob_skill::seduce, data::type::buff{seduce});
+	mob_skill_info.emplace_back(constant::mob_skill::crazy_skull, data::type::buff{crazy_skull});
+	mob_skill_info.emplace_back(constant::mob_skill::zombify, data::type::buff{zombify});
+
+	m_buffs = id_index<game_skill_id, data::type::buff>{std::move(buffs)};
+	m_mob_skill_info = id_index<game_mob_skill_id, data::type::buff>{std::move(mob_skill_info)};
 
 	m_basics.physical_attack = physical_attack;
 	m_basics.physical_defense = physical_defense;
@@ -663,11 +664,21 @@ auto buff::load_data() -> void {
 	m_basics.mount = mount;
 	m_basics.speed_infusion = speed_infusion;
 	m_basics.homing_beacon = homing_beacon;
+}
+
+auto buff::load_item_info(const id_index<game_item_id, data::type::consume_info> &consumes) -> void {
+	vector<pair<game_item_id, data::type::buff>> items;
+	for (const auto &kvp : consumes) {
+		auto values = get_item_buffs(kvp.second);
+		if (values.size() > 0) {
+			items.emplace_back(kvp.first, data::type::buff{values});
+		}
+	}
 
-	std::cout << "DONE" << std::endl;
+	m_items = id_index<game_item_id, data::type::buff>{std::move(items)};
 }
 
-auto buff::add_item_info(game_item_id item_id, const data::type::consume_info &cons) -> void {
+auto buff::get_item_buffs(const data::type::consume_info &cons) const -> vector<data::type::buff_info> {
 	vector<data::type::buff_info> values;
 
 	if (cons.watk > 0) {
@@ -761,40 +772,38 @@ auto buff::add_item_info(game_item_id item_id, const data::type::consume_info &c
 		}
 	}
 
-	if (values.size() > 0) {
-		m_items.emplace_back(item_id, data::type::buff{values});
-	}
+	return values;
 }
 
 auto buff::is_buff(const data::type::buff_source &source) const -> bool {
 	switch (source.get_type()) {
 		case data::type::buff_source_type::skill:
-			return ext::any_of(m_buffs, [&source](auto value) { return source.get_skill_id() == value.first; });
+			return m_buffs.contains(source.get_skill_id());
 
 		case data::type::buff_source_type::mob_skill:
-			return ext::any_of(m_mob_skill_info, [&source](auto value) { return source.get_mob_skill_id() == value.first; });
+			return m_mob_skill_info.contains(source.get_mob_skill_id());
 
 		case data::type::buff_source_type::item:
-			return ext::any_of(m_items, [&source](auto value) { return source.get_item_id() == value.first; });
+			return m_items.contains(source.get_item_id());
 	}
 	THROW_CODE_EXCEPTION(not_implemented_exception, "buff_source_type");
 }
 
 auto buff::is_debuff(const data::type::buff_source &source) const -> bool {
 	if (source.get_type() != data::type::buff_source_type::mob_skill) return false;
-	return ext::any_of(m_mob_skill_info, [&source](auto value) { return source.get_mob_skill_id() == value.first; });
+	return m_mob_skill_info.contains(source.get_mob_skill_id());
 }
 
 auto buff::get_info(const data::type::buff_source &source) const -> const data::type::buff & {
 	switch (source.get_type()) {
 		case data::type::buff_source_type::skill:
-			return ext::find_value_ptr_if(m_buffs, [&source](auto value) { return value.first == source.get_skill_id(); })->second;
+			return *m_buffs.find(source.get_skill_id());
 
 		case data::type::buff_source_type::mob_skill:
-			return ext::find_value_ptr_if(m_mob_skill_info, [&source](auto value) { return value.first == source.get_mob_skill_id(); })->second;
+			return *m_mob_skill_info.find(source.get_mob_skill_id());
 
 		case data::type::buff_source_type::item:
-			return ext::find_value_ptr_if(m_items, [&source](auto value) { return value.first == source.get_item_id(); })->second;
+			return *m_items.find(source.get_item_id());
 	}
 	THROW_CODE_EXCEPTION(not_implemented_exception, "buff_source_type");
 }
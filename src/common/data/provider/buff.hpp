@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "common/data/id_index.hpp"
 #include "common/data/type/buff.hpp"
 #include "common/data/type/buff_info.hpp"
 #include "common/data/type/buff_info_by_effect.hpp"
@@ -35,17 +36,17 @@ namespace vana {
 			class buff {
 			public:
 				auto load_data() -> void;
-				auto add_item_info(game_item_id item_id, const data::type::consume_info &cons) -> void;
+				auto load_item_info(const id_index<game_item_id, data::type::consume_info> &consumes) -> void;
 
 				auto is_buff(const data::type::buff_source &source) const -> bool;
 				auto is_debuff(const data::type::buff_source &source) const -> bool;
 				auto get_info(const data::type::buff_source &source) const -> const data::type::buff &;
 				auto get_buffs_by_effect() const -> const data::type::buff_info_by_effect &;
 			private:
-				auto process_skills(data::type::buff value, const init_list<game_skill_id> &skills) -> void;
-				vector<pair<game_skill_id, data::type::buff>> m_buffs;
-				vector<pair<game_item_id, data::type::buff>> m_items;
-				vector<pair<game_mob_skill_id, data::type::buff>> m_mob_skill_info;
+				auto get_item_buffs(const data::type::consume_info &cons) const -> vector<data::type::buff_info>;
+				id_index<game_skill_id, data::type::buff> m_buffs;
+				id_index<game_item_id, data::type::buff> m_items;
+				id_index<game_mob_skill_id, data::type::buff> m_mob_skill_info;
 				data::type::buff_info_by_effect m_basics;
 			};
 		}
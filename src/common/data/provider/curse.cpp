@@ -17,30 +17,21 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "curse.hpp"
 #include "common/algorithm.hpp"
-#include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/util/string.hpp"
 #include <algorithm>
-#include <iomanip>
-#include <iostream>
 
 namespace vana {
 namespace data {
 namespace provider {
 
 auto curse::load_data() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Curse Info...";
-
 	m_curse_words.clear();
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::curse_data));
+	auto rs = mcdb::select(vana::data::table::curse_data);
 
 	for (const auto &row : rs) {
 		m_curse_words.push_back(row.get<string>("word"));
 	}
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto curse::is_curse_word(const string &cmp) const -> bool {
@@ -17,11 +17,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "drop.hpp"
 #include "common/algorithm.hpp"
-#include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/util/string.hpp"
-#include <iomanip>
-#include <iostream>
 #include <string>
 
 namespace vana {
@@ -29,17 +26,12 @@ namespace data {
 namespace provider {
 
 auto drop::load_data() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Drops... ";
-
 	load_drops();
 	load_global_drops();
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto drop::load_drops() -> void {
-	m_drop_info.clear();
-
+	hash_map<int32_t, vector<data::type::drop_info>> drops;
 	data::type::drop_info info;
 	auto drop_flags = [&info](const opt_string &flags) {
 		vana::util::str::run_flags(flags, [&info](const string &cmp) {
@@ -47,9 +39,7 @@ auto drop::load_drops() -> void {
 		});
 	};
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::drop_data));
+	auto rs = mcdb::select(vana::data::table::drop_data);
 
 	for (const auto &row : rs) {
 		info = data::type::drop_info{};
@@ -62,23 +52,10 @@ auto drop::load_drops() -> void {
 		info.chance = row.get<uint32_t>("chance");
 		drop_flags(row.get<opt_string>("flags"));
 
-		bool found = false;
-		for (auto &drop : m_drop_info) {
-			if (drop.first == dropper) {
-				found = true;
-				drop.second.push_back(info);
-				break;
-			}
-		}
-
-		if (!found) {
-			vector<data::type::drop_info> current;
-			current.push_back(info);
-			m_drop_info.emplace_back(dropper, current);
-		}
+		drops[dropper].push_back(info);
 	}
 
-	rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::user_drop_data) << " ORDER BY dropperid");
+	rs = mcdb::select(vana::data::table::user_drop_data);
 	int32_t last_dropper_id = -1;
 
 	for (const auto &row : rs) {
@@ -92,37 +69,25 @@ auto drop::load_drops() -> void {
 		info.chance = row.get<uint32_t>("chance");
 		drop_flags(row.get<opt_string>("flags"));
 
-		if (dropper != last_dropper_id) {
-			// Check to see if a drop is required
-			bool removed = ext::remove_element_if(
-				m_drop_info,
-				[&dropper](auto value) {
-					return value.first == dropper;
-				});
-
-			if (removed) {
-				vector<data::type::drop_info> current;
-				m_drop_info.emplace_back(dropper, current);
-			}
-		}
-
-		for (auto &drop : m_drop_info) {
-			if (drop.first == dropper) {
-				drop.second.push_back(info);
-				break;
+		// User drops replace the stock drops of the droppers they mention
+		auto kvp = drops.find(dropper);
+		if (kvp != std::end(drops)) {
+			if (dropper != last_dropper_id) {
+				kvp->second.clear();
 			}
+			kvp->second.push_back(info);
 		}
 
 		last_dropper_id = dropper;
 	}
+
+	m_drop_info = id_index<int32_t, vector<data::type::drop_info>>{std::move(drops)};
 }
 
 auto drop::load_global_drops() -> void {
 	m_global_drops.clear();
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::drop_global_data));
+	auto rs = mcdb::select(vana::data::table::drop_global_data);
 
 	for (const auto &row : rs) {
 		data::type::global_drop_info drop;
@@ -144,10 +109,8 @@ auto drop::load_global_drops() -> void {
 }
 
 auto drop::get_drops(int32_t object_id) const -> const vector<data::type::drop_info> & {
-	for (const auto &drop : m_drop_info) {
-		if (drop.first == object_id) {
-			return drop.second;
-		}
+	if (auto drops = m_drop_info.find(object_id)) {
+		return *drops;
 	}
 
 	static vector<data::type::drop_info> empty;
@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "common/data/id_index.hpp"
 #include "common/data/type/drop_info.hpp"
 #include "common/data/type/global_drop_info.hpp"
 #include "common/types.hpp"
@@ -36,7 +37,7 @@ namespace vana {
 				auto load_drops() -> void;
 				auto load_global_drops() -> void;
 
-				vector<pair<int32_t, vector<data::type::drop_info>>> m_drop_info;
+				id_index<int32_t, vector<data::type::drop_info>> m_drop_info;
 				vector<data::type::global_drop_info> m_global_drops;
 			};
 		}
@@ -17,12 +17,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "equip.hpp"
 #include "common/constant/job/track.hpp"
-#include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/util/randomizer.hpp"
 #include "common/util/string.hpp"
-#include <iomanip>
-#include <iostream>
 #include <random>
 #include <string>
 
@@ -31,25 +28,14 @@ namespace data {
 namespace provider {
 
 auto equip::load_data() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Equips... ";
-
 	load_equips();
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto equip::load_equips() -> void {
 	m_equip_info.clear();
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	// Ugly hack to get the integers instead of scientific notation
-	// Note: This is MySQL's crappy behavior
-	// It displays scientific notation for only very large values, meaning it's wildly inconsistent and hard to parse
-	// We just use the string and send it to a translation function
-	soci::rowset<> rs = (sql.prepare
-		<< "SELECT *, REPLACE(FORMAT(equip_slots + 0, 0), \",\", \"\") AS equip_slot_flags "
-		<< "FROM " << db.make_table(vana::data::table::item_equip_data));
+	// equip_slot_flags is computed by the query, see the MCDB snapshot table list
+	auto rs = mcdb::select(vana::data::table::item_equip_data);
 
 	for (const auto &row : rs) {
 		data::type::equip_info equip;
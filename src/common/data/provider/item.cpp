@@ -17,17 +17,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "item.hpp"
 #include "common/algorithm.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/data/provider/buff.hpp"
 #include "common/data/provider/equip.hpp"
 #include "common/data/provider/shop.hpp"
-#include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
 #include "common/item.hpp"
 #include "common/util/game_logic/item.hpp"
 #include "common/util/randomizer.hpp"
 #include "common/util/string.hpp"
-#include <iomanip>
-#include <iostream>
 #include <string>
 #include <utility>
 
@@ -36,11 +33,8 @@ namespace data {
 namespace provider {
 
 auto item::load_data(buff &provider) -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Items... ";
-
 	load_items();
 	load_consumes(provider);
-	load_map_ranges();
 	load_scrolls();
 	load_monster_card_data();
 	load_item_skills();
@@ -48,20 +42,13 @@ auto item::load_data(buff &provider) -> void {
 	load_item_rewards();
 	load_pets();
 	load_pet_interactions();
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto item::load_items() -> void {
-	m_item_info.clear();
+	vector<pair<game_item_id, data::type::item_info>> items;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare
-		<< "SELECT id.*, s.label "
-		<< "FROM " << db.make_table(vana::data::table::item_data) << " id "
-		<< "LEFT JOIN " << db.make_table(vana::data::table::strings) << " s ON id.itemid = s.objectid AND s.object_type = :item",
-		soci::use(string{"item"}, "item"));
+	// Joined with the item names, see the MCDB snapshot table list
+	auto rs = mcdb::select(vana::data::table::item_data);
 
 	for (const auto &row : rs) {
 		data::type::item_info info;
@@ -88,16 +75,16 @@ auto item::load_items() -> void {
 		info.npc = row.get<game_npc_id>("npc");
 		info.name = row.get<string>("label");
 
-		m_item_info.push_back(info);
+		items.emplace_back(info.id, info);
 	}
+
+	m_item_info = id_index<game_item_id, data::type::item_info>{std::move(items)};
 }
 
 auto item::load_scrolls() -> void {
-	m_scroll_info.clear();
+	vector<pair<game_item_id, data::type::scroll_info>> scrolls;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::item_scroll_data));
+	auto rs = mcdb::select(vana::data::table::item_scroll_data);
 
 	for (const auto &row : rs) {
 		data::type::scroll_info info;
@@ -126,16 +113,16 @@ auto item::load_scrolls() -> void {
 			else if (cmp == "prevent_slip") info.prevent_slip = true;
 		});
 
-		m_scroll_info.push_back(info);
+		scrolls.emplace_back(info.item_id, info);
 	}
+
+	m_scroll_info = id_index<game_item_id, data::type::scroll_info>{std::move(scrolls)};
 }
 
 auto item::load_consumes(buff &provider) -> void {
-	m_consume_info.clear();
+	hash_map<game_item_id, data::type::consume_info> consumes;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::item_random_morphs));
+	auto rs = mcdb::select(vana::data::table::item_random_morphs);
 
 	hash_map<game_item_id, vector<data::type::morph_chance_info>> morph_data;
 	for (const auto &row : rs) {
@@ -147,7 +134,7 @@ auto item::load_consumes(buff &provider) -> void {
 		morph_data[item_id].push_back(info);
 	}
 
-	rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::item_consume_data));
+	rs = mcdb::select(vana::data::table::item_consume_data);
 
 	for (const auto &row : rs) {
 		data::type::consume_info info;
@@ -230,15 +217,17 @@ auto item::load_consumes(buff &provider) -> void {
 			else if (cmp == "weakness") info.ailment |= 0x10;
 		});
 
-		provider.add_item_info(info.item_id, info);
-		m_consume_info.push_back(info);
+		consumes.emplace(info.item_id, info);
 	}
+
+	load_map_ranges(consumes);
+
+	m_consume_info = id_index<game_item_id, data::type::consume_info>{std::move(consumes)};
+	provider.load_item_info(m_consume_info);
 }
 
-auto item::load_map_ranges() -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::item_monster_card_map_ranges));
+auto item::load_map_ranges(hash_map<game_item_id, data::type::consume_info> &consumes) -> void {
+	auto rs = mcdb::select(vana::data::table::item_monster_card_map_ranges);
 
 	for (const auto &row : rs) {
 		data::type::card_map_range_info info;
@@ -246,40 +235,35 @@ auto item::load_map_ranges() -> void {
 		info.start_map = row.get<game_map_id>("start_map");
 		info.end_map = row.get<game_map_id>("end_map");
 
-		bool found = false;
-		for (auto &item : m_consume_info) {
-			if (item.item_id == item_id) {
-				found = true;
-				item.map_ranges.push_back(info);
-				break;
-			}
-		}
+		auto kvp = consumes.find(item_id);
+		if (kvp == std::end(consumes)) THROW_CODE_EXCEPTION(codepath_invalid_exception);
 
-		if (!found) THROW_CODE_EXCEPTION(codepath_invalid_exception);
+		kvp->second.map_ranges.push_back(info);
 	}
 }
 
 auto item::load_monster_card_data() -> void {
-	m_mob_to_card_mapping.clear();
+	vector<pair<game_item_id, game_mob_id>> card_to_mob;
+	vector<pair<game_mob_id, game_item_id>> mob_to_card;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::monster_card_data));
+	auto rs = mcdb::select(vana::data::table::monster_card_data);
 
 	for (const auto &row : rs) {
 		game_item_id card_id = row.get<game_item_id>("cardid");
 		game_mob_id mob_id = row.get<game_mob_id>("mobid");
 
-		m_mob_to_card_mapping.emplace_back(card_id, mob_id);
+		card_to_mob.emplace_back(card_id, mob_id);
+		mob_to_card.emplace_back(mob_id, card_id);
 	}
+
+	m_card_to_mob = id_index<game_item_id, game_mob_id>{std::move(card_to_mob)};
+	m_mob_to_card = id_index<game_mob_id, game_item_id>{std::move(mob_to_card)};
 }
 
 auto item::load_item_skills() -> void {
-	m_skillbooks.clear();
+	hash_map<game_item_id, vector<data::type::skillbook_info>> skillbooks;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::item_skills));
+	auto rs = mcdb::select(vana::data::table::item_skills);
 
 	for (const auto &row : rs) {
 		data::type::skillbook_info info;
@@ -289,29 +273,16 @@ auto item::load_item_skills() -> void {
 		info.max_level = row.get<game_skill_level>("master_level");
 		info.chance = row.get<int8_t>("chance");
 
-		bool found = false;
-		for (auto &book : m_skillbooks) {
-			if (book.first == item_id) {
-				found = true;
-				book.second.push_back(info);
-				break;
-			}
-		}
-
-		if (!found) {
-			vector<data::type::skillbook_info> current;
-			current.push_back(info);
-			m_skillbooks.emplace_back(item_id, current);
-		}
+		skillbooks[item_id].push_back(info);
 	}
+
+	m_skillbooks = id_index<game_item_id, vector<data::type::skillbook_info>>{std::move(skillbooks)};
 }
 
 auto item::load_summon_bags() -> void {
-	m_summon_bags.clear();
+	hash_map<game_item_id, vector<data::type::summon_bag_info>> summon_bags;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::item_summons));
+	auto rs = mcdb::select(vana::data::table::item_summons);
 
 	for (const auto &row : rs) {
 		data::type::summon_bag_info info;
@@ -319,29 +290,16 @@ auto item::load_summon_bags() -> void {
 		info.mob_id = row.get<game_mob_id>("mobid");
 		info.chance = row.get<uint16_t>("chance");
 
-		bool found = false;
-		for (auto &summon : m_summon_bags) {
-			if (summon.first == item_id) {
-				found = true;
-				summon.second.push_back(info);
-				break;
-			}
-		}
-
-		if (!found) {
-			vector<data::type::summon_bag_info> current;
-			current.push_back(info);
-			m_summon_bags.emplace_back(item_id, current);
-		}
+		summon_bags[item_id].push_back(info);
 	}
+
+	m_summon_bags = id_index<game_item_id, vector<data::type::summon_bag_info>>{std::move(summon_bags)};
 }
 
 auto item::load_item_rewards() -> void {
-	m_item_rewards.clear();
+	hash_map<game_item_id, vector<data::type::item_reward_info>> item_rewards;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::item_reward_data));
+	auto rs = mcdb::select(vana::data::table::item_reward_data);
 
 	for (const auto &row : rs) {
 		data::type::item_reward_info info;
@@ -351,29 +309,16 @@ auto item::load_item_rewards() -> void {
 		info.quantity = row.get<int16_t>("quantity");
 		info.effect = row.get<string>("effect");
 
-		bool found = false;
-		for (auto &reward : m_item_rewards) {
-			if (reward.first == item_id) {
-				found = true;
-				reward.second.push_back(info);
-				break;
-			}
-		}
-
-		if (!found) {
-			vector<data::type::item_reward_info> current;
-			current.push_back(info);
-			m_item_rewards.emplace_back(item_id, current);
-		}
+		item_rewards[item_id].push_back(info);
 	}
+
+	m_item_rewards = id_index<game_item_id, vector<data::type::item_reward_info>>{std::move(item_rewards)};
 }
 
 auto item::load_pets() -> void {
-	m_pet_info.clear();
+	vector<pair<game_item_id, data::type::pet_info>> pets;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::item_pet_data));
+	auto rs = mcdb::select(vana::data::table::item_pet_data);
 
 	for (const auto &row : rs) {
 		data::type::pet_info info;
@@ -390,16 +335,16 @@ auto item::load_pets() -> void {
 			else if (cmp == "auto_react") info.auto_react = true;
 		});
 
-		m_pet_info.push_back(info);
+		pets.emplace_back(info.item_id, info);
 	}
+
+	m_pet_info = id_index<game_item_id, data::type::pet_info>{std::move(pets)};
 }
 
 auto item::load_pet_interactions() -> void {
-	m_pet_interact_info.clear();
+	hash_map<game_item_id, vector<data::type::pet_interact_info>> interactions;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::item_pet_interactions));
+	auto rs = mcdb::select(vana::data::table::item_pet_interactions);
 
 	for (const auto &row : rs) {
 		data::type::pet_interact_info info;
@@ -408,34 +353,30 @@ auto item::load_pet_interactions() -> void {
 		info.increase = row.get<int16_t>("closeness");
 		info.prob = row.get<uint32_t>("success");
 
-		m_pet_interact_info.push_back(info);
+		interactions[info.item_id].push_back(info);
 	}
+
+	m_pet_interact_info = id_index<game_item_id, vector<data::type::pet_interact_info>>{std::move(interactions)};
 }
 
 auto item::get_card_id(game_mob_id mob_id) const -> optional<game_item_id> {
-	auto kvp =
-		ext::find_value_ptr_if(m_mob_to_card_mapping, [&mob_id](auto value) { return value.second == mob_id; });
-
-	if (kvp == nullptr) {
+	auto card_id = m_mob_to_card.find(mob_id);
+	if (card_id == nullptr) {
 		return {};
 	}
-	return kvp->first;
+	return *card_id;
 }
 
 auto item::get_mob_id(game_item_id card_id) const -> optional<game_mob_id> {
-	auto kvp =
-		ext::find_value_ptr_if(m_mob_to_card_mapping, [&card_id](auto value) { return value.first == card_id; });
-
-	if (kvp == nullptr) {
+	auto mob_id = m_card_to_mob.find(card_id);
+	if (mob_id == nullptr) {
 		return {};
 	}
-	return kvp->second;
+	return *mob_id;
 }
 
 auto item::scroll_item(const equip &provider, game_item_id scroll_id, vana::item *equip, bool white_scroll, bool gm_scroller, int8_t &succeed, bool &cursed) const -> hacking_result {
-	auto kvp = ext::find_value_ptr_if(
-		m_scroll_info,
-		[&scroll_id](auto value) { return value.item_id == scroll_id; });
+	auto kvp = m_scroll_info.find(scroll_id);
 
 	if (kvp == nullptr) {
 		return hacking_result::definitely_hacking;
@@ -529,45 +470,33 @@ auto item::scroll_item(const equip &provider, game_item_id scroll_id, vana::item
 }
 
 auto item::get_item_info(game_item_id item_id) const -> const data::type::item_info * const {
-	return ext::find_value_ptr_if(
-		m_item_info,
-		[&item_id](auto value) { return value.id == item_id; });
+	return m_item_info.find(item_id);
 }
 
 auto item::get_consume_info(game_item_id item_id) const -> const data::type::consume_info * const {
-	return ext::find_value_ptr_if(
-		m_consume_info,
-		[&item_id](auto value) { return value.item_id == item_id; });
+	return m_consume_info.find(item_id);
 }
 
 auto item::get_pet_info(game_item_id item_id) const -> const data::type::pet_info * const {
-	return ext::find_value_ptr_if(
-		m_pet_info,
-		[&item_id](auto value) { return value.item_id == item_id; });
+	return m_pet_info.find(item_id);
 }
 
 auto item::get_interaction(game_item_id item_id, int32_t action) const -> const data::type::pet_interact_info * const {
 	return ext::find_value_ptr_if(
-		m_pet_interact_info,
-		[&item_id, &action](auto value) { return value.item_id == item_id && value.command_id == action; });
+		m_pet_interact_info.find(item_id),
+		[&action](auto value) { return value.command_id == action; });
 }
 
 auto item::get_item_skills(game_item_id item_id) const -> const vector<data::type::skillbook_info> * const {
-	return &ext::find_value_ptr_if(
-		m_skillbooks,
-		[&item_id](auto value) { return value.first == item_id; })->second;
+	return m_skillbooks.find(item_id);
 }
 
 auto item::get_item_rewards(game_item_id item_id) const -> const vector<data::type::item_reward_info> * const {
-	return &ext::find_value_ptr_if(
-		m_item_rewards,
-		[&item_id](auto value) { return value.first == item_id; })->second;
+	return m_item_rewards.find(item_id);
 }
 
 auto item::get_item_summons(game_item_id item_id) const -> const vector<data::type::summon_bag_info> * const {
-	return &ext::find_value_ptr_if(
-		m_summon_bags,
-		[&item_id](auto value) { return value.first == item_id; })->second;
+	return m_summon_bags.find(item_id);
 }
 
 }
@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "common/data/id_index.hpp"
 #include "common/data/type/consume_info.hpp"
 #include "common/data/type/item_info.hpp"
 #include "common/data/type/item_reward_info.hpp"
@@ -57,7 +58,7 @@ namespace vana {
 				auto load_items() -> void;
 				auto load_scrolls() -> void;
 				auto load_consumes(buff &provider) -> void;
-				auto load_map_ranges() -> void;
+				auto load_map_ranges(hash_map<game_item_id, data::type::consume_info> &consumes) -> void;
 				auto load_monster_card_data() -> void;
 				auto load_item_skills() -> void;
 				auto load_summon_bags() -> void;
@@ -65,15 +66,16 @@ namespace vana {
 				auto load_pets() -> void;
 				auto load_pet_interactions() -> void;
 
-				vector<data::type::item_info> m_item_info;
-				vector<data::type::scroll_info> m_scroll_info;
-				vector<data::type::consume_info> m_consume_info;
-				vector<pair<game_item_id, vector<data::type::summon_bag_info>>> m_summon_bags;
-				vector<pair<game_item_id, vector<data::type::skillbook_info>>> m_skillbooks;
-				vector<pair<game_item_id, vector<data::type::item_reward_info>>> m_item_rewards;
-				vector<data::type::pet_info> m_pet_info;
-				vector<data::type::pet_interact_info> m_pet_interact_info;
-				vector<pair<game_item_id, game_mob_id>> m_mob_to_card_mapping;
+				id_index<game_item_id, data::type::item_info> m_item_info;
+				id_index<game_item_id, data::type::scroll_info> m_scroll_info;
+				id_index<game_item_id, data::type::consume_info> m_consume_info;
+				id_index<game_item_id, vector<data::type::summon_bag_info>> m_summon_bags;
+				id_index<game_item_id, vector<data::type::skillbook_info>> m_skillbooks;
+				id_index<game_item_id, vector<data::type::item_reward_info>> m_item_rewards;
+				id_index<game_item_id, data::type::pet_info> m_pet_info;
+				id_index<game_item_id, vector<data::type::pet_interact_info>> m_pet_interact_info;
+				id_index<game_item_id, game_mob_id> m_card_to_mob;
+				id_index<game_mob_id, game_item_id> m_mob_to_card;
 			};
 		}
 	}
@@ -18,7 +18,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "map.hpp"
 #include "common/algorithm.hpp"
 #include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/util/game_logic/map.hpp"
 #include "common/util/string.hpp"
 #include <iomanip>
@@ -35,39 +35,26 @@ auto map::load_data() -> void {
 }
 
 auto map::load_continents() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Continents... ";
-
-	decltype(m_continents) copy;
+	vector<pair<int8_t, int8_t>> continents;
 	int8_t map_cluster;
 	int8_t continent;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::map_continent_data));
+	auto rs = mcdb::select(vana::data::table::map_continent_data);
 
 	for (const auto &row : rs) {
 		map_cluster = row.get<int8_t>("map_cluster");
 		continent = row.get<int8_t>("continent");
 
-		copy.push_back(std::make_pair(map_cluster, continent));
-	}
-
-	{
-		owned_lock<mutex> l{m_load_mutex};
-		m_continents = copy;
+		continents.push_back(std::make_pair(map_cluster, continent));
 	}
 
-	std::cout << "DONE" << std::endl;
+	std::atomic_store(&m_continents, ref_ptr<const continent_index>{make_ref_ptr<continent_index>(std::move(continents))});
 }
 
 auto map::load_maps() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Maps... ";
+	vector<pair<game_map_id, ref_ptr<data::type::map_info>>> maps;
 
-	decltype(m_maps) copy;
-
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::map_data));
+	auto rs = mcdb::select(vana::data::table::map_data);
 
 	for (const auto &row : rs) {
 		auto info = make_ref_ptr<data::type::map_info>();
@@ -131,43 +118,24 @@ auto map::load_maps() -> void {
 		info->damage_per_second = row.get<game_damage>("damage_per_second");
 		info->ship_kind = row.get<int8_t>("ship_kind");
 
-		copy.push_back(info);
+		maps.emplace_back(id, info);
 	}
 
-	/*
-	// This adds about 40 seconds to the debug startup process (the process is roughly 20 seconds currently)
-	// This isn't desirable for now
-	for (auto &map : m_maps) {
-		load_map(map);
-	}
-	*/
-
 	{
 		owned_lock<mutex> l{m_load_mutex};
-		m_maps = copy;
 		m_link_info.clear();
 	}
 
-	std::cout << "DONE" << std::endl;
+	std::atomic_store(&m_maps, ref_ptr<const map_index>{make_ref_ptr<map_index>(std::move(maps))});
 }
 
 auto map::load_map(data::type::map_info &map) -> void {
-	size_t index = 0;
-	bool found = false;
-	for (/* intentionally blank */; index < m_link_info.size(); ++index) {
-		auto &value = m_link_info[index];
-		found =
-			(map.link != 0 && value->id == map.link) ||
-			(map.link == 0 && value->id == map.id);
-
-		if (found) {
-			break;
-		}
-	}
+	game_map_id link_id = map.link != 0 ? map.link : map.id;
+	auto &link_info = m_link_info[link_id];
 
-	if (!found) {
+	if (link_info == nullptr) {
 		auto info = make_ref_ptr<data::type::map_link_info>();
-		info->id = map.link != 0 ? map.link : map.id;
+		info->id = link_id;
 
 		load_map_time_mob(*info);
 		load_footholds(*info);
@@ -175,20 +143,15 @@ auto map::load_map(data::type::map_info &map) -> void {
 		load_portals(*info);
 		load_seats(*info);
 
-		m_link_info.push_back(info);
-
-		map.link_info = m_link_info[m_link_info.size() - 1];
-	}
-	else {
-		map.link_info = m_link_info[index];
+		link_info = info;
 	}
+
+	// Published atomically since get_map checks it without the lock
+	std::atomic_store(&map.link_info, link_info);
 }
 
 auto map::load_seats(data::type::map_link_info &map) -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::map_seats) << " WHERE mapid = :map",
-		soci::use(map.id, "map"));
+	auto rs = mcdb::select(vana::data::table::map_seats, map.id);
 
 	for (const auto &row : rs) {
 		data::type::seat_info chair;
@@ -201,10 +164,7 @@ auto map::load_seats(data::type::map_link_info &map) -> void {
 }
 
 auto map::load_portals(data::type::map_link_info &map) -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::map_portals) << " WHERE mapid = :map",
-		soci::use(map.id, "map"));
+	auto rs = mcdb::select(vana::data::table::map_portals, map.id);
 
 	for (const auto &row : rs) {
 		data::type::portal_info portal;
@@ -230,10 +190,7 @@ auto map::load_map_life(data::type::map_link_info &map) -> void {
 	data::type::spawn_info life;
 	string type;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::map_life) << " WHERE mapid = :map",
-		soci::use(map.id, "map"));
+	auto rs = mcdb::select(vana::data::table::map_life, map.id);
 
 	for (const auto &row : rs) {
 		life = data::type::spawn_info{};
@@ -270,10 +227,7 @@ auto map::load_map_life(data::type::map_link_info &map) -> void {
 }
 
 auto map::load_footholds(data::type::map_link_info &map) -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::map_footholds) << " WHERE mapid = :map",
-		soci::use(map.id, "map"));
+	auto rs = mcdb::select(vana::data::table::map_footholds, map.id);
 
 	for (const auto &row : rs) {
 		data::type::foothold_info foot;
@@ -295,10 +249,7 @@ auto map::load_footholds(data::type::map_link_info &map) -> void {
 }
 
 auto map::load_map_time_mob(data::type::map_link_info &map) -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::map_time_mob) << " WHERE mapid = :map",
-		soci::use(map.id, "map"));
+	auto rs = mcdb::select(vana::data::table::map_time_mob, map.id);
 
 	for (const auto &row : rs) {
 		data::type::time_mob_info info{};
@@ -315,33 +266,59 @@ auto map::load_map_time_mob(data::type::map_link_info &map) -> void {
 auto map::get_continent(game_map_id map_id) -> opt_int8_t {
 	int8_t cluster = vana::util::game_logic::map::get_map_cluster(map_id);
 
-	owned_lock<mutex> l{m_load_mutex};
-	for (const auto &continent : m_continents) {
-		if (continent.first == cluster) {
-			return continent.second;
-		}
+	auto continents = std::atomic_load(&m_continents);
+	if (continents == nullptr) {
+		return {};
 	}
 
-	return {};
+	auto continent = continents->find(cluster);
+	if (continent == nullptr) {
+		return {};
+	}
+	return *continent;
 }
 
 auto map::get_map(game_map_id map_id) -> ref_ptr<const data::type::map_info> {
-	ref_ptr<data::type::map_info> ptr;
-	owned_lock<mutex> l{m_load_mutex};
-	for (auto &map : m_maps) {
-		if (map->id == map_id) {
-			ptr = map;
-			break;
+	auto maps = std::atomic_load(&m_maps);
+	auto info = maps == nullptr ? nullptr : maps->find(map_id);
+	if (info == nullptr) THROW_CODE_EXCEPTION(codepath_invalid_exception);
+
+	ref_ptr<data::type::map_info> ptr = *info;
+	if (std::atomic_load(&ptr->link_info) == nullptr) {
+		owned_lock<mutex> l{m_load_mutex};
+		if (std::atomic_load(&ptr->link_info) == nullptr) {
+			load_map(*ptr);
 		}
 	}
 
-	if (ptr == nullptr) THROW_CODE_EXCEPTION(codepath_invalid_exception);
+	return ptr;
+}
 
-	if (ptr->link_info == nullptr) {
-		load_map(*ptr);
+auto map::is_loaded(game_map_id map_id) -> bool {
+	auto maps = std::atomic_load(&m_maps);
+	auto info = maps == nullptr ? nullptr : maps->find(map_id);
+	if (info == nullptr) {
+		// Nothing to load, get_map will throw the same way regardless
+		return true;
 	}
 
-	return ptr;
+	return std::atomic_load(&(*info)->link_info) != nullptr;
+}
+
+auto map::preload_all() -> void {
+	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Preloading Maps... ";
+
+	auto maps = std::atomic_load(&m_maps);
+	if (maps != nullptr) {
+		owned_lock<mutex> l{m_load_mutex};
+		for (const auto &kvp : *maps) {
+			if (std::atomic_load(&kvp.second->link_info) == nullptr) {
+				load_map(*kvp.second);
+			}
+		}
+	}
+
+	std::cout << "DONE" << std::endl;
 }
 
 }
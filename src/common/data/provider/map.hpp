@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "common/data/id_index.hpp"
 #include "common/data/type/map_info.hpp"
 #include "common/types.hpp"
 #include "common/util/optional.hpp"
@@ -34,6 +35,9 @@ namespace vana {
 				auto load_data() -> void;
 				auto get_map(game_map_id map_id) -> ref_ptr<const data::type::map_info>;
 				auto get_continent(game_map_id map_id) -> opt_int8_t;
+				auto is_loaded(game_map_id map_id) -> bool;
+				// Loads the link info of every map up front, this adds a large amount of time to startup
+				auto preload_all() -> void;
 			private:
 				auto load_continents() -> void;
 				auto load_maps() -> void;
@@ -45,10 +49,15 @@ namespace vana {
 				auto load_seats(data::type::map_link_info &map) -> void;
 				auto load_map(data::type::map_info &map) -> void;
 
+				using map_index = id_index<game_map_id, ref_ptr<data::type::map_info>>;
+				using continent_index = id_index<int8_t, int8_t>;
+
+				// The indexes are swapped atomically on reload so lookups never lock
+				// The mutex only serializes the lazy loading of link info
 				mutex m_load_mutex;
-				vector<ref_ptr<data::type::map_info>> m_maps;
-				vector<ref_ptr<data::type::map_link_info>> m_link_info;
-				vector<pair<int8_t, int8_t>> m_continents;
+				ref_ptr<const map_index> m_maps;
+				ref_ptr<const continent_index> m_continents;
+				hash_map<game_map_id, ref_ptr<const data::type::map_link_info>> m_link_info;
 			};
 		}
 	}
@@ -17,11 +17,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "mob.hpp"
 #include "common/algorithm.hpp"
-#include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/util/string.hpp"
-#include <iomanip>
-#include <iostream>
 #include <stdexcept>
 #include <string>
 
@@ -30,22 +27,16 @@ namespace data {
 namespace provider {
 
 auto mob::load_data() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Mobs... ";
-
 	load_attacks();
 	load_skills();
 	load_mobs();
 	load_summons();
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto mob::load_attacks() -> void {
-	m_attacks.clear();
+	hash_map<game_mob_id, vector<data::type::mob_attack_info>> attacks;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::mob_attacks));
+	auto rs = mcdb::select(vana::data::table::mob_attacks);
 
 	for (const auto &row : rs) {
 		data::type::mob_attack_info mob_attack;
@@ -68,27 +59,16 @@ auto mob::load_attacks() -> void {
 			else if (cmp == "area_effect_plus") mob_attack.attack_type = data::type::mob_attack_type::area_effect_plus;
 		});
 
-		bool found = false;
-		for (auto &mob : m_attacks) {
-			if (mob.first == mob_id) {
-				mob.second.push_back(mob_attack);
-				found = true;
-				break;
-			}
-		}
-		if (!found) {
-			vector<data::type::mob_attack_info> new_value{mob_attack};
-			m_attacks.push_back(std::make_pair(mob_id, new_value));
-		}
+		attacks[mob_id].push_back(mob_attack);
 	}
+
+	m_attacks = id_index<game_mob_id, vector<data::type::mob_attack_info>>{std::move(attacks)};
 }
 
 auto mob::load_skills() -> void {
-	m_skills.clear();
+	hash_map<game_mob_id, vector<data::type::mob_skill_info>> skills;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::mob_skills));
+	auto rs = mcdb::select(vana::data::table::mob_skills);
 
 	for (const auto &row : rs) {
 		data::type::mob_skill_info mob_skill;
@@ -97,27 +77,16 @@ auto mob::load_skills() -> void {
 		mob_skill.level = row.get<game_mob_skill_level>("skill_level");
 		mob_skill.effect_after = milliseconds{row.get<int16_t>("effect_delay")};
 
-		bool found = false;
-		for (auto &mob : m_skills) {
-			if (mob.first == mob_id) {
-				mob.second.push_back(mob_skill);
-				found = true;
-				break;
-			}
-		}
-		if (!found) {
-			vector<data::type::mob_skill_info> new_value{mob_skill};
-			m_skills.push_back(std::make_pair(mob_id, new_value));
-		}
+		skills[mob_id].push_back(mob_skill);
 	}
+
+	m_skills = id_index<game_mob_id, vector<data::type::mob_skill_info>>{std::move(skills)};
 }
 
 auto mob::load_mobs() -> void {
-	m_mob_info.clear();
+	vector<pair<game_mob_id, ref_ptr<data::type::mob_info>>> mobs;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::mob_data));
+	auto rs = mcdb::select(vana::data::table::mob_data);
 
 	for (const auto &row : rs) {
 		auto mob = make_ref_ptr<data::type::mob_info>();
@@ -188,80 +157,60 @@ auto mob::load_mobs() -> void {
 		mob->can_poison = (!mob->boss && mob->poison_attr != mob_elemental_attribute::immune && mob->poison_attr != mob_elemental_attribute::strong);
 
 		// Skill count relies on skills being loaded first
-		for (const auto &skill : m_skills) {
-			if (skill.first == mob->id) {
-				mob->skill_count = static_cast<uint8_t>(skill.second.size());
-				break;
-			}
+		if (auto skills = m_skills.find(mob->id)) {
+			mob->skill_count = static_cast<uint8_t>(skills->size());
 		}
 
-		m_mob_info.push_back(mob);
+		mobs.emplace_back(mob->id, mob);
 	}
+
+	m_mob_info = id_index<game_mob_id, ref_ptr<data::type::mob_info>>{std::move(mobs)};
 }
 
 auto mob::load_summons() -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::mob_summons));
+	auto rs = mcdb::select(vana::data::table::mob_summons);
 
 	for (const auto &row : rs) {
 		game_mob_id mob_id = row.get<game_mob_id>("mobid");
 		game_mob_id summon_id = row.get<game_mob_id>("summonid");
 
-		for (const auto &mob : m_mob_info) {
-			if (mob->id == mob_id) {
-				mob->summon.push_back(summon_id);
-				break;
-			}
+		if (auto mob = m_mob_info.find(mob_id)) {
+			(*mob)->summon.push_back(summon_id);
 		}
 	}
 }
 
 auto mob::mob_exists(game_mob_id mob_id) const -> bool {
-	for (const auto &mob : m_mob_info) {
-		if (mob->id == mob_id) {
-			return true;
-		}
-	}
-
-	return false;
+	return m_mob_info.contains(mob_id);
 }
 
 auto mob::get_mob_info(game_mob_id mob_id) const -> ref_ptr<const data::type::mob_info> {
-	for (const auto &info : m_mob_info) {
-		if (info->id == mob_id) {
-			return info;
-		}
+	if (auto info = m_mob_info.find(mob_id)) {
+		return *info;
 	}
 
 	THROW_CODE_EXCEPTION(codepath_invalid_exception);
 }
 
 auto mob::get_mob_attack(game_mob_id mob_id, uint8_t index) const -> const data::type::mob_attack_info * const {
-	for (const auto &mob : m_attacks) {
-		if (mob.first == mob_id) {
-			return &mob.second[index];
-		}
+	if (auto attacks = m_attacks.find(mob_id)) {
+		return &(*attacks)[index];
 	}
 
 	THROW_CODE_EXCEPTION(codepath_invalid_exception);
 }
 
 auto mob::get_mob_skill(game_mob_id mob_id, uint8_t index) const -> const data::type::mob_skill_info * const {
-	for (const auto &mob : m_skills) {
-		if (mob.first == mob_id) {
-			return &mob.second[index];
-		}
+	if (auto skills = m_skills.find(mob_id)) {
+		return &(*skills)[index];
 	}
 
 	THROW_CODE_EXCEPTION(codepath_invalid_exception);
 }
 
 auto mob::get_skills(game_mob_id mob_id) const -> const vector<data::type::mob_skill_info> & {
-	for (const auto &mob : m_skills) {
-		if (mob.first == mob_id) {
-			return mob.second;
-		}
+	if (auto skills = m_skills.find(mob_id)) {
+		return *skills;
 	}
 
 	THROW_CODE_EXCEPTION(codepath_invalid_exception);
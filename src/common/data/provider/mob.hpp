@@ -17,6 +17,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "common/data/id_index.hpp"
 #include "common/data/type/mob_attack_info.hpp"
 #include "common/data/type/mob_info.hpp"
 #include "common/data/type/mob_skill_info.hpp"
@@ -44,9 +45,9 @@ namespace vana {
 				auto load_skills() -> void;
 				auto load_summons() -> void;
 
-				vector<ref_ptr<data::type::mob_info>> m_mob_info;
-				vector<pair<game_mob_id, vector<data::type::mob_attack_info>>> m_attacks;
-				vector<pair<game_mob_id, vector<data::type::mob_skill_info>>> m_skills;
+				id_index<game_mob_id, ref_ptr<data::type::mob_info>> m_mob_info;
+				id_index<game_mob_id, vector<data::type::mob_attack_info>> m_attacks;
+				id_index<game_mob_id, vector<data::type::mob_skill_info>> m_skills;
 			};
 		}
 	}
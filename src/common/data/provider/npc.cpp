@@ -17,22 +17,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "npc.hpp"
 #include "common/algorithm.hpp"
-#include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/util/string.hpp"
-#include <iomanip>
-#include <iostream>
 
 namespace vana {
 namespace data {
 namespace provider {
 
 auto npc::load_data() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing NPCs... ";
-
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::npc_data));
+	auto rs = mcdb::select(vana::data::table::npc_data);
 
 	for (const auto &row : rs) {
 		data::type::npc_info info;
@@ -46,8 +39,6 @@ auto npc::load_data() -> void {
 
 		m_data.push_back(info);
 	}
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto npc::get_storage_cost(game_npc_id npc) const -> game_mesos {
@@ -18,36 +18,27 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "quest.hpp"
 #include "common/algorithm.hpp"
 #include "common/constant/job/id.hpp"
-#include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/quest.hpp"
 #include "common/util/game_logic/player.hpp"
 #include "common/util/string.hpp"
 #include <initializer_list>
-#include <iomanip>
-#include <iostream>
 
 namespace vana {
 namespace data {
 namespace provider {
 
 auto quest::load_data() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Quests... ";
-
 	load_quest_data();
 	load_requests();
 	load_required_jobs();
 	load_rewards();
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto quest::load_quest_data() -> void {
 	m_quests.clear();
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::quest_data));
+	auto rs = mcdb::select(vana::data::table::quest_data);
 
 	for (const auto &row : rs) {
 		vana::quest quest;
@@ -64,9 +55,7 @@ auto quest::load_requests() -> void {
 	// TODO FIXME quest
 	// Process the state when you add quest requests
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::quest_requests));
+	auto rs = mcdb::select(vana::data::table::quest_requests);
 
 	for (const auto &row : rs) {
 		game_quest_id quest_id = row.get<game_quest_id>("questid");
@@ -116,9 +105,7 @@ auto quest::load_requests() -> void {
 }
 
 auto quest::load_required_jobs() -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::quest_required_jobs));
+	auto rs = mcdb::select(vana::data::table::quest_required_jobs);
 
 	for (const auto &row : rs) {
 		game_quest_id quest_id = row.get<game_quest_id>("questid");
@@ -140,9 +127,7 @@ auto quest::load_required_jobs() -> void {
 }
 
 auto quest::load_rewards() -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::quest_rewards));
+	auto rs = mcdb::select(vana::data::table::quest_rewards);
 
 	for (const auto &row : rs) {
 		game_quest_id quest_id = row.get<game_quest_id>("questid");
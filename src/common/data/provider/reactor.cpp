@@ -16,11 +16,8 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "reactor.hpp"
-#include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/util/string.hpp"
-#include <iomanip>
-#include <iostream>
 #include <string>
 
 namespace vana {
@@ -28,21 +25,15 @@ namespace data {
 namespace provider {
 
 auto reactor::load_data() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Reactors... ";
-
 	load_reactors();
 	load_states();
 	load_trigger_skills();
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto reactor::load_reactors() -> void {
 	m_reactor_info.clear();
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::reactor_data));
+	auto rs = mcdb::select(vana::data::table::reactor_data);
 
 	for (const auto &row : rs) {
 		data::type::reactor_info reactor;
@@ -60,9 +51,7 @@ auto reactor::load_reactors() -> void {
 }
 
 auto reactor::load_states() -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::reactor_events) << " ORDER BY reactorId, state ASC");
+	auto rs = mcdb::select(vana::data::table::reactor_events);
 
 	for (const auto &row : rs) {
 		data::type::reactor_state_info state;
@@ -101,9 +90,7 @@ auto reactor::load_states() -> void {
 }
 
 auto reactor::load_trigger_skills() -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::reactor_event_trigger_skills));
+	auto rs = mcdb::select(vana::data::table::reactor_event_trigger_skills);
 
 	for (const auto &row : rs) {
 		game_reactor_id id = row.get<game_reactor_id>("reactorid");
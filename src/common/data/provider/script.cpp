@@ -18,12 +18,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "script.hpp"
 #include "common/abstract_server.hpp"
 #include "common/algorithm.hpp"
-#include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/util/file.hpp"
 #include "common/util/string.hpp"
-#include <iomanip>
-#include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <string>
 
@@ -32,18 +30,14 @@ namespace data {
 namespace provider {
 
 auto script::load_data() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Scripts... ";
+	vector<pair<game_npc_id, string>> npc_scripts;
+	vector<pair<game_reactor_id, string>> reactor_scripts;
+	vector<pair<game_map_id, string>> map_entry_scripts;
+	vector<pair<game_map_id, string>> first_map_entry_scripts;
+	vector<pair<game_item_id, string>> item_scripts;
+	hash_map<game_quest_id, vector<pair<int8_t, string>>> quest_scripts;
 
-	m_npc_scripts.clear();
-	m_reactor_scripts.clear();
-	m_quest_scripts.clear();
-	m_map_entry_scripts.clear();
-	m_first_map_entry_scripts.clear();
-	m_item_scripts.clear();
-
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::scripts));
+	auto rs = mcdb::select(vana::data::table::scripts);
 
 	for (const auto &row : rs) {
 		int32_t object_id = row.get<int32_t>("objectid");
@@ -51,63 +45,51 @@ auto script::load_data() -> void {
 		int8_t modifier = row.get<int8_t>("helper");
 
 		vana::util::str::run_enum(row.get<string>("script_type"), [&](const string &cmp) {
-			if (cmp == "npc") m_npc_scripts.push_back(std::make_pair(object_id, script));
-			else if (cmp == "reactor") m_reactor_scripts.push_back(std::make_pair(object_id, script));
-			else if (cmp == "map_enter") m_map_entry_scripts.push_back(std::make_pair(object_id, script));
-			else if (cmp == "map_first_enter") m_first_map_entry_scripts.push_back(std::make_pair(object_id, script));
-			else if (cmp == "item") m_item_scripts.push_back(std::make_pair(object_id, script));
-			else if (cmp == "quest") {
-				vector<pair<int8_t, string>> value;
-				value.push_back(std::make_pair(modifier, script));
-				m_quest_scripts.push_back(std::make_pair(static_cast<game_quest_id>(object_id), value));
-			}
+			if (cmp == "npc") npc_scripts.push_back(std::make_pair(object_id, script));
+			else if (cmp == "reactor") reactor_scripts.push_back(std::make_pair(object_id, script));
+			else if (cmp == "map_enter") map_entry_scripts.push_back(std::make_pair(object_id, script));
+			else if (cmp == "map_first_enter") first_map_entry_scripts.push_back(std::make_pair(object_id, script));
+			else if (cmp == "item") item_scripts.push_back(std::make_pair(object_id, script));
+			else if (cmp == "quest") quest_scripts[static_cast<game_quest_id>(object_id)].push_back(std::make_pair(modifier, script));
 		});
 	}
 
-	std::cout << "DONE" << std::endl;
+	std::atomic_store(&m_npc_scripts, ref_ptr<const npc_index>{make_ref_ptr<npc_index>(std::move(npc_scripts))});
+	m_reactor_scripts = id_index<game_reactor_id, string>{std::move(reactor_scripts)};
+	m_map_entry_scripts = id_index<game_map_id, string>{std::move(map_entry_scripts)};
+	m_first_map_entry_scripts = id_index<game_map_id, string>{std::move(first_map_entry_scripts)};
+	m_item_scripts = id_index<game_item_id, string>{std::move(item_scripts)};
+	m_quest_scripts = id_index<game_quest_id, vector<pair<int8_t, string>>>{std::move(quest_scripts)};
 }
 
 auto script::get_script(abstract_server *server, int32_t object_id, data::type::script_type type) const -> string {
-	if (has_script(object_id, type)) {
-		auto &scripts = resolve(type);
-		for (const auto &script : scripts) {
-			if (script.first == object_id) {
-				string s = build_script_path(type, script.second);
-				if (vana::util::file::exists(s)) {
-					return s;
-				}
+	auto npc_scripts = std::atomic_load(&m_npc_scripts);
+	if (auto script = resolve(type, *npc_scripts).find(object_id)) {
+		string s = build_script_path(type, *script);
+		if (vana::util::file::exists(s)) {
+			return s;
+		}
 #ifdef DEBUG
-				server->log(vana::log::type::debug_error, "Missing script '" + s + "'");
+		server->log(vana::log::type::debug_error, "Missing script '" + s + "'");
 #endif
-				break;
-			}
-		}
 	}
 	return build_script_path(type, std::to_string(object_id));
 }
 
 auto script::get_quest_script(abstract_server *server, game_quest_id quest_id, int8_t state) const -> string {
-	if (has_quest_script(quest_id, state)) {
-		for (const auto &script : m_quest_scripts) {
-			if (script.first != quest_id) {
+	if (auto scripts = m_quest_scripts.find(quest_id)) {
+		for (const auto &script_state : *scripts) {
+			if (script_state.first != state) {
 				continue;
 			}
 
-			for (const auto &script_state : script.second) {
-				if (script_state.first != state) {
-					continue;
-				}
-
-				string s = build_script_path(data::type::script_type::quest, script_state.second);
-				if (vana::util::file::exists(s)) {
-					return s;
-				}
+			string s = build_script_path(data::type::script_type::quest, script_state.second);
+			if (vana::util::file::exists(s)) {
+				return s;
+			}
 #ifdef DEBUG
-				server->log(vana::log::type::debug_error, "Missing quest script '" + s + "'");
+			server->log(vana::log::type::debug_error, "Missing quest script '" + s + "'");
 #endif
-				break;
-			}
-
 			break;
 		}
 	}
@@ -121,37 +103,33 @@ auto script::build_script_path(data::type::script_type type, const string &locat
 }
 
 auto script::has_script(int32_t object_id, data::type::script_type type) const -> bool {
-	return ext::any_of(resolve(type), [object_id](pair<int32_t, string> value) -> bool {
-		return value.first == object_id;
-	});
-
+	auto npc_scripts = std::atomic_load(&m_npc_scripts);
+	return resolve(type, *npc_scripts).contains(object_id);
 }
 
 auto script::has_quest_script(game_quest_id quest_id, int8_t state) const -> bool {
-	return ext::any_of(m_quest_scripts, [quest_id](pair<game_quest_id, vector<pair<int8_t, string>>> value) -> bool {
-		return value.first == quest_id;
-	});
+	return m_quest_scripts.contains(quest_id);
 }
 
 auto script::register_npc_script(game_npc_id npc_id, const string &script) -> void {
-	int32_t index = 0;
-	for (auto &script : m_npc_scripts) {
-		if (script.first == npc_id) {
-			m_npc_scripts.erase(m_npc_scripts.begin() + index);
-			break;
-		}
-		index++;
-	}
-
-	m_npc_scripts.push_back({npc_id, script});
+	// Readers keep whichever index they loaded, the new one is built on the side and published whole
+	// Registration only happens from channel startup, so there's a single writer
+	auto current = std::atomic_load(&m_npc_scripts);
+
+	// The forced script goes first so it wins over the one loaded from the database
+	vector<pair<game_npc_id, string>> scripts;
+	scripts.reserve(current->size() + 1);
+	scripts.emplace_back(npc_id, script);
+	scripts.insert(std::end(scripts), std::begin(*current), std::end(*current));
+	std::atomic_store(&m_npc_scripts, ref_ptr<const npc_index>{make_ref_ptr<npc_index>(std::move(scripts))});
 }
 
-auto script::resolve(data::type::script_type type) const -> const vector<pair<int32_t, string>> & {
+auto script::resolve(data::type::script_type type, const npc_index &npc_scripts) const -> const id_index<int32_t, string> & {
 	switch (type) {
 		case data::type::script_type::item: return m_item_scripts;
 		case data::type::script_type::map_entry: return m_map_entry_scripts;
 		case data::type::script_type::first_map_entry: return m_first_map_entry_scripts;
-		case data::type::script_type::npc: return m_npc_scripts;
+		case data::type::script_type::npc: return npc_scripts;
 		case data::type::script_type::reactor: return m_reactor_scripts;
 	}
 	THROW_CODE_EXCEPTION(not_implemented_exception, "script_type");
@@ -17,8 +17,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "common/data/id_index.hpp"
 #include "common/data/type/script_type.hpp"
 #include "common/types.hpp"
+#include <memory>
 #include <string>
 #include <unordered_map>
 
@@ -39,15 +41,18 @@ namespace vana {
 
 				auto register_npc_script(game_npc_id npc_id, const string &script) -> void;
 			private:
-				auto resolve(data::type::script_type type) const -> const vector<pair<int32_t, string>> &;
+				using npc_index = id_index<game_npc_id, string>;
+
+				auto resolve(data::type::script_type type, const npc_index &npc_scripts) const -> const id_index<int32_t, string> &;
 				auto resolve_path(data::type::script_type type) const -> string;
 
-				vector<pair<game_npc_id, string>> m_npc_scripts;
-				vector<pair<game_reactor_id, string>> m_reactor_scripts;
-				vector<pair<game_map_id, string>> m_map_entry_scripts;
-				vector<pair<game_map_id, string>> m_first_map_entry_scripts;
-				vector<pair<game_item_id, string>> m_item_scripts;
-				vector<pair<game_quest_id, vector<pair<int8_t, string>>>> m_quest_scripts;
+				// Forced scripts are registered while lookups are running, so this index is swapped atomically
+				ref_ptr<const npc_index> m_npc_scripts = make_ref_ptr<npc_index>();
+				id_index<game_reactor_id, string> m_reactor_scripts;
+				id_index<game_map_id, string> m_map_entry_scripts;
+				id_index<game_map_id, string> m_first_map_entry_scripts;
+				id_index<game_item_id, string> m_item_scripts;
+				id_index<game_quest_id, vector<pair<int8_t, string>>> m_quest_scripts;
 			};
 		}
 	}
@@ -18,34 +18,25 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "shop.hpp"
 #include "common/algorithm.hpp"
 #include "common/common_header.hpp"
-#include "common/data/initialize.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/data/provider/item.hpp"
-#include "common/io/database.hpp"
 #include "common/packet_builder.hpp"
 #include "common/session.hpp"
-#include <iomanip>
-#include <iostream>
 
 namespace vana {
 namespace data {
 namespace provider {
 
 auto shop::load_data() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Shops... ";
-
 	load_shops();
 	load_user_shops();
 	load_recharge_tiers();
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto shop::load_shops() -> void {
 	m_shops.clear();
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::shop_data));
+	auto rs = mcdb::select(vana::data::table::shop_data);
 
 	for (const auto &row : rs) {
 		data::type::shop_info info;
@@ -55,7 +46,7 @@ auto shop::load_shops() -> void {
 		m_shops.push_back(info);
 	}
 
-	rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::shop_items) << " ORDER BY shopid, sort DESC");
+	rs = mcdb::select(vana::data::table::shop_items);
 
 	for (const auto &row : rs) {
 		data::type::shop_item_info info;
@@ -78,9 +69,7 @@ auto shop::load_shops() -> void {
 }
 
 auto shop::load_user_shops() -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::user_shop_data));
+	auto rs = mcdb::select(vana::data::table::user_shop_data);
 
 	for (const auto &row : rs) {
 		data::type::shop_info info;
@@ -98,7 +87,7 @@ auto shop::load_user_shops() -> void {
 		m_shops.push_back(info);
 	}
 
-	rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::user_shop_items) << " ORDER BY shopid, sort DESC");
+	rs = mcdb::select(vana::data::table::user_shop_items);
 
 	for (const auto &row : rs) {
 		data::type::shop_item_info info;
@@ -123,9 +112,7 @@ auto shop::load_user_shops() -> void {
 auto shop::load_recharge_tiers() -> void {
 	m_recharge_costs.clear();
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::shop_recharge_data));
+	auto rs = mcdb::select(vana::data::table::shop_recharge_data);
 
 	for (const auto &row : rs) {
 		int8_t recharge_tier = row.get<int8_t>("tierid");
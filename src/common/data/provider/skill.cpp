@@ -17,50 +17,44 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "skill.hpp"
 #include "common/algorithm.hpp"
-#include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
 #include "common/constant/mob_skill.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/util/string.hpp"
-#include <iomanip>
-#include <iostream>
 
 namespace vana {
 namespace data {
 namespace provider {
 
 auto skill::load_data() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Skills... ";
+	skill_level_builder levels;
+	skill_max_level_builder max_levels;
+	load_player_skills(levels, max_levels);
+	load_player_skill_levels(levels, max_levels);
+	m_skill_levels = id_index<game_skill_id, vector<data::type::skill_level_info>>{std::move(levels)};
+	m_skill_max_levels = id_index<game_skill_id, game_skill_level>{std::move(max_levels)};
+
+	mob_skill_builder mob_skills;
+	load_mob_skills(mob_skills);
+	load_mob_summons(mob_skills);
+	m_mob_skills = id_index<game_mob_skill_id, vector<data::type::mob_skill_level_info>>{std::move(mob_skills)};
 
-	load_player_skills();
-	load_player_skill_levels();
-	load_mob_skills();
-	load_mob_summons();
 	load_banish_data();
 	load_morphs();
-
-	std::cout << "DONE" << std::endl;
 }
 
-auto skill::load_player_skills() -> void {
-	m_skill_levels.clear();
-	m_skill_max_levels.clear();
-
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::skill_player_data));
+auto skill::load_player_skills(skill_level_builder &levels, skill_max_level_builder &max_levels) -> void {
+	auto rs = mcdb::select(vana::data::table::skill_player_data);
 
 	for (const auto &row : rs) {
 		game_skill_id skill_id = row.get<game_skill_id>("skillid");
 
-		m_skill_levels.emplace_back(skill_id, vector<data::type::skill_level_info>{});
-		m_skill_max_levels.emplace_back(skill_id, 1);
+		levels.emplace(skill_id, vector<data::type::skill_level_info>{});
+		max_levels.emplace(skill_id, 1);
 	}
 }
 
-auto skill::load_player_skill_levels() -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::skill_player_level_data));
+auto skill::load_player_skill_levels(skill_level_builder &levels, skill_max_level_builder &max_levels) -> void {
+	auto rs = mcdb::select(vana::data::table::skill_player_level_data);
 
 	for (const auto &row : rs) {
 		data::type::skill_level_info info;
@@ -104,44 +98,17 @@ auto skill::load_player_skill_levels() -> void {
 		};
 		info.cool_time = seconds{row.get<int32_t>("cooldown_time")};
 
-		bool found = false;
-		for (auto &skill_level_value : m_skill_levels) {
-			if (skill_level_value.first == skill_id) {
-				found = true;
-				skill_level_value.second.push_back(info);
-				break;
-			}
-		}
+		levels[skill_id].push_back(info);
 
-		if (!found) {
-			vector<data::type::skill_level_info> current;
-			current.push_back(info);
-			m_skill_levels.emplace_back(skill_id, current);
-		}
-
-		found = false;
-		for (auto &max_skill_level : m_skill_max_levels) {
-			if (max_skill_level.first == skill_id) {
-				found = true;
-				if (skill_level > max_skill_level.second) {
-					max_skill_level.second = skill_level;
-				}
-				break;
-			}
-		}
-
-		if (!found) {
-			m_skill_max_levels.emplace_back(skill_id, skill_level);
+		auto max_level = max_levels.emplace(skill_id, skill_level);
+		if (!max_level.second && skill_level > max_level.first->second) {
+			max_level.first->second = skill_level;
 		}
 	}
 }
 
-auto skill::load_mob_skills() -> void {
-	m_mob_skills.clear();
-
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::skill_mob_data));
+auto skill::load_mob_skills(mob_skill_builder &skills) -> void {
+	auto rs = mcdb::select(vana::data::table::skill_mob_data);
 
 	for (const auto &row : rs) {
 		data::type::mob_skill_level_info mob_level;
@@ -164,39 +131,21 @@ auto skill::load_mob_skills() -> void {
 		mob_level.limit = row.get<int16_t>("summon_limit");
 		mob_level.summon_effect = row.get<int8_t>("summon_effect");
 
-		bool found = false;
-		for (auto &skill : m_mob_skills) {
-			if (skill.first == skill_id) {
-				found = true;
-				skill.second.push_back(mob_level);
-				break;
-			}
-		}
-
-		if (!found) {
-			vector<data::type::mob_skill_level_info> current;
-			current.push_back(mob_level);
-			m_mob_skills.emplace_back(skill_id, current);
-		}
+		skills[skill_id].push_back(mob_level);
 	}
 }
 
-auto skill::load_mob_summons() -> void {
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::skill_mob_summons));
+auto skill::load_mob_summons(mob_skill_builder &skills) -> void {
+	auto rs = mcdb::select(vana::data::table::skill_mob_summons);
 
 	for (const auto &row : rs) {
 		game_mob_skill_level level = row.get<game_mob_skill_level>("level");
 		game_mob_id mob_id = row.get<game_mob_id>("mobid");
 
 		bool any = false;
-		for (auto &skill : m_mob_skills) {
-			if (skill.first != constant::mob_skill::summon) {
-				continue;
-			}
-
-			for (auto &skill_level : skill.second) {
+		auto kvp = skills.find(constant::mob_skill::summon);
+		if (kvp != std::end(skills)) {
+			for (auto &skill_level : kvp->second) {
 				if (skill_level.level != level) {
 					continue;
 				}
@@ -211,11 +160,9 @@ auto skill::load_mob_summons() -> void {
 }
 
 auto skill::load_banish_data() -> void {
-	m_banish_info.clear();
+	vector<pair<game_mob_id, data::type::banish_field_info>> banish_info;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::skill_mob_banish_data));
+	auto rs = mcdb::select(vana::data::table::skill_mob_banish_data);
 
 	for (const auto &row : rs) {
 		data::type::banish_field_info banish;
@@ -224,16 +171,16 @@ auto skill::load_banish_data() -> void {
 		banish.field = row.get<game_map_id>("destination");
 		banish.portal = row.get<string>("portal");
 
-		m_banish_info.push_back(banish);
+		banish_info.emplace_back(banish.mob_id, banish);
 	}
+
+	m_banish_info = id_index<game_mob_id, data::type::banish_field_info>{std::move(banish_info)};
 }
 
 auto skill::load_morphs() -> void {
-	m_morph_info.clear();
+	vector<pair<game_morph_id, data::type::morph_info>> morph_info;
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::morph_data));
+	auto rs = mcdb::select(vana::data::table::morph_data);
 
 	for (const auto &row : rs) {
 		data::type::morph_info morph;
@@ -248,50 +195,47 @@ auto skill::load_morphs() -> void {
 		morph.traction = row.get<double>("traction");
 		morph.swim = row.get<double>("swim");
 
-		m_morph_info.push_back(morph);
+		morph_info.emplace_back(morph.id, morph);
 	}
+
+	m_morph_info = id_index<game_morph_id, data::type::morph_info>{std::move(morph_info)};
 }
 
 auto skill::is_valid_skill(game_skill_id skill_id) const -> bool {
-	return ext::any_of(m_skill_levels, [&skill_id](auto value) { return value.first == skill_id; });
+	return m_skill_levels.contains(skill_id);
 }
 
 auto skill::get_max_level(game_skill_id skill_id) const -> game_skill_level {
-	for (const auto &skill : m_skill_max_levels) {
-		if (skill.first == skill_id) {
-			return skill.second;
-		}
+	auto max_level = m_skill_max_levels.find(skill_id);
+	if (max_level != nullptr) {
+		return *max_level;
 	}
 
 	THROW_CODE_EXCEPTION(codepath_invalid_exception);
 }
 
 auto skill::get_skill(game_skill_id skill, game_skill_level level) const -> const data::type::skill_level_info * const {
-	auto skill_ptr = ext::find_value_ptr_if(m_skill_levels, [&skill](auto value) { return value.first == skill; });
+	auto skill_ptr = m_skill_levels.find(skill);
 	if (skill_ptr == nullptr) return nullptr;
 	return ext::find_value_ptr_if(
-		skill_ptr->second,
+		*skill_ptr,
 		[&level](auto value) { return value.level == level; });
 }
 
 auto skill::get_mob_skill(game_mob_skill_id skill, game_mob_skill_level level) const -> const data::type::mob_skill_level_info * const {
-	auto skill_ptr = ext::find_value_ptr_if(m_mob_skills, [&skill](auto value) { return value.first == skill; });
+	auto skill_ptr = m_mob_skills.find(skill);
 	if (skill_ptr == nullptr) return nullptr;
 	return ext::find_value_ptr_if(
-		skill_ptr->second,
+		*skill_ptr,
 		[&level](auto value) { return value.level == level; });
 }
 
 auto skill::get_banish_data(game_mob_id mob_id) const -> const data::type::banish_field_info * const {
-	return ext::find_value_ptr_if(
-		m_banish_info,
-		[&mob_id](auto value) { return value.mob_id == mob_id; });
+	return m_banish_info.find(mob_id);
 }
 
 auto skill::get_morph_data(game_morph_id morph) const -> const data::type::morph_info * const {
-	return ext::find_value_ptr_if(
-		m_morph_info,
-		[&morph](auto value) { return value.id == morph; });
+	return m_morph_info.find(morph);
 }
 
 }
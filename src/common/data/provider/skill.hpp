@@ -18,6 +18,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #pragma once
 
 #include "common/constant/skill.hpp"
+#include "common/data/id_index.hpp"
 #include "common/data/type/banish_field_info.hpp"
 #include "common/data/type/mob_skill_level_info.hpp"
 #include "common/data/type/morph_info.hpp"
@@ -39,18 +40,22 @@ namespace vana {
 				auto get_banish_data(game_mob_id mob_id) const -> const data::type::banish_field_info * const;
 				auto get_morph_data(game_morph_id morph) const -> const data::type::morph_info * const;
 			private:
-				auto load_player_skills() -> void;
-				auto load_player_skill_levels() -> void;
-				auto load_mob_skills() -> void;
-				auto load_mob_summons() -> void;
+				using skill_level_builder = hash_map<game_skill_id, vector<data::type::skill_level_info>>;
+				using skill_max_level_builder = hash_map<game_skill_id, game_skill_level>;
+				using mob_skill_builder = hash_map<game_mob_skill_id, vector<data::type::mob_skill_level_info>>;
+
+				auto load_player_skills(skill_level_builder &levels, skill_max_level_builder &max_levels) -> void;
+				auto load_player_skill_levels(skill_level_builder &levels, skill_max_level_builder &max_levels) -> void;
+				auto load_mob_skills(mob_skill_builder &skills) -> void;
+				auto load_mob_summons(mob_skill_builder &skills) -> void;
 				auto load_banish_data() -> void;
 				auto load_morphs() -> void;
 
-				vector<pair<game_mob_skill_id, vector<data::type::mob_skill_level_info>>> m_mob_skills;
-				vector<pair<game_skill_id, vector<data::type::skill_level_info>>> m_skill_levels;
-				vector<pair<game_skill_id, game_skill_level>> m_skill_max_levels;
-				vector<data::type::banish_field_info> m_banish_info;
-				vector<data::type::morph_info> m_morph_info;
+				id_index<game_mob_skill_id, vector<data::type::mob_skill_level_info>> m_mob_skills;
+				id_index<game_skill_id, vector<data::type::skill_level_info>> m_skill_levels;
+				id_index<game_skill_id, game_skill_level> m_skill_max_levels;
+				id_index<game_mob_id, data::type::banish_field_info> m_banish_info;
+				id_index<game_morph_id, data::type::morph_info> m_morph_info;
 			};
 		}
 	}
@@ -18,12 +18,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "valid_char.hpp"
 #include "common/algorithm.hpp"
 #include "common/constant/gender.hpp"
-#include "common/data/initialize.hpp"
-#include "common/io/database.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/util/game_logic/player.hpp"
 #include "common/util/string.hpp"
-#include <iomanip>
-#include <iostream>
 #include <stdexcept>
 
 namespace vana {
@@ -31,20 +28,14 @@ namespace data {
 namespace provider {
 
 auto valid_char::load_data() -> void {
-	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Initializing Char Info... ";
-
 	load_forbidden_names();
 	load_creation_items();
-
-	std::cout << "DONE" << std::endl;
 }
 
 auto valid_char::load_forbidden_names() -> void {
 	m_forbidden_names.clear();
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::character_forbidden_names));
+	auto rs = mcdb::select(vana::data::table::character_forbidden_names);
 
 	for (const auto &row : rs) {
 		m_forbidden_names.push_back(row.get<string>("forbidden_name"));
@@ -55,9 +46,7 @@ auto valid_char::load_creation_items() -> void {
 	m_adventurer.clear();
 	m_cygnus.clear();
 
-	auto &db = vana::io::database::get_data_db();
-	auto &sql = db.get_session();
-	soci::rowset<> rs = (sql.prepare << "SELECT * FROM " << db.make_table(vana::data::table::character_creation_data));
+	auto rs = mcdb::select(vana::data::table::character_creation_data);
 
 	for (const auto &row : rs) {
 		game_gender_id gender_id = vana::util::game_logic::player::get_gender_id(row.get<string>("gender"));
@@ -21,9 +21,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common/packet_builder.hpp"
 #include "common/util/bit.hpp"
 #include "common/util/randomizer.hpp"
-#include <botan/filters.h>
+#include <botan/block_cipher.h>
 #include <botan/lookup.h>
-#include <botan/pipe.h>
+#include <algorithm>
 
 namespace vana {
 
@@ -39,12 +39,57 @@ const uint8_t aes_key[aes_key_size] = {
 	0x52, 0x00, 0x00, 0x00,
 };
 const int32_t block_size = 1460;
+const int32_t aes_block_size = 16;
+// Enough whole AES blocks to cover the longest chunk
+const int32_t keystream_size = ((block_size + aes_block_size - 1) / aes_block_size) * aes_block_size;
+
+// The key never changes, so the key schedule is expanded once per process and shared by every session
+// get_block_cipher picks the fastest implementation Botan has for the machine (e.g. AES-NI)
+// Encrypting with a keyed block cipher is const and thus safe to use from any io thread
+auto get_aes_cipher() -> const Botan::BlockCipher & {
+	static const owned_ptr<Botan::BlockCipher> cipher = [] {
+		owned_ptr<Botan::BlockCipher> ret{Botan::get_block_cipher("AES-256")};
+		ret->set_key(aes_key, aes_key_size);
+		return ret;
+	}();
+	return *cipher;
+}
+
+// The custom layer rotates by the remaining length, which only matters modulo 8
+// Every rotation and the constants folded around it are looked up instead of computed per byte
+struct shuffle_tables {
+	shuffle_tables() {
+		for (int32_t x = 0; x < 256; ++x) {
+			uint8_t value = static_cast<uint8_t>(x);
+			rotate_left_3[x] = vana::util::bit::rotate_left(value, 3);
+			rotate_left_4[x] = vana::util::bit::rotate_left(value, 4);
+			rotate_right_3[x] = vana::util::bit::rotate_right(value, 3);
+			rotate_right_4[x] = vana::util::bit::rotate_right(value, 4);
+			encrypt_backward_tail[x] = vana::util::bit::rotate_right(static_cast<uint8_t>(value ^ 0x13), 3);
+			decrypt_backward_head[x] = vana::util::bit::rotate_left(value, 3) ^ 0x13;
+			for (int32_t shift = 0; shift < 8; ++shift) {
+				encrypt_forward_tail[shift][x] = static_cast<uint8_t>((vana::util::bit::rotate_right(value, shift) ^ 0xFF) + 0x48);
+				decrypt_forward_head[shift][x] = vana::util::bit::rotate_left(static_cast<uint8_t>((value - 0x48) ^ 0xFF), shift);
+			}
+		}
+	}
+
+	uint8_t rotate_left_3[256];
+	uint8_t rotate_left_4[256];
+	uint8_t rotate_right_3[256];
+	uint8_t rotate_right_4[256];
+	uint8_t encrypt_backward_tail[256];
+	uint8_t decrypt_backward_head[256];
+	uint8_t encrypt_forward_tail[8][256];
+	uint8_t decrypt_forward_head[8][256];
+};
+
+const shuffle_tables tables;
 
 encrypted_packet_transformer::encrypted_packet_transformer(crypto_iv recv_iv, crypto_iv send_iv) :
 	m_recv{recv_iv},
 	m_send{send_iv}
 {
-	m_botan_key = Botan::SymmetricKey{aes_key, aes_key_size};
 }
 
 auto encrypted_packet_transformer::test_packet(unsigned char *header) -> validity_result {
@@ -77,126 +122,103 @@ auto encrypted_packet_transformer::set_packet_header(unsigned char *header, uint
 
 auto encrypted_packet_transformer::encrypt_packet(unsigned char *packet_data, int32_t real_packet_size, uint16_t header_size) -> void {
 	// Custom encryption layer
-	int32_t j;
-	uint8_t a, c;
-	for (uint8_t i = 0; i < 3; ++i) {
-		a = 0;
-		for (j = real_packet_size; j > 0; --j) {
-			c = packet_data[real_packet_size - j];
-			c = vana::util::bit::rotate_left(c, 3);
-			c = static_cast<uint8_t>(c + j); // Guess this is supposed to be right?
-			c = c ^ a;
-			a = c;
-			c = vana::util::bit::rotate_right(a, j);
-			c = c ^ 0xFF;
-			c = c + 0x48;
-			packet_data[real_packet_size - j] = c;
-		}
-		a = 0;
-		for (j = real_packet_size; j > 0; --j) {
-			c = packet_data[j - 1];
-			c = vana::util::bit::rotate_left(c, 4);
-			c = static_cast<uint8_t>(c + j); // Guess this is supposed to be right?
-			c = c ^ a;
-			a = c;
-			c = c ^ 0x13;
-			c = vana::util::bit::rotate_right(c, 3);
-			packet_data[j - 1] = c;
-		}
-	}
+	shuffle_encrypt(packet_data, real_packet_size);
 
 	// Standard AES
-	int32_t pos = 0;
-	uint8_t first = 1;
-	int32_t t_pos = 0;
-	int32_t write_amount = 0;
-	Botan::InitializationVector iv{m_send.get_bytes(), 16};
+	transform_aes(packet_data, real_packet_size, header_size, m_send.get_bytes());
+	m_send.shuffle();
+}
 
-	while (real_packet_size > pos) {
-		t_pos = block_size - first * header_size;
-		write_amount = real_packet_size > (pos + t_pos) ?
-			t_pos :
-			(real_packet_size - pos);
+auto encrypted_packet_transformer::decrypt_packet(unsigned char *packet_data, int32_t real_packet_size, uint16_t header_size) -> void {
+	// Standard AES
+	transform_aes(packet_data, real_packet_size, header_size, m_recv.get_bytes());
+	m_recv.shuffle();
 
-		Botan::Pipe pipe{Botan::get_cipher("AES-256/OFB/NoPadding", m_botan_key, iv, Botan::ENCRYPTION)};
-		pipe.start_msg();
-		pipe.write(packet_data + pos, write_amount);
-		pipe.end_msg();
+	// Custom decryption layer
+	shuffle_decrypt(packet_data, real_packet_size);
+}
 
-		// Process the message and write it into the buffer
-		pipe.read(packet_data + pos, write_amount);
+auto encrypted_packet_transformer::modifies_payload() const -> bool {
+	return true;
+}
 
-		pos += t_pos;
-		if (first) {
-			first = 0;
+auto encrypted_packet_transformer::shuffle_encrypt(unsigned char *packet_data, int32_t real_packet_size) -> void {
+	// Both passes chain every byte on the previous output, so this stays scalar
+	// The countdown only ever feeds additions and rotations, so its low byte is all that is tracked
+	unsigned char *end = packet_data + real_packet_size;
+	for (uint8_t i = 0; i < 3; ++i) {
+		uint8_t a = 0;
+		uint8_t j = static_cast<uint8_t>(real_packet_size);
+		for (unsigned char *cur = packet_data; cur != end; ++cur, --j) {
+			a = static_cast<uint8_t>(tables.rotate_left_3[*cur] + j) ^ a;
+			*cur = tables.encrypt_forward_tail[j & 7][a];
+		}
+
+		a = 0;
+		j = static_cast<uint8_t>(real_packet_size);
+		for (unsigned char *cur = end; cur != packet_data; --j) {
+			--cur;
+			a = static_cast<uint8_t>(tables.rotate_left_4[*cur] + j) ^ a;
+			*cur = tables.encrypt_backward_tail[a];
 		}
 	}
+}
 
-	m_send.shuffle();
+auto encrypted_packet_transformer::shuffle_decrypt(unsigned char *packet_data, int32_t real_packet_size) -> void {
+	// Each output byte only depends on its own input and the input before it, never on a previous output
+	unsigned char *end = packet_data + real_packet_size;
+	for (uint8_t i = 0; i < 3; ++i) {
+		uint8_t b = 0;
+		uint8_t j = static_cast<uint8_t>(real_packet_size);
+		for (unsigned char *cur = end; cur != packet_data; --j) {
+			--cur;
+			uint8_t a = tables.decrypt_backward_head[*cur];
+			*cur = tables.rotate_right_4[static_cast<uint8_t>((a ^ b) - j)];
+			b = a;
+		}
+
+		b = 0;
+		j = static_cast<uint8_t>(real_packet_size);
+		for (unsigned char *cur = packet_data; cur != end; ++cur, --j) {
+			uint8_t a = tables.decrypt_forward_head[j & 7][*cur];
+			*cur = tables.rotate_right_3[static_cast<uint8_t>((a ^ b) - j)];
+			b = a;
+		}
+	}
 }
 
-auto encrypted_packet_transformer::decrypt_packet(unsigned char *packet_data, int32_t real_packet_size, uint16_t header_size) -> void {
-	// Standard AES
+auto encrypted_packet_transformer::transform_aes(unsigned char *packet_data, int32_t real_packet_size, uint16_t header_size, unsigned char const * const iv) -> void {
+	// OFB is symmetric, so encryption and decryption are the same XOR with the keystream
+	// Every chunk restarts the keystream from the same IV, so it is generated only once per packet and only as far as the longest chunk
+	const Botan::BlockCipher &cipher = get_aes_cipher();
+	int32_t needed = std::min(real_packet_size, block_size);
+	unsigned char keystream[keystream_size];
+	unsigned char const *feedback = iv;
+	for (int32_t offset = 0; offset < needed; offset += aes_block_size) {
+		cipher.encrypt(feedback, keystream + offset);
+		feedback = keystream + offset;
+	}
+
 	int32_t pos = 0;
 	uint8_t first = 1;
 	int32_t t_pos = 0;
-	int32_t read_amount = 0;
-	Botan::InitializationVector iv{m_recv.get_bytes(), 16};
-
+	int32_t amount = 0;
 	while (real_packet_size > pos) {
 		t_pos = block_size - first * header_size;
-		read_amount = real_packet_size > (pos + t_pos) ?
+		amount = real_packet_size > (pos + t_pos) ?
 			t_pos :
 			(real_packet_size - pos);
 
-		Botan::Pipe pipe{Botan::get_cipher("AES-256/OFB/NoPadding", m_botan_key, iv, Botan::DECRYPTION)};
-		pipe.start_msg();
-		pipe.write(packet_data + pos, read_amount);
-		pipe.end_msg();
-
-		// Process the message and write it into the buffer
-		pipe.read(packet_data + pos, read_amount);
+		unsigned char *chunk = packet_data + pos;
+		for (int32_t i = 0; i < amount; ++i) {
+			chunk[i] ^= keystream[i];
+		}
 
 		pos += t_pos;
 		if (first) {
 			first = 0;
 		}
 	}
-
-	m_recv.shuffle();
-
-	// Custom decryption layer
-	int32_t j;
-	uint8_t a, b, c;
-	for (uint8_t i = 0; i < 3; i++) {
-		a = 0;
-		b = 0;
-		for (j = real_packet_size; j > 0; j--) {
-			c = packet_data[j - 1];
-			c = vana::util::bit::rotate_left(c, 3);
-			c = c ^ 0x13;
-			a = c;
-			c = c ^ b;
-			c = static_cast<uint8_t>(c - j); // Guess this is supposed to be right?
-			c = vana::util::bit::rotate_right(c, 4);
-			b = a;
-			packet_data[j - 1] = c;
-		}
-		a = 0;
-		b = 0;
-		for (j = real_packet_size; j > 0; j--) {
-			c = packet_data[real_packet_size - j];
-			c = c - 0x48;
-			c = c ^ 0xFF;
-			c = vana::util::bit::rotate_left(c, j);
-			a = c;
-			c = c ^ b;
-			c = static_cast<uint8_t>(c - j); // Guess this is supposed to be right?
-			c = vana::util::bit::rotate_right(c, 3);
-			b = a;
-			packet_data[real_packet_size - j] = c;
-		}
-	}
 }
 
 auto encrypted_packet_transformer::get_version_and_size(unsigned char *header, uint16_t &version, uint16_t &size) -> void {
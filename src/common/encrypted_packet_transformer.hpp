@@ -21,7 +21,6 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common/block_cipher_iv.hpp"
 #include "common/packet_transformer.hpp"
 #include "common/types.hpp"
-#include <botan/lookup.h>
 
 namespace vana {
 	class encrypted_packet_transformer final : public packet_transformer {
@@ -32,11 +31,14 @@ namespace vana {
 		auto set_packet_header(unsigned char *header, uint16_t real_packet_size) -> void override;
 		auto encrypt_packet(unsigned char *packet_data, int32_t real_packet_size, uint16_t header_size) -> void override;
 		auto decrypt_packet(unsigned char *packet_data, int32_t real_packet_size, uint16_t header_size) -> void override;
+		auto modifies_payload() const -> bool override;
 	private:
 		auto get_version_and_size(unsigned char *header, uint16_t &version, uint16_t &size) -> void;
+		static auto shuffle_encrypt(unsigned char *packet_data, int32_t real_packet_size) -> void;
+		static auto shuffle_decrypt(unsigned char *packet_data, int32_t real_packet_size) -> void;
+		static auto transform_aes(unsigned char *packet_data, int32_t real_packet_size, uint16_t header_size, unsigned char const * const iv) -> void;
 
 		block_cipher_iv m_recv;
 		block_cipher_iv m_send;
-		Botan::OctetString m_botan_key;
 	};
 }
\ No newline at end of file
@@ -21,7 +21,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common/soci_extensions.hpp"
 #include "common/util/game_logic/inventory.hpp"
 #include "common/util/misc.hpp"
+#include "common/util/string.hpp"
 #include <soci.h>
+#include <algorithm>
 
 namespace vana {
 
@@ -95,6 +97,34 @@ auto item::has_trade_block() const -> bool {
 	return test_flags(constant::item::flag::trade_unavailable);
 }
 
+auto item::has_same_data(const item &other) const -> bool {
+	return
+		m_id == other.m_id &&
+		m_amount == other.m_amount &&
+		m_slots == other.m_slots &&
+		m_scrolls == other.m_scrolls &&
+		m_str == other.m_str &&
+		m_dex == other.m_dex &&
+		m_int == other.m_int &&
+		m_luk == other.m_luk &&
+		m_hp == other.m_hp &&
+		m_mp == other.m_mp &&
+		m_watk == other.m_watk &&
+		m_matk == other.m_matk &&
+		m_wdef == other.m_wdef &&
+		m_mdef == other.m_mdef &&
+		m_accuracy == other.m_accuracy &&
+		m_avoid == other.m_avoid &&
+		m_hands == other.m_hands &&
+		m_speed == other.m_speed &&
+		m_jump == other.m_jump &&
+		m_flags == other.m_flags &&
+		m_hammers == other.m_hammers &&
+		m_pet_id == other.m_pet_id &&
+		m_expiration == other.m_expiration &&
+		m_name == other.m_name;
+}
+
 auto item::test_flags(int16_t flags) const -> bool {
 	return (m_flags & flags) != 0;
 }
@@ -344,87 +374,63 @@ auto item::database_insert(vana::io::database &db, const vector<item_db_record>
 	static init_list<int64_t> nulls_expiration = {0, constant::item::no_expiration.get_value()};
 	static init_list<string> nulls_string = {""};
 
+	// Every item is a row of one multi-row INSERT, so a chunk of items costs a single round trip
+	// The chunk size keeps the statement well under the default max_allowed_packet
+	const size_t rows_per_insert = 100;
+
 	using opt_game_stat = optional<game_stat>;
 	using opt_game_health = optional<game_health>;
 
-	uint8_t inventory = 0;
-	game_slot_qty amount = 0;
-	game_item_id item_id = 0;
-	game_inventory_slot slot = 0;
-	game_world_id world_id = 0;
-	game_account_id account_id = 0;
-	game_player_id player_id = 0;
-	string location = "";
-
-	opt_int8_t slots;
-	opt_int8_t scrolls;
-	opt_game_stat str;
-	opt_game_stat dex;
-	opt_game_stat intl;
-	opt_game_stat luk;
-	opt_game_health hp;
-	opt_game_health mp;
-	opt_game_stat watk;
-	opt_game_stat matk;
-	opt_game_stat wdef;
-	opt_game_stat mdef;
-	opt_game_stat acc;
-	opt_game_stat avo;
-	opt_game_stat hands;
-	opt_game_stat speed;
-	opt_game_stat jump;
-	opt_int16_t flags;
-	opt_int32_t hammers;
-	optional<game_pet_id> pet_id;
-	opt_int64_t expiration;
-	opt_string name;
-
-	statement st = (sql.prepare
-		<< "INSERT INTO " << db.make_table(vana::table::items) << " (character_id, inv, slot, location, account_id, world_id, item_id, amount, slots, scrolls, istr, idex, iint, iluk, ihp, imp, iwatk, imatk, iwdef, imdef, iacc, iavo, ihand, ispeed, ijump, flags, hammers, pet_id, name, expiration) "
-		<< "VALUES (:char, :inv, :slot, :location, :account, :world, :item_id, :amount, :slots, :scrolls, :str, :dex, :int, :luk, :hp, :mp, :watk, :matk, :wdef, :mdef, :acc, :avo, :hands, :speed, :jump, :flags, :hammers, :pet, :name, :expiration)",
-		use(player_id, "char"),
-		use(inventory, "inv"),
-		use(slot, "slot"),
-		use(location, "location"),
-		use(account_id, "account"),
-		use(world_id, "world"),
-		use(item_id, "item_id"),
-		use(amount, "amount"),
-		use(slots, "slots"),
-		use(scrolls, "scrolls"),
-		use(str, "str"),
-		use(dex, "dex"),
-		use(intl, "int"),
-		use(luk, "luk"),
-		use(hp, "hp"),
-		use(mp, "mp"),
-		use(watk, "watk"),
-		use(matk, "matk"),
-		use(wdef, "wdef"),
-		use(mdef, "mdef"),
-		use(acc, "acc"),
-		use(avo, "avo"),
-		use(hands, "hands"),
-		use(speed, "speed"),
-		use(jump, "jump"),
-		use(flags, "flags"),
-		use(hammers, "hammers"),
-		use(pet_id, "pet"),
-		use(name, "name"),
-		use(expiration, "expiration"));
+	struct item_row {
+		uint8_t inventory = 0;
+		game_slot_qty amount = 0;
+		game_item_id item_id = 0;
+		game_inventory_slot slot = 0;
+		game_world_id world_id = 0;
+		game_account_id account_id = 0;
+		game_player_id player_id = 0;
+		string location = "";
+
+		opt_int8_t slots;
+		opt_int8_t scrolls;
+		opt_game_stat str;
+		opt_game_stat dex;
+		opt_game_stat intl;
+		opt_game_stat luk;
+		opt_game_health hp;
+		opt_game_health mp;
+		opt_game_stat watk;
+		opt_game_stat matk;
+		opt_game_stat wdef;
+		opt_game_stat mdef;
+		opt_game_stat acc;
+		opt_game_stat avo;
+		opt_game_stat hands;
+		opt_game_stat speed;
+		opt_game_stat jump;
+		opt_int16_t flags;
+		opt_int32_t hammers;
+		optional<game_pet_id> pet_id;
+		opt_int64_t expiration;
+		opt_string name;
+	};
+
+	vector<item_row> rows;
+	rows.reserve(items.size());
 
 	for (const auto &rec : items) {
 		item *item = rec.item;
-
-		location = rec.location;
-		account_id = rec.user_id;
-		player_id = rec.char_id;
-		world_id = rec.world_id;
-		slot = rec.slot;
-		amount = item->m_amount;
-		item_id = item->m_id;
-		inventory = vana::util::game_logic::inventory::get_inventory(item_id);
-		bool equip = (inventory == constant::inventory::equip);
+		item_row row;
+
+		row.location = rec.location;
+		row.account_id = rec.user_id;
+		row.player_id = rec.char_id;
+		row.world_id = rec.world_id;
+		row.slot = rec.slot;
+		row.amount = item->m_amount;
+		row.item_id = item->m_id;
+		row.inventory = vana::util::game_logic::inventory::get_inventory(row.item_id);
+		bool equip = (row.inventory == constant::inventory::equip);
 		nullable_mode nulls = (equip ?
 			nullable_mode::null_if_found :
 			nullable_mode::force_null);
@@ -446,33 +452,90 @@ auto item::database_insert(vana::io::database &db, const vector<item_db_record>
 			nullable_mode::force_not_null;
 
 		// Equip only
-		slots = get_optional(item->m_slots, equip_only_required, nulls_int8);
-		scrolls = get_optional(item->m_scrolls, equip_only_required, nulls_int8);
-		str = get_optional(item->m_str, equip_only, nulls_int16);
-		dex = get_optional(item->m_dex, equip_only, nulls_int16);
-		intl = get_optional(item->m_int, equip_only, nulls_int16);
-		luk = get_optional(item->m_luk, equip_only, nulls_int16);
-		hp = get_optional(item->m_hp, equip_only, nulls_int16);
-		mp = get_optional(item->m_mp, equip_only, nulls_int16);
-		watk = get_optional(item->m_watk, equip_only, nulls_int16);
-		matk = get_optional(item->m_matk, equip_only, nulls_int16);
-		wdef = get_optional(item->m_wdef, equip_only, nulls_int16);
-		mdef = get_optional(item->m_mdef, equip_only, nulls_int16);
-		acc = get_optional(item->m_accuracy, equip_only, nulls_int16);
-		avo = get_optional(item->m_avoid, equip_only, nulls_int16);
-		hands = get_optional(item->m_hands, equip_only, nulls_int16);
-		speed = get_optional(item->m_speed, equip_only, nulls_int16);
-		jump = get_optional(item->m_jump, equip_only, nulls_int16);
-		flags = get_optional(item->m_flags, equip_only, nulls_int16);
-		hammers = get_optional(item->m_hammers, equip_only, nulls_int32);
+		row.slots = get_optional(item->m_slots, equip_only_required, nulls_int8);
+		row.scrolls = get_optional(item->m_scrolls, equip_only_required, nulls_int8);
+		row.str = get_optional(item->m_str, equip_only, nulls_int16);
+		row.dex = get_optional(item->m_dex, equip_only, nulls_int16);
+		row.intl = get_optional(item->m_int, equip_only, nulls_int16);
+		row.luk = get_optional(item->m_luk, equip_only, nulls_int16);
+		row.hp = get_optional(item->m_hp, equip_only, nulls_int16);
+		row.mp = get_optional(item->m_mp, equip_only, nulls_int16);
+		row.watk = get_optional(item->m_watk, equip_only, nulls_int16);
+		row.matk = get_optional(item->m_matk, equip_only, nulls_int16);
+		row.wdef = get_optional(item->m_wdef, equip_only, nulls_int16);
+		row.mdef = get_optional(item->m_mdef, equip_only, nulls_int16);
+		row.acc = get_optional(item->m_accuracy, equip_only, nulls_int16);
+		row.avo = get_optional(item->m_avoid, equip_only, nulls_int16);
+		row.hands = get_optional(item->m_hands, equip_only, nulls_int16);
+		row.speed = get_optional(item->m_speed, equip_only, nulls_int16);
+		row.jump = get_optional(item->m_jump, equip_only, nulls_int16);
+		row.flags = get_optional(item->m_flags, equip_only, nulls_int16);
+		row.hammers = get_optional(item->m_hammers, equip_only, nulls_int32);
 
 		// Non-equip only
-		pet_id = get_optional(item->m_pet_id, nonequip_only, nulls_int64);
+		row.pet_id = get_optional(item->m_pet_id, nonequip_only, nulls_int64);
 
 		// All items
-		name = get_optional(item->m_name, nullable_mode::null_if_found, nulls_string);
-		expiration = get_optional(item->m_expiration.get_value(), nullable_mode::null_if_found, nulls_expiration);
+		row.name = get_optional(item->m_name, nullable_mode::null_if_found, nulls_string);
+		row.expiration = get_optional(item->m_expiration.get_value(), nullable_mode::null_if_found, nulls_expiration);
+
+		rows.push_back(row);
+	}
 
+	for (size_t offset = 0; offset < rows.size(); offset += rows_per_insert) {
+		size_t count = std::min(rows_per_insert, rows.size() - offset);
+		out_stream query;
+		query
+			<< "INSERT INTO " << db.make_table(vana::table::items) << " (character_id, inv, slot, location, account_id, world_id, item_id, amount, slots, scrolls, istr, idex, iint, iluk, ihp, imp, iwatk, imatk, iwdef, imdef, iacc, iavo, ihand, ispeed, ijump, flags, hammers, pet_id, name, expiration) "
+			<< "VALUES ";
+
+		statement st{sql};
+		for (size_t i = 0; i < count; ++i) {
+			item_row &row = rows[offset + i];
+			string n = vana::util::str::lexical_cast<string>(i);
+			if (i != 0) {
+				query << ", ";
+			}
+			query << "(:char" << n << ", :inv" << n << ", :slot" << n << ", :location" << n << ", :account" << n << ", :world" << n << ", :item_id" << n << ", :amount" << n << ", "
+				<< ":slots" << n << ", :scrolls" << n << ", :str" << n << ", :dex" << n << ", :int" << n << ", :luk" << n << ", :hp" << n << ", :mp" << n << ", "
+				<< ":watk" << n << ", :matk" << n << ", :wdef" << n << ", :mdef" << n << ", :acc" << n << ", :avo" << n << ", :hands" << n << ", :speed" << n << ", :jump" << n << ", "
+				<< ":flags" << n << ", :hammers" << n << ", :pet" << n << ", :name" << n << ", :expiration" << n << ")";
+
+			st.exchange(use(row.player_id, "char" + n));
+			st.exchange(use(row.inventory, "inv" + n));
+			st.exchange(use(row.slot, "slot" + n));
+			st.exchange(use(row.location, "location" + n));
+			st.exchange(use(row.account_id, "account" + n));
+			st.exchange(use(row.world_id, "world" + n));
+			st.exchange(use(row.item_id, "item_id" + n));
+			st.exchange(use(row.amount, "amount" + n));
+			st.exchange(use(row.slots, "slots" + n));
+			st.exchange(use(row.scrolls, "scrolls" + n));
+			st.exchange(use(row.str, "str" + n));
+			st.exchange(use(row.dex, "dex" + n));
+			st.exchange(use(row.intl, "int" + n));
+			st.exchange(use(row.luk, "luk" + n));
+			st.exchange(use(row.hp, "hp" + n));
+			st.exchange(use(row.mp, "mp" + n));
+			st.exchange(use(row.watk, "watk" + n));
+			st.exchange(use(row.matk, "matk" + n));
+			st.exchange(use(row.wdef, "wdef" + n));
+			st.exchange(use(row.mdef, "mdef" + n));
+			st.exchange(use(row.acc, "acc" + n));
+			st.exchange(use(row.avo, "avo" + n));
+			st.exchange(use(row.hands, "hands" + n));
+			st.exchange(use(row.speed, "speed" + n));
+			st.exchange(use(row.jump, "jump" + n));
+			st.exchange(use(row.flags, "flags" + n));
+			st.exchange(use(row.hammers, "hammers" + n));
+			st.exchange(use(row.pet_id, "pet" + n));
+			st.exchange(use(row.name, "name" + n));
+			st.exchange(use(row.expiration, "expiration" + n));
+		}
+
+		st.alloc();
+		st.prepare(query.str());
+		st.define_and_bind();
 		st.execute(true);
 	}
 }
@@ -50,6 +50,8 @@ namespace vana {
 		auto has_lock() const -> bool;
 		auto has_karma() const -> bool;
 		auto has_trade_block() const -> bool;
+		// Compares everything that's stored in the database for an item
+		auto has_same_data(const item &other) const -> bool;
 
 		auto get_slots() const -> int8_t { return m_slots; }
 		auto get_scrolls() const -> int8_t { return m_scrolls; }
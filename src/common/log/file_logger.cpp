@@ -16,13 +16,15 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "file_logger.hpp"
+#include "common/util/thread_pool.hpp"
 #include "common/util/time.hpp"
 #ifdef WIN32
 #include <filesystem>
 #else
 #include <boost/filesystem.hpp>
 #endif
-#include <fstream>
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -41,7 +43,19 @@ file_logger::file_logger(const string &filename, const string &format, const str
 	m_buffer_size{buffer_size},
 	m_filename_format{filename}
 {
-	m_buffer.reserve(buffer_size);
+	m_thread = vana::util::thread_pool::lease(
+		[this](owned_lock<recursive_mutex> &lock) {
+			// Anything short of a full buffer still gets written within a second
+			if (m_queued.load(std::memory_order_relaxed) < m_buffer_size) {
+				m_wake.wait_for(lock, std::chrono::seconds{1});
+			}
+			write_queued();
+		},
+		[this] {
+			owned_lock<recursive_mutex> l{m_mutex};
+			m_wake.notify_one();
+		},
+		m_mutex);
 }
 
 file_logger::~file_logger() {
@@ -49,27 +63,67 @@ file_logger::~file_logger() {
 }
 
 auto file_logger::log(vana::log::type type, const opt_string &identifier, const string &message) -> void {
+	log(type, identifier, message, time(nullptr));
+}
+
+auto file_logger::log(vana::log::type type, const opt_string &identifier, const string &message, time_t time) -> void {
 	file_log file;
-	file.message = base_logger::format_log(get_format(), type, this, identifier, message);
-	file.file = base_logger::format_log(get_filename_format(), type, this, identifier, message);
-	m_buffer.push_back(file);
-	if (m_buffer.size() >= m_buffer_size) {
-		flush();
+	file.message = base_logger::format_log(get_format(), type, this, time, identifier, message);
+	file.file = base_logger::format_log(get_filename_format(), type, this, time, identifier, message);
+	m_queue.push(file);
+	if (m_queued.fetch_add(1, std::memory_order_relaxed) + 1 >= m_buffer_size) {
+		m_wake.notify_one();
 	}
 }
 
 auto file_logger::flush() -> void {
-	for (const auto &buffered_message : m_buffer) {
-		const string &file = buffered_message.file;
-		fs::path fullPath = fs::system_complete(fs::path{file.substr(0, file.find_last_of("/"))});
-		if (!fs::exists(fullPath)) {
-			fs::create_directories(fullPath);
+	owned_lock<recursive_mutex> l{m_mutex};
+	write_queued();
+}
+
+auto file_logger::write_queued() -> void {
+	vector<file_log> batch = m_queue.take_all();
+	m_queued.fetch_sub(batch.size(), std::memory_order_relaxed);
+	time_point now = vana::util::time::get_now();
+
+	vector<std::ofstream *> written;
+	for (const auto &buffered_message : batch) {
+		std::ofstream &f = get_file(buffered_message.file, now);
+		f << buffered_message.message << '\n';
+		if (std::find(std::begin(written), std::end(written), &f) == std::end(written)) {
+			written.push_back(&f);
 		}
-		std::fstream f{file, std::ios_base::out};
-		f << buffered_message.message;
-		f.close();
 	}
-	m_buffer.clear();
+
+	for (auto f : written) {
+		f->flush();
+	}
+
+	for (auto iter = std::begin(m_files); iter != std::end(m_files); ) {
+		if (now - iter->second->last_write >= std::chrono::minutes{1}) {
+			iter = m_files.erase(iter);
+		}
+		else {
+			++iter;
+		}
+	}
+}
+
+auto file_logger::get_file(const string &filename, time_point now) -> std::ofstream & {
+	auto kvp = m_files.find(filename);
+	if (kvp == std::end(m_files)) {
+		fs::path full_path = fs::system_complete(fs::path{filename.substr(0, filename.find_last_of("/"))});
+		if (!fs::exists(full_path)) {
+			fs::create_directories(full_path);
+		}
+
+		auto file = make_owned_ptr<open_file>();
+		file->stream.open(filename, std::ios_base::out | std::ios_base::app);
+		kvp = m_files.emplace(filename, std::move(file)).first;
+	}
+
+	kvp->second->last_write = now;
+	return kvp->second->stream;
 }
 
 }
@@ -18,7 +18,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #pragma once
 
 #include "common/log/base_logger.hpp"
+#include "common/util/mpsc_queue.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace vana {
@@ -28,18 +33,37 @@ namespace vana {
 			string file;
 		};
 
+		// Logging only formats the message and queues it, a writer thread appends queued messages to their files in batches
+		// Files stay open between batches and are closed once they haven't been written to for a while, e.g. after the date in the filename moves on
 		class file_logger : public base_logger {
 		public:
 			file_logger(const string &filename, const string &format, const string &time_format, server_type type, size_t buffer_size = 10);
 			~file_logger();
 
 			auto log(vana::log::type type, const opt_string &identifier, const string &message) -> void override;
+			// For messages that were raised at an earlier time
+			auto log(vana::log::type type, const opt_string &identifier, const string &message, time_t time) -> void;
+			// Writes everything queued so far on the calling thread
 			auto flush() -> void;
 			auto get_filename_format() const -> const string & { return m_filename_format; }
 		private:
+			struct open_file {
+				std::ofstream stream;
+				time_point last_write;
+			};
+
+			auto write_queued() -> void;
+			auto get_file(const string &filename, time_point now) -> std::ofstream &;
+
 			string m_filename_format;
 			size_t m_buffer_size;
-			vector<file_log> m_buffer;
+			std::atomic<size_t> m_queued{0};
+			vana::util::mpsc_queue<file_log> m_queue;
+			// Everything below is only touched by whoever holds m_mutex, the writer thread or a flush
+			hash_map<string, owned_ptr<open_file>> m_files;
+			std::condition_variable_any m_wake;
+			recursive_mutex m_mutex;
+			ref_ptr<std::thread> m_thread;
 		};
 	}
 }
\ No newline at end of file
@@ -17,15 +17,38 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "sql_logger.hpp"
 #include "common/io/database.hpp"
+#include "common/util/string.hpp"
+#include "common/util/thread_pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <exception>
 
 namespace vana {
 namespace log {
 
+// Past this many unwritten messages the database is considered to be falling behind
+const size_t max_queued_messages = 10000;
+const size_t rows_per_insert = 100;
+
 sql_logger::sql_logger(const string &filename, const string &format, const string &time_format, server_type type, size_t buffer_size) :
 	base_logger{filename, format, time_format, type, buffer_size},
 	m_buffer_size{buffer_size}
 {
-	m_buffer.reserve(buffer_size);
+	m_spill = make_owned_ptr<file_logger>("logs/%orig/%YY%MM%DD_sql_spill.log", "[%e (%t)] %id - %msg", time_format, type, buffer_size);
+
+	m_thread = vana::util::thread_pool::lease(
+		[this](owned_lock<recursive_mutex> &lock) {
+			// Anything short of a full buffer still gets written within a second
+			if (m_queued.load(std::memory_order_relaxed) < m_buffer_size) {
+				m_wake.wait_for(lock, std::chrono::seconds{1});
+			}
+			write_queued();
+		},
+		[this] {
+			owned_lock<recursive_mutex> l{m_mutex};
+			m_wake.notify_one();
+		},
+		m_mutex);
 }
 
 sql_logger::~sql_logger() {
@@ -38,44 +61,106 @@ auto sql_logger::log(vana::log::type type, const opt_string &identifier, const s
 	m.message = message;
 	m.time = time(nullptr);
 	m.identifier = identifier;
-	m_buffer.push_back(m);
-	if (m_buffer.size() >= m_buffer_size) {
-		flush();
+
+	size_t queued = m_queued.fetch_add(1, std::memory_order_relaxed) + 1;
+	if (queued > max_queued_messages) {
+		m_queued.fetch_sub(1, std::memory_order_relaxed);
+		spill(m);
+		return;
+	}
+
+	m_queue.push(m);
+	if (queued >= m_buffer_size) {
+		m_wake.notify_one();
 	}
 }
 
 auto sql_logger::flush() -> void {
-	if (m_buffer.size() > 0) {
-		auto &db = vana::io::database::get_char_db();
-		auto &sql = db.get_session();
-		server_type_underlying type = static_cast<server_type_underlying>(get_server_type());
+	owned_lock<recursive_mutex> l{m_mutex};
+	write_queued();
+}
+
+auto sql_logger::write_queued() -> void {
+	vector<sql_log> batch = m_queue.take_all();
+	if (batch.size() == 0) {
+		return;
+	}
+
+	size_t written = 0;
+	try {
+		insert(batch, written);
+	}
+	catch (std::exception &) {
+		// Failed batches aren't retried, which would only build up a backlog while the database is unavailable
+		// Chunks inserted before the failure are already in the database, so only the rest is spilled
+		for (size_t i = written; i < batch.size(); i++) {
+			spill(batch[i]);
+		}
+	}
+
+	// Messages only stop counting against the limit once they're written, so a slow database pushes new ones to the spill file
+	m_queued.fetch_sub(batch.size(), std::memory_order_relaxed);
+}
+
+auto sql_logger::insert(const vector<sql_log> &batch, size_t &written) -> void {
+	auto &db = vana::io::database::get_char_db();
+	auto &sql = db.get_session();
+	server_type_underlying origin = static_cast<server_type_underlying>(get_server_type());
+
+	struct log_row {
+		server_type_underlying origin;
+		unix_time log_time;
 		int32_t log_type = 0;
 		opt_string identifier;
-		// For GCC, GCC doesn't interpret operators very well
-		identifier = "";
-		string message = "";
-		unix_time log_time;
+		string message;
+	};
 
-		soci::statement st = (sql.prepare
+	vector<log_row> rows;
+	rows.reserve(batch.size());
+	for (const auto &buffered_message : batch) {
+		log_row row;
+		row.origin = origin;
+		row.log_time = buffered_message.time;
+		row.log_type = static_cast<int32_t>(buffered_message.type);
+		row.identifier = buffered_message.identifier;
+		row.message = buffered_message.message;
+		rows.push_back(row);
+	}
+
+	for (size_t offset = 0; offset < rows.size(); offset += rows_per_insert) {
+		size_t count = std::min(rows_per_insert, rows.size() - offset);
+		out_stream query;
+		query
 			<< "INSERT INTO " << db.make_table(vana::table::logs) << " (log_time, origin, info_type, identifier, message) "
-			<< "VALUES (:time, :origin, :info_type, :identifier, :message)",
-			soci::use(log_time, "time"),
-			soci::use(type, "origin"),
-			soci::use(log_type, "info_type"),
-			soci::use(identifier, "identifier"),
-			soci::use(message, "message"));
-
-		for (const auto &buffered_message : m_buffer) {
-			log_type = static_cast<int32_t>(buffered_message.type);
-			log_time = buffered_message.time;
-			identifier = buffered_message.identifier;
-			message = buffered_message.message;
-			st.execute(true);
+			<< "VALUES ";
+
+		soci::statement st{sql};
+		for (size_t i = 0; i < count; ++i) {
+			log_row &row = rows[offset + i];
+			string n = vana::util::str::lexical_cast<string>(i);
+			if (i != 0) {
+				query << ", ";
+			}
+			query << "(:time" << n << ", :origin" << n << ", :info_type" << n << ", :identifier" << n << ", :message" << n << ")";
+
+			st.exchange(soci::use(row.log_time, "time" + n));
+			st.exchange(soci::use(row.origin, "origin" + n));
+			st.exchange(soci::use(row.log_type, "info_type" + n));
+			st.exchange(soci::use(row.identifier, "identifier" + n));
+			st.exchange(soci::use(row.message, "message" + n));
 		}
 
-		m_buffer.clear();
+		st.alloc();
+		st.prepare(query.str());
+		st.define_and_bind();
+		st.execute(true);
+		written += count;
 	}
 }
 
+auto sql_logger::spill(const sql_log &message) -> void {
+	m_spill->log(message.type, message.identifier, message.message, message.time);
+}
+
 }
 }
\ No newline at end of file
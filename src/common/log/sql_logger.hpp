@@ -18,7 +18,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #pragma once
 
 #include "common/log/base_logger.hpp"
+#include "common/log/file_logger.hpp"
+#include "common/util/mpsc_queue.hpp"
+#include <atomic>
+#include <condition_variable>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace vana {
@@ -30,16 +35,28 @@ namespace vana {
 			opt_string identifier;
 		};
 
+		// Logging only queues the message, a writer thread inserts queued messages in batches on its own database connection
+		// If the database falls behind or fails, messages go to a spill file instead so that logging never holds up the caller
 		class sql_logger : public base_logger {
 		public:
 			sql_logger(const string &filename, const string &format, const string &time_format, server_type type, size_t buffer_size = 10);
 			~sql_logger();
 
 			auto log(vana::log::type type, const opt_string &identifier, const string &message) -> void override;
+			// Writes everything queued so far on the calling thread
 			auto flush() -> void;
 		private:
+			auto write_queued() -> void;
+			auto insert(const vector<sql_log> &batch, size_t &written) -> void;
+			auto spill(const sql_log &message) -> void;
+
 			size_t m_buffer_size;
-			vector<sql_log> m_buffer;
+			std::atomic<size_t> m_queued{0};
+			vana::util::mpsc_queue<sql_log> m_queue;
+			owned_ptr<file_logger> m_spill;
+			std::condition_variable_any m_wake;
+			recursive_mutex m_mutex;
+			ref_ptr<std::thread> m_thread;
 		};
 	}
 }
\ No newline at end of file
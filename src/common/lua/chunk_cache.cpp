@@ -0,0 +1,100 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "chunk_cache.hpp"
+#include "common/util/file.hpp"
+#include "common/util/time.hpp"
+
+extern "C" {
+	#include <lauxlib.h>
+}
+
+namespace vana {
+namespace lua {
+
+hash_map<string, chunk_cache::entry> chunk_cache::s_entries;
+mutex chunk_cache::s_mutex;
+
+static const seconds check_interval{2};
+
+static auto write_bytecode(lua_State *lua_vm, const void *data, size_t size, void *out) -> int {
+	static_cast<string *>(out)->append(static_cast<const char *>(data), size);
+	return 0;
+}
+
+auto chunk_cache::refresh(const string &filename) -> entry & {
+	time_point now = vana::util::time::get_now();
+	auto kvp = s_entries.find(filename);
+	if (kvp != std::end(s_entries) && now - kvp->second.checked < check_interval) {
+		return kvp->second;
+	}
+
+	entry &value = s_entries[filename];
+	time_t modified = 0;
+	bool exists = vana::util::file::get_modified_time(filename, modified);
+	if (exists != value.exists || modified != value.modified) {
+		value.exists = exists;
+		value.modified = modified;
+		value.bytecode.reset();
+	}
+	value.checked = now;
+	return value;
+}
+
+auto chunk_cache::exists(const string &filename) -> bool {
+	owned_lock<mutex> l{s_mutex};
+	return refresh(filename).exists;
+}
+
+auto chunk_cache::load(lua_State *lua_vm, const string &filename) -> int {
+	ref_ptr<const string> bytecode;
+	time_t modified = 0;
+	{
+		owned_lock<mutex> l{s_mutex};
+		entry &value = refresh(filename);
+		if (!value.exists) {
+			// Lets Lua produce its usual error message
+			return luaL_loadfile(lua_vm, filename.c_str());
+		}
+		bytecode = value.bytecode;
+		modified = value.modified;
+	}
+
+	if (bytecode != nullptr) {
+		string chunk_name = "@" + filename;
+		return luaL_loadbufferx(lua_vm, bytecode->data(), bytecode->size(), chunk_name.c_str(), "b");
+	}
+
+	int status = luaL_loadfile(lua_vm, filename.c_str());
+	if (status != LUA_OK) {
+		return status;
+	}
+
+	auto compiled = make_ref_ptr<string>();
+	lua_dump(lua_vm, &write_bytecode, compiled.get());
+
+	owned_lock<mutex> l{s_mutex};
+	auto kvp = s_entries.find(filename);
+	// If the file changed while it was being compiled, this copy may already be out of date
+	if (kvp != std::end(s_entries) && kvp->second.modified == modified) {
+		kvp->second.bytecode = compiled;
+	}
+	return status;
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+extern "C" {
+	#include <lua.h>
+}
+
+#include "common/types.hpp"
+#include <ctime>
+#include <mutex>
+#include <string>
+
+namespace vana {
+	namespace lua {
+		// Keeps the compiled bytecode of every script that's been run, keyed by path and modification time
+		// Scripts are only compiled again once the file changes on disk
+		// The modification time is checked at most once every few seconds per file, so a script that's used constantly (e.g. a portal) costs no more than a lookup
+		class chunk_cache {
+		public:
+			// Same as luaL_loadfile, but skips compiling when the script hasn't changed since the last time
+			static auto load(lua_State *lua_vm, const string &filename) -> int;
+			static auto exists(const string &filename) -> bool;
+		private:
+			struct entry {
+				bool exists = false;
+				time_t modified = 0;
+				time_point checked;
+				ref_ptr<const string> bytecode;
+			};
+
+			static auto refresh(const string &filename) -> entry &;
+
+			static hash_map<string, entry> s_entries;
+			static mutex s_mutex;
+		};
+	}
+}
\ No newline at end of file
@@ -150,5 +150,10 @@ auto config_file::get_connection_properties_config() -> owned_ptr<config_file> {
 	return env;
 }
 
+auto config_file::get_load_tester_config() -> owned_ptr<config_file> {
+	auto env = make_owned_ptr<config_file>("conf/load_tester.lua");
+	return env;
+}
+
 }
 }
\ No newline at end of file
@@ -38,6 +38,7 @@ namespace vana {
 			auto static get_logger_config() -> owned_ptr<config_file>;
 			auto static get_database_config() -> owned_ptr<config_file>;
 			auto static get_connection_properties_config() -> owned_ptr<config_file>;
+			auto static get_load_tester_config() -> owned_ptr<config_file>;
 		protected:
 			auto handle_error(const string &filename, const string &error) -> void override;
 			auto handle_key_not_found(const string &filename, const string &key) -> void override;
@@ -16,6 +16,8 @@ along with this program; if not, write to the Free Software
 Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #include "lua_environment.hpp"
+#include "common/lua/chunk_cache.hpp"
+#include "common/lua/vm_pool.hpp"
 #include "common/util/file.hpp"
 #include "common/util/string.hpp"
 #include <iostream>
@@ -24,39 +26,46 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 namespace vana {
 namespace lua {
 
-vana::util::object_pool<int32_t, lua_environment *> lua_environment::s_environments =
-	vana::util::object_pool<int32_t, lua_environment *>{1, 1000000};
+static const char *shared_globals_key = "system_shared_globals";
+// Only the address matters, it's a registry key that can't collide with anything a script does
+static const char environment_key = 0;
 
 auto lua_environment::get_environment(lua_State *lua_vm) -> lua_environment & {
-	lua_getglobal(lua_vm, "system_environment_id");
-	int32_t id = lua_tointeger(lua_vm, -1);
+	// The registry is shared with every thread of the state, so this works from within coroutines as well
+	lua_rawgetp(lua_vm, LUA_REGISTRYINDEX, &environment_key);
+	auto env = static_cast<lua_environment *>(lua_touserdata(lua_vm, -1));
 	lua_pop(lua_vm, 1);
-	auto kvp = s_environments.find(id);
-	return *kvp->second;
+	return *env;
 }
 
 lua_environment::lua_environment(const string &filename)
 {
 	load_file(filename);
-
-	m_environment_id = s_environments.store(this);
-	set<int32_t>("system_environment_id", m_environment_id);
 }
 
-lua_environment::lua_environment(const string &filename, bool use_thread)
+lua_environment::lua_environment(const string &filename, bool use_thread, const string &vm_pool) :
+	m_vm_pool{vm_pool}
 {
 	load_file(filename);
 
-	m_environment_id = s_environments.store(this);
 	if (use_thread) {
 		m_lua_thread = lua_newthread(m_lua_vm);
 	}
-	set<int32_t>("system_environment_id", m_environment_id);
 }
 
 lua_environment::~lua_environment() {
-	s_environments.release(m_environment_id);
-	lua_close(m_lua_vm);
+	if (m_vm_pool.empty()) {
+		lua_close(m_lua_vm);
+	}
+	else {
+		// Drops the thread and this environment's globals, the shared globals stay for the next environment that gets the state
+		lua_settop(m_lua_vm, 0);
+		lua_pushnil(m_lua_vm);
+		lua_rawsetp(m_lua_vm, LUA_REGISTRYINDEX, &environment_key);
+		restore_shared_globals();
+		lua_gc(m_lua_vm, LUA_GCSTEP, 0);
+		vm_pool::release(m_vm_pool, m_lua_vm);
+	}
 	m_lua_vm = nullptr;
 }
 
@@ -64,32 +73,86 @@ auto lua_environment::load_file(const string &filename) -> void {
 	if (m_lua_vm != nullptr) {
 		throw std::runtime_error{"lua_vm was still specified"};
 	}
-	if (!vana::util::file::exists(filename)) {
+	if (!chunk_cache::exists(filename)) {
 		handle_file_not_found(filename);
 	}
 
 	m_file = filename;
-	m_lua_vm = luaL_newstate();
+	if (!m_vm_pool.empty()) {
+		m_lua_vm = vm_pool::acquire(m_vm_pool);
+		m_new_vm = m_lua_vm == nullptr;
+	}
+
+	if (m_new_vm) {
+		m_lua_vm = luaL_newstate();
+
+		require_standard_lib("base", luaopen_base);
+		require_standard_lib("string", luaopen_string);
+		require_standard_lib("math", luaopen_math);
+		require_standard_lib("table", luaopen_table);
+		set<int32_t>("system_lua_version_major", 5);
+		set<int32_t>("system_lua_version_minor", 2);
+		set<string>("system_lua_version", "5.2");
+	}
+
+	if (!m_vm_pool.empty()) {
+		isolate_globals();
+	}
+
+	// A state only ever belongs to one environment at a time, so exports can find theirs without any global lookups or locking
+	lua_pushlightuserdata(m_lua_vm, this);
+	lua_rawsetp(m_lua_vm, LUA_REGISTRYINDEX, &environment_key);
+}
+
+auto lua_environment::isolate_globals() -> void {
+	// The globals the state was set up with become the shared globals
+	lua_rawgeti(m_lua_vm, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+	lua_setfield(m_lua_vm, LUA_REGISTRYINDEX, shared_globals_key);
+
+	// Fresh globals that fall back to the shared ones, so nothing a script sets is seen by the next script that gets the state
+	lua_newtable(m_lua_vm);
+	lua_newtable(m_lua_vm);
+	lua_getfield(m_lua_vm, LUA_REGISTRYINDEX, shared_globals_key);
+	lua_setfield(m_lua_vm, -2, "__index");
+	lua_setmetatable(m_lua_vm, -2);
+	lua_pushvalue(m_lua_vm, -1);
+	lua_setfield(m_lua_vm, -2, "_G");
+	lua_rawseti(m_lua_vm, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+}
+
+auto lua_environment::restore_shared_globals() -> void {
+	lua_getfield(m_lua_vm, LUA_REGISTRYINDEX, shared_globals_key);
+	lua_rawseti(m_lua_vm, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+}
+
+auto lua_environment::set_up_shared_globals(function<void()> setup) -> void {
+	if (!m_new_vm) {
+		return;
+	}
+	if (m_vm_pool.empty()) {
+		setup();
+		return;
+	}
 
-	require_standard_lib("base", luaopen_base);
-	require_standard_lib("string", luaopen_string);
-	require_standard_lib("math", luaopen_math);
-	require_standard_lib("table", luaopen_table);
-	set<int32_t>("system_lua_version_major", 5);
-	set<int32_t>("system_lua_version_minor", 2);
-	set<string>("system_lua_version", "5.2");
+	lua_rawgeti(m_lua_vm, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+	int own_globals = lua_gettop(m_lua_vm);
+	restore_shared_globals();
+	setup();
+	lua_pushvalue(m_lua_vm, own_globals);
+	lua_rawseti(m_lua_vm, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+	lua_remove(m_lua_vm, own_globals);
 }
 
 auto lua_environment::run() -> result {
 	if (m_lua_thread == nullptr) {
-		if (luaL_dofile(m_lua_vm, m_file.c_str())) {
+		if (chunk_cache::load(m_lua_vm, m_file) || lua_pcall(m_lua_vm, 0, LUA_MULTRET, 0)) {
 			handle_error(m_file, get<string>(m_lua_vm, -1));
 			pop();
 			return result::failure;
 		}
 	}
 	else {
-		if (luaL_loadfile(m_lua_thread, m_file.c_str())) {
+		if (chunk_cache::load(m_lua_thread, m_file)) {
 			handle_error(m_file, get<string>(m_lua_thread, -1));
 			pop();
 			return result::failure;
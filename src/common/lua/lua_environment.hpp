@@ -26,7 +26,6 @@ extern "C" {
 #include "common/lua/lua_type.hpp"
 #include "common/lua/lua_variant.hpp"
 #include "common/types.hpp"
-#include "common/util/object_pool.hpp"
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -126,7 +125,9 @@ namespace vana {
 			template <typename ... TArgs>
 			auto call(lua_State *lua_vm, int quantity_return_results, const string &func, TArgs ... args) -> result;
 		protected:
-			lua_environment(const string &filename, bool use_thread);
+			// Environments that pass a pool name borrow an already set up Lua state from that pool and return it when they're destroyed
+			// Each one still gets its own globals, anything it doesn't set itself is looked up in the state's shared globals
+			lua_environment(const string &filename, bool use_thread, const string &vm_pool = "");
 
 			virtual auto handle_error(const string &filename, const string &error) -> void;
 			virtual auto handle_file_not_found(const string &filename) -> void;
@@ -136,11 +137,16 @@ namespace vana {
 			auto expose(const string &name, lua::lua_function func) -> void;
 			auto resume(lua::lua_return pushed_arg_count) -> result;
 			auto require_standard_lib(const string &local_name, lua::lua_function func) -> void;
+			// Runs setup with the shared globals in place of this environment's own, but only if the state is new
+			// This is where everything that's the same for every script goes (e.g. constants and exposed functions)
+			auto set_up_shared_globals(function<void()> setup) -> void;
 
 			template <typename T>
 			auto push_thread(const T &value) -> void;
 		private:
 			auto load_file(const string &filename) -> void;
+			auto isolate_globals() -> void;
+			auto restore_shared_globals() -> void;
 			auto key_must_exist(const string &key) -> void;
 			template <typename THead, typename ... TTail>
 			auto call_impl(lua_State *lua_vm, const THead &arg, const TTail & ... rest) -> void;
@@ -271,12 +277,11 @@ namespace vana {
 			auto get_impl(lua_State *lua_vm, int index, ord_map<TKey, TElement, TOperation> *) -> ord_map<TKey, TElement, TOperation>;
 			// End get_impl index
 
-			static vana::util::object_pool<int32_t, lua_environment *> s_environments;
-
 			lua_State *m_lua_vm = nullptr;
 			lua_State *m_lua_thread = nullptr;
+			bool m_new_vm = true;
 			string m_file;
-			int32_t m_environment_id;
+			string m_vm_pool;
 		};
 
 		template <typename T>
@@ -0,0 +1,54 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "vm_pool.hpp"
+
+namespace vana {
+namespace lua {
+
+hash_map<string, vector<lua_State *>> vm_pool::s_idle;
+mutex vm_pool::s_mutex;
+
+static const size_t max_idle = 32;
+
+auto vm_pool::acquire(const string &pool) -> lua_State * {
+	owned_lock<mutex> l{s_mutex};
+	auto &idle = s_idle[pool];
+	if (idle.empty()) {
+		return nullptr;
+	}
+
+	lua_State *ret = idle.back();
+	idle.pop_back();
+	return ret;
+}
+
+auto vm_pool::release(const string &pool, lua_State *lua_vm) -> void {
+	{
+		owned_lock<mutex> l{s_mutex};
+		auto &idle = s_idle[pool];
+		if (idle.size() < max_idle) {
+			idle.push_back(lua_vm);
+			return;
+		}
+	}
+
+	lua_close(lua_vm);
+}
+
+}
+}
\ No newline at end of file
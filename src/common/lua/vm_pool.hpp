@@ -0,0 +1,44 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+extern "C" {
+	#include <lua.h>
+}
+
+#include "common/types.hpp"
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vana {
+	namespace lua {
+		// Idle Lua states that have already been set up, grouped by what they were set up for
+		// Each state keeps whatever was put in its shared globals, so only states that were set up the same way may share a pool name
+		class vm_pool {
+		public:
+			// Returns nullptr if there's no idle state in the pool
+			static auto acquire(const string &pool) -> lua_State *;
+			// Takes ownership of the state, closing it if the pool already has enough idle states
+			static auto release(const string &pool, lua_State *lua_vm) -> void;
+		private:
+			static hash_map<string, vector<lua_State *>> s_idle;
+			static mutex s_mutex;
+		};
+	}
+}
\ No newline at end of file
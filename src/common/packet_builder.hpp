@@ -63,6 +63,8 @@ namespace vana {
 		auto add_buffer(const packet_reader &reader) -> packet_builder &;
 
 		auto get_buffer() const -> const unsigned char *;
+		// Shares ownership of the underlying buffer so that the same plaintext may be sent to many sessions without copying
+		auto get_shared_buffer() const -> const vana::util::shared_array<unsigned char> &;
 		auto get_size() const -> size_t;
 		auto to_string() const -> string;
 	private:
@@ -296,6 +298,11 @@ namespace vana {
 		return m_packet.get();
 	}
 
+	inline
+	auto packet_builder::get_shared_buffer() const -> const vana::util::shared_array<unsigned char> & {
+		return m_packet;
+	}
+
 	inline
 	auto packet_builder::add_buffer(const unsigned char *bytes, size_t len) -> packet_builder & {
 		memcpy(get_buffer(m_pos, len), bytes, len);
@@ -0,0 +1,207 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "packet_capture.hpp"
+#include "common/util/time.hpp"
+#ifdef WIN32
+#include <filesystem>
+#else
+#include <boost/filesystem.hpp>
+#endif
+#include <cstring>
+#include <ctime>
+
+namespace vana {
+
+#ifdef WIN32
+namespace fs = std::tr2::sys;
+#else
+namespace fs = boost::filesystem;
+#endif
+
+const char packet_capture::magic[4] = {'V', 'C', 'A', 'P'};
+const string packet_capture::directory = "logs/captures";
+mutex packet_capture::s_mutex;
+owned_ptr<std::ofstream> packet_capture::s_file;
+string packet_capture::s_filename;
+time_point packet_capture::s_started;
+uint32_t packet_capture::s_next_session = 1;
+
+auto packet_capture::start(const string &server) -> result {
+	char timestamp[32];
+	time_t now = std::time(nullptr);
+	std::strftime(timestamp, sizeof(timestamp), "%Y%m%d_%H%M%S", std::localtime(&now));
+
+	fs::path full_path = fs::system_complete(fs::path{directory});
+	if (!fs::exists(full_path)) {
+		fs::create_directories(full_path);
+	}
+
+	string filename = directory + "/" + server + "_" + timestamp + ".vcap";
+	auto file = make_owned_ptr<std::ofstream>(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file->is_open()) {
+		return result::failure;
+	}
+
+	owned_lock<mutex> l{s_mutex};
+	if (s_file != nullptr) {
+		s_file->close();
+	}
+
+	s_file = std::move(file);
+	s_filename = filename;
+	s_started = vana::util::time::get_now();
+	s_file->write(magic, sizeof(magic));
+	write(version);
+	return result::success;
+}
+
+auto packet_capture::stop() -> void {
+	owned_lock<mutex> l{s_mutex};
+	if (s_file == nullptr) {
+		return;
+	}
+
+	s_file->close();
+	s_file.reset();
+}
+
+auto packet_capture::is_running() -> bool {
+	owned_lock<mutex> l{s_mutex};
+	return s_file != nullptr;
+}
+
+auto packet_capture::get_filename() -> string {
+	owned_lock<mutex> l{s_mutex};
+	return s_filename;
+}
+
+auto packet_capture::find(const string &name) -> opt_string {
+	opt_string ret;
+
+	// Accept the name as it's shown by !capture as well
+	string file = name;
+	string prefix = directory + "/";
+	if (file.compare(0, prefix.size(), prefix) == 0) {
+		file = file.substr(prefix.size());
+	}
+
+	if (file.empty() || file == "." || file == "..") {
+		return ret;
+	}
+	if (file.find_first_of("/\\:") != string::npos) {
+		return ret;
+	}
+
+	ret = prefix + file;
+	return ret;
+}
+
+auto packet_capture::write_header(record_kind kind, uint32_t session) -> void {
+	uint64_t offset = static_cast<uint64_t>(duration_cast<microseconds>(vana::util::time::get_now() - s_started).count());
+	write(kind);
+	write(session);
+	write(offset);
+}
+
+auto packet_capture::open(const ip &source) -> uint32_t {
+	owned_lock<mutex> l{s_mutex};
+	if (s_file == nullptr || source.get_type() != ip::type::ipv4) {
+		return 0;
+	}
+
+	uint32_t session = s_next_session++;
+	write_header(record_kind::open, session);
+	write(source.as_ipv4());
+	return session;
+}
+
+auto packet_capture::record_packet(uint32_t session, const unsigned char *buffer, size_t length) -> void {
+	owned_lock<mutex> l{s_mutex};
+	if (s_file == nullptr) {
+		return;
+	}
+
+	write_header(record_kind::packet, session);
+	write(static_cast<uint16_t>(length));
+	s_file->write(reinterpret_cast<const char *>(buffer), length);
+}
+
+auto packet_capture::close(uint32_t session) -> void {
+	owned_lock<mutex> l{s_mutex};
+	if (s_file == nullptr) {
+		return;
+	}
+
+	write_header(record_kind::close, session);
+	// Keeps what's lost to a crash down to the sessions that are still open
+	s_file->flush();
+}
+
+packet_capture::reader::reader(const string &filename) :
+	m_file{filename, std::ios::in | std::ios::binary}
+{
+	char header[sizeof(magic)];
+	uint16_t file_version = 0;
+	m_file.read(header, sizeof(header));
+	m_valid =
+		m_file.gcount() == sizeof(header) &&
+		memcmp(header, magic, sizeof(header)) == 0 &&
+		read(file_version) &&
+		file_version == version;
+}
+
+auto packet_capture::reader::next(record &value) -> bool {
+	if (!m_valid) {
+		return false;
+	}
+
+	uint64_t offset = 0;
+	if (!read(value.kind) || !read(value.session) || !read(offset)) {
+		return false;
+	}
+	value.offset = microseconds{static_cast<int64_t>(offset)};
+	value.data.clear();
+
+	switch (value.kind) {
+		case record_kind::open: {
+			uint32_t address = 0;
+			if (!read(address)) {
+				return false;
+			}
+			value.source = ip{address};
+			return true;
+		}
+		case record_kind::packet: {
+			uint16_t length = 0;
+			if (!read(length)) {
+				return false;
+			}
+			value.data.resize(length);
+			m_file.read(reinterpret_cast<char *>(value.data.data()), length);
+			return m_file.gcount() == length;
+		}
+		case record_kind::close:
+			return true;
+	}
+
+	// The file is cut off or corrupt past this point
+	m_valid = false;
+	return false;
+}
+
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/ip.hpp"
+#include "common/types.hpp"
+#include "common/util/optional.hpp"
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vana {
+	// Records the decrypted packets clients send so that a session can be replayed against a server later
+	// The file starts with "VCAP" and a version, then holds one record after another:
+	// uint8 kind, uint32 session, uint64 microseconds since the capture started, then for an open the IPv4 address and for a packet its uint16 length and bytes
+	// Only sessions that connect while the capture is running are recorded, a replay needs to see the connect packet
+	class packet_capture {
+	public:
+		enum class record_kind : uint8_t {
+			open,
+			packet,
+			close,
+		};
+
+		struct record {
+			record() : source{0} { }
+
+			record_kind kind = record_kind::packet;
+			uint32_t session = 0;
+			microseconds offset;
+			ip source;
+			vector<unsigned char> data;
+		};
+
+		class reader {
+			NONCOPYABLE(reader);
+			NO_DEFAULT_CONSTRUCTOR(reader);
+		public:
+			explicit reader(const string &filename);
+
+			auto is_valid() const -> bool { return m_valid; }
+			auto next(record &value) -> bool;
+		private:
+			template <typename TValue>
+			auto read(TValue &value) -> bool;
+
+			bool m_valid = false;
+			std::ifstream m_file;
+		};
+
+		// Opens a new capture file under logs/captures for the server, capturing stops any capture already running
+		static auto start(const string &server) -> result;
+		static auto stop() -> void;
+		static auto is_running() -> bool;
+		static auto get_filename() -> string;
+		// Resolves the name of a capture to its file in logs/captures, names that would reach outside of it aren't resolved
+		static auto find(const string &name) -> opt_string;
+
+		// Returns 0 when nothing is being captured
+		static auto open(const ip &source) -> uint32_t;
+		static auto record_packet(uint32_t session, const unsigned char *buffer, size_t length) -> void;
+		static auto close(uint32_t session) -> void;
+	private:
+		static const char magic[4];
+		static const string directory;
+		static const uint16_t version = 1;
+
+		static auto write_header(record_kind kind, uint32_t session) -> void;
+		template <typename TValue>
+		static auto write(const TValue &value) -> void;
+
+		static mutex s_mutex;
+		static owned_ptr<std::ofstream> s_file;
+		static string s_filename;
+		static time_point s_started;
+		static uint32_t s_next_session;
+	};
+
+	template <typename TValue>
+	auto packet_capture::write(const TValue &value) -> void {
+		s_file->write(reinterpret_cast<const char *>(&value), sizeof(TValue));
+	}
+
+	template <typename TValue>
+	auto packet_capture::reader::read(TValue &value) -> bool {
+		m_file.read(reinterpret_cast<char *>(&value), sizeof(TValue));
+		return m_file.gcount() == sizeof(TValue);
+	}
+}
\ No newline at end of file
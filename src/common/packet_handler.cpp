@@ -47,10 +47,35 @@ auto packet_handler::get_latency() const -> milliseconds {
 	return m_session->get_latency();
 }
 
+auto packet_handler::post(function<void()> work) -> void {
+	if (m_disconnected) {
+		return;
+	}
+	m_session->post(work);
+}
+
+auto packet_handler::hold_replay() -> void {
+	if (m_disconnected) {
+		return;
+	}
+	m_session->hold_replay();
+}
+
+auto packet_handler::resume_replay() -> void {
+	if (m_disconnected) {
+		return;
+	}
+	m_session->resume_replay();
+}
+
 auto packet_handler::handle(packet_reader &reader) -> result {
 	return result::success;
 }
 
+auto packet_handler::dispatch(function<void()> work) -> void {
+	work();
+}
+
 auto packet_handler::on_connect_base(ref_ptr<session> session) -> void {
 	m_session = session;
 	on_connect();
@@ -28,12 +28,17 @@ namespace vana {
 		auto disconnect() -> void;
 		auto send(const packet_builder &builder) -> void;
 		auto get_latency() const -> milliseconds;
+		// Runs the work on the session's strand, it's dropped once the session is gone
+		auto post(function<void()> work) -> void;
 	protected:
 		friend class session;
 		virtual auto handle(packet_reader &reader) -> result;
+		virtual auto dispatch(function<void()> work) -> void;
 		virtual auto on_connect() -> void;
 		virtual auto on_disconnect() -> void;
 		auto on_connect_base(ref_ptr<session> session) -> void;
+		auto hold_replay() -> void;
+		auto resume_replay() -> void;
 		auto on_disconnect_base() -> void;
 
 		bool m_disconnected = false;
@@ -0,0 +1,149 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "packet_stats.hpp"
+#include "common/util/time.hpp"
+#ifdef WIN32
+#include <filesystem>
+#else
+#include <boost/filesystem.hpp>
+#endif
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+namespace vana {
+
+#ifdef WIN32
+namespace fs = std::tr2::sys;
+#else
+namespace fs = boost::filesystem;
+#endif
+
+thread_local packet_stats::shard *packet_stats::s_shard = nullptr;
+vector<owned_ptr<packet_stats::shard>> packet_stats::s_shards;
+mutex packet_stats::s_shards_mutex;
+
+auto packet_stats::get_shard() -> shard & {
+	if (s_shard == nullptr) {
+		// Shards live as long as the process, a thread that goes away leaves its numbers behind
+		owned_lock<mutex> l{s_shards_mutex};
+		s_shards.push_back(make_owned_ptr<shard>());
+		s_shard = s_shards.back().get();
+	}
+	return *s_shard;
+}
+
+auto packet_stats::record(connection_type source, packet_header header, size_t bytes, microseconds elapsed) -> void {
+	shard &current = get_shard();
+	uint32_t key = (static_cast<uint32_t>(source) << 16) | header;
+
+	owned_lock<mutex> l{current.entries_mutex};
+	auto kvp = current.entries.find(key);
+	if (kvp == std::end(current.entries)) {
+		entry value;
+		value.source = source;
+		value.header = header;
+		kvp = current.entries.emplace(key, value).first;
+	}
+
+	entry &value = kvp->second;
+	value.bytes += bytes;
+	value.latency.record(static_cast<uint64_t>(std::max<int64_t>(elapsed.count(), 0)));
+}
+
+auto packet_stats::snapshot() -> vector<entry> {
+	hash_map<uint32_t, entry> merged;
+	{
+		owned_lock<mutex> l{s_shards_mutex};
+		for (const auto &current : s_shards) {
+			owned_lock<mutex> shard_lock{current->entries_mutex};
+			for (const auto &kvp : current->entries) {
+				auto existing = merged.find(kvp.first);
+				if (existing == std::end(merged)) {
+					merged.emplace(kvp.first, kvp.second);
+					continue;
+				}
+
+				existing->second.bytes += kvp.second.bytes;
+				existing->second.latency.merge(kvp.second.latency);
+			}
+		}
+	}
+
+	vector<entry> ret;
+	ret.reserve(merged.size());
+	for (const auto &kvp : merged) {
+		ret.push_back(kvp.second);
+	}
+
+	std::sort(std::begin(ret), std::end(ret), [](const entry &a, const entry &b) {
+		return a.latency.get_total() > b.latency.get_total();
+	});
+	return ret;
+}
+
+auto packet_stats::describe(const entry &value) -> string {
+	const char *source = "unknown";
+	switch (value.source) {
+		case connection_type::none: break;
+		case connection_type::unknown: break;
+		case connection_type::login: source = "login"; break;
+		case connection_type::world: source = "world"; break;
+		case connection_type::channel: source = "channel"; break;
+		case connection_type::cash: source = "cash"; break;
+		case connection_type::mts: source = "mts"; break;
+		case connection_type::end_user: source = "client"; break;
+	}
+
+	const auto &latency = value.latency;
+	uint64_t count = latency.get_count();
+	out_stream str;
+	str << source << " 0x" << std::hex << std::setw(4) << std::setfill('0') << std::uppercase << value.header << std::dec << std::setfill(' ') << std::nouppercase
+		<< ": " << count << " handled, " << value.bytes << " bytes, "
+		<< "total " << latency.get_total() / 1000 << " ms, "
+		<< "avg " << (count == 0 ? 0 : latency.get_total() / count) << " us, "
+		<< "p50 " << latency.get_percentile(50) << " us, "
+		<< "p99 " << latency.get_percentile(99) << " us, "
+		<< "p99.9 " << latency.get_percentile(99.9) << " us, "
+		<< "max " << latency.get_max() << " us";
+	return str.str();
+}
+
+auto packet_stats::dump(const string &filename, const string &title) -> void {
+	auto entries = snapshot();
+	if (entries.empty()) {
+		return;
+	}
+
+	fs::path full_path = fs::system_complete(fs::path{filename.substr(0, filename.find_last_of("/"))});
+	if (!fs::exists(full_path)) {
+		fs::create_directories(full_path);
+	}
+
+	std::ofstream file{filename, std::ios::out | std::ios::app};
+	if (!file.is_open()) {
+		return;
+	}
+
+	file << vana::util::time::simple_timestamp() << title << std::endl;
+	for (const auto &value : entries) {
+		file << "\t" << describe(value) << std::endl;
+	}
+}
+
+}
\ No newline at end of file
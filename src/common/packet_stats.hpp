@@ -0,0 +1,58 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/connection_type.hpp"
+#include "common/types.hpp"
+#include "common/util/latency_histogram.hpp"
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vana {
+	// Counts the packets a server handles by where they came from and their header, along with their bytes and how long their handlers took
+	// Every thread records into a shard of its own, so recording only ever waits on a snapshot that happens to be reading that shard
+	class packet_stats {
+	public:
+		struct entry {
+			connection_type source = connection_type::unknown;
+			packet_header header = 0;
+			uint64_t bytes = 0;
+			// In microseconds
+			vana::util::latency_histogram latency;
+		};
+
+		static auto record(connection_type source, packet_header header, size_t bytes, microseconds elapsed) -> void;
+		// Every shard merged, with the packets that took the most time overall first
+		static auto snapshot() -> vector<entry>;
+		static auto describe(const entry &value) -> string;
+		// Appends a snapshot to the file
+		static auto dump(const string &filename, const string &title) -> void;
+	private:
+		struct shard {
+			mutex entries_mutex;
+			hash_map<uint32_t, entry> entries;
+		};
+
+		static auto get_shard() -> shard &;
+
+		static thread_local shard *s_shard;
+		static vector<owned_ptr<shard>> s_shards;
+		static mutex s_shards_mutex;
+	};
+}
\ No newline at end of file
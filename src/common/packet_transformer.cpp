@@ -57,6 +57,10 @@ auto packet_transformer::decrypt_packet(unsigned char *packet_data, int32_t real
 	// Intentionally blank
 }
 
+auto packet_transformer::modifies_payload() const -> bool {
+	return false;
+}
+
 auto packet_transformer::get_version_and_size(unsigned char *header, uint16_t &version, uint16_t &size) -> void {
 	version = *reinterpret_cast<uint16_t *>(header);
 	size = *reinterpret_cast<uint16_t *>(header + sizeof(uint16_t));
@@ -27,6 +27,7 @@ namespace vana {
 		virtual auto set_packet_header(unsigned char *header, uint16_t real_packet_size) -> void;
 		virtual auto encrypt_packet(unsigned char *packet_data, int32_t real_packet_size, uint16_t header_size) -> void;
 		virtual auto decrypt_packet(unsigned char *packet_data, int32_t real_packet_size, uint16_t header_size) -> void;
+		virtual auto modifies_payload() const -> bool;
 	private:
 		auto get_version_and_size(unsigned char *header, uint16_t &version, uint16_t &size) -> void;
 	};
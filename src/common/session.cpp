@@ -23,10 +23,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common/exit_code.hpp"
 #include "common/log/base_logger.hpp"
 #include "common/packet_builder.hpp"
+#include "common/packet_capture.hpp"
 #include "common/packet_handler.hpp"
 #include "common/packet_reader.hpp"
+#include "common/packet_stats.hpp"
 #include "common/util/randomizer.hpp"
 #include "common/util/time.hpp"
+#include <chrono>
 #include <functional>
 #include <iostream>
 
@@ -37,6 +40,7 @@ session::session(
 	handler handler) :
 	m_manager{manager},
 	m_socket{service},
+	m_strand{service},
 	m_handler{handler},
 	m_ip{0}
 {
@@ -79,7 +83,7 @@ auto session::ping() -> void {
 	send(packets::ping());
 }
 
-auto session::start(const config::ping &ping, ref_ptr<packet_transformer> transformer) -> void {
+auto session::start(const config::ping &ping, ref_ptr<packet_transformer> transformer, size_t send_queue_limit) -> void {
 	// TODO FIXME support IPv6
 	auto &addr = m_socket.remote_endpoint().address();
 	if (addr.is_v4()) {
@@ -89,6 +93,14 @@ auto session::start(const config::ping &ping, ref_ptr<packet_transformer> transf
 		THROW_CODE_EXCEPTION(not_implemented_exception, "i_pv6");
 	}
 
+	// Socket completions run on the session strand, so the ping timer needs to be as well
+	view_ptr<session> self = shared_from_this();
+	set_timer_dispatcher([self](function<void()> work) {
+		if (auto session = self.lock()) {
+			session->m_strand.post(work);
+		}
+	});
+
 	if (ping.enable) {
 		m_max_ping_count = ping.timeout_ping_count;
 		timer::timer::create(
@@ -100,6 +112,11 @@ auto session::start(const config::ping &ping, ref_ptr<packet_transformer> transf
 	}
 
 	m_codec = transformer;
+	m_send_queue_limit = send_queue_limit;
+
+	if (m_type == connection_type::end_user) {
+		m_capture_session = packet_capture::open(m_ip);
+	}
 
 	m_handler->on_connect_base(shared_from_this());
 
@@ -107,6 +124,85 @@ auto session::start(const config::ping &ping, ref_ptr<packet_transformer> transf
 	start_read_header();
 }
 
+auto session::start_replay(const ip &source) -> void {
+	// There's no socket behind a replay, packets come from replay() and whatever is sent is dropped once it's built
+	m_ip = source;
+	m_is_replay = true;
+
+	view_ptr<session> self = shared_from_this();
+	set_timer_dispatcher([self](function<void()> work) {
+		if (auto session = self.lock()) {
+			session->m_strand.post(work);
+		}
+	});
+
+	m_codec = make_ref_ptr<packet_transformer>();
+
+	m_handler->on_connect_base(shared_from_this());
+
+	m_is_connected = true;
+}
+
+auto session::replay(vector<unsigned char> packet) -> void {
+	ref_ptr<session> self = shared_from_this();
+	m_strand.post([self, packet] {
+		self->m_replay_queue.push_back(packet);
+		if (!self->m_is_replaying) {
+			self->replay_next();
+		}
+	});
+}
+
+auto session::replay_disconnect() -> void {
+	replay(vector<unsigned char>{});
+}
+
+auto session::hold_replay() -> void {
+	// Posted, so it's in place before the replay moves on from the packet that's being handled
+	ref_ptr<session> self = shared_from_this();
+	m_strand.post([self] {
+		self->m_replay_held = true;
+	});
+}
+
+auto session::resume_replay() -> void {
+	ref_ptr<session> self = shared_from_this();
+	m_strand.post([self] {
+		self->m_replay_held = false;
+		if (!self->m_is_replaying) {
+			self->replay_next();
+		}
+	});
+}
+
+auto session::replay_next() -> void {
+	if (m_replay_queue.empty() || !m_is_connected || m_replay_held) {
+		m_is_replaying = false;
+		return;
+	}
+
+	if (m_replay_queue.front().empty()) {
+		m_replay_queue.clear();
+		m_is_replaying = false;
+		disconnect();
+		return;
+	}
+
+	// Like a socket read, the next packet isn't handled until this one is done
+	m_is_replaying = true;
+	size_t length = m_replay_queue.front().size();
+	m_buffer.reset(new unsigned char[length]);
+	memcpy(m_buffer.get(), m_replay_queue.front().data(), length);
+	m_replay_queue.pop_front();
+
+	ref_ptr<session> self = shared_from_this();
+	m_handler->dispatch([self, length] {
+		packet_reader packet{self->m_buffer.get(), length};
+		self->base_handle_request(packet);
+		self->m_strand.post([self] { self->replay_next(); });
+	});
+}
+
 auto session::sync_read(size_t minimum_bytes) -> pair<asio::error_code, packet_reader> {
 	asio::error_code error;
 
@@ -122,49 +218,130 @@ auto session::sync_read(size_t minimum_bytes) -> pair<asio::error_code, packet_r
 
 auto session::disconnect() -> void {
 	if (!m_is_connected) return;
+	if (m_capture_session != 0) {
+		packet_capture::close(m_capture_session);
+	}
 	m_handler->on_disconnect_base();
 	m_manager.stop(shared_from_this());
 	m_is_connected = false;
 
-	asio::error_code ec;
-	m_socket.close(ec);
-	if (ec) {
-		m_manager.get_server()->log(vana::log::type::error, [&](out_stream &str) {
-			str << "FAILURE TO CLOSE SESSION (" << ec.value() << "): " << ec.message();
-		});
-	}
+	// Disconnects may come from the handler's strand, the socket is only touched on the session strand
+	ref_ptr<session> self = shared_from_this();
+	m_strand.dispatch([self] {
+		asio::error_code ec;
+		self->m_socket.close(ec);
+		if (ec) {
+			self->m_manager.get_server()->log(vana::log::type::error, [&](out_stream &str) {
+				str << "FAILURE TO CLOSE SESSION (" << ec.value() << "): " << ec.message();
+			});
+		}
+	});
+}
+
+auto session::post(function<void()> work) -> void {
+	m_strand.post(work);
 }
 
 auto session::send(const packet_builder &builder, bool encrypt) -> void {
-	send(builder.get_buffer(), builder.get_size(), encrypt);
+	send(builder.get_shared_buffer(), builder.get_size(), encrypt);
 }
 
-auto session::send(const unsigned char *buf, int32_t len, bool encrypt) -> void {
+auto session::send(const vana::util::shared_array<unsigned char> &buf, size_t len, bool encrypt) -> void {
 	owned_lock<mutex> l{m_send_mutex};
+	if (m_send_queue_overflowed) {
+		return;
+	}
 
-	unsigned char *send_buffer;
-	size_t real_length = len;
+	// Packets are encrypted in the order they're queued so the IV sequence matches what goes out on the wire
+	outbound_packet packet;
+	packet.payload_size = len;
 
 	if (encrypt) {
-		real_length += header_len;
-		send_buffer = new unsigned char[real_length];
-		m_send_packet.reset(send_buffer);
+		packet.header_size = header_len;
+		m_codec->set_packet_header(packet.header.data(), static_cast<uint16_t>(len));
+	}
 
-		memcpy(send_buffer + header_len, buf, len);
-		m_codec->set_packet_header(send_buffer, static_cast<uint16_t>(len));
-		m_codec->encrypt_packet(send_buffer + header_len, len, header_len);
+	if (encrypt && m_codec->modifies_payload()) {
+		// Each session has its own IV, so ciphertext can't be shared between recipients
+		packet.owned_payload = lease_send_buffer(len);
+		memcpy(packet.owned_payload.data(), buf.get(), len);
+		m_codec->encrypt_packet(packet.owned_payload.data(), static_cast<int32_t>(len), header_len);
 	}
 	else {
-		send_buffer = new unsigned char[real_length];
-		m_send_packet.reset(send_buffer);
+		// Nothing touches the payload, so every recipient of a broadcast writes from the same buffer
+		packet.shared_payload = buf;
+	}
+
+	m_queued_bytes += packet.header_size + packet.payload_size;
+	m_send_queue.push_back(std::move(packet));
+
+	if (m_send_queue_limit > 0 && m_queued_bytes > m_send_queue_limit) {
+		// The peer isn't reading fast enough, holding on to more data would only grow memory without bound
+		// Disconnecting is deferred because we may be in the middle of iterating something that a disconnect modifies
+		m_send_queue_overflowed = true;
+		m_send_queue.clear();
+		m_queued_bytes = 0;
+		m_manager.get_server()->log(vana::log::type::warning, [&](out_stream &str) {
+			str << "Disconnecting " << m_ip << " for exceeding the send queue limit of " << m_send_queue_limit << " bytes";
+		});
+		m_strand.post(std::bind(&session::disconnect, shared_from_this()));
+		return;
+	}
 
-		memcpy(send_buffer, buf, len);
+	if (!m_is_writing && !m_flush_pending) {
+		// Everything sent by the current handler or tick is gathered into a single write
+		m_flush_pending = true;
+		m_strand.post(std::bind(&session::flush_send_queue, shared_from_this()));
 	}
+}
 
-	asio::async_write(m_socket, asio::buffer(send_buffer, real_length),
-		std::bind(&session::handle_write, shared_from_this(),
+auto session::flush_send_queue() -> void {
+	owned_lock<mutex> l{m_send_mutex};
+	m_flush_pending = false;
+	if (m_is_writing || m_send_queue.empty() || !m_is_connected) {
+		return;
+	}
+
+	size_t count = m_send_queue.size();
+	if (count > max_coalesced_packets) {
+		count = max_coalesced_packets;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		m_in_flight.push_back(std::move(m_send_queue.front()));
+		m_send_queue.pop_front();
+	}
+
+	if (m_is_replay) {
+		m_is_writing = true;
+		l.unlock();
+		handle_write(asio::error_code{}, 0);
+		return;
+	}
+
+	// m_in_flight isn't modified until the write completes, so the header addresses remain valid
+	for (const auto &packet : m_in_flight) {
+		if (packet.header_size > 0) {
+			m_write_buffers.push_back(asio::buffer(packet.header.data(), packet.header_size));
+		}
+		m_write_buffers.push_back(asio::buffer(packet.get_payload(), packet.payload_size));
+	}
+
+	m_is_writing = true;
+	asio::async_write(m_socket, m_write_buffers,
+		m_strand.wrap(std::bind(&session::handle_write, shared_from_this(),
 			std::placeholders::_1,
-			std::placeholders::_2));
+			std::placeholders::_2)));
+}
+
+auto session::lease_send_buffer(size_t len) -> vector<unsigned char> {
+	vector<unsigned char> buffer;
+	if (!m_send_buffer_pool.empty()) {
+		buffer = std::move(m_send_buffer_pool.back());
+		m_send_buffer_pool.pop_back();
+	}
+	buffer.resize(len);
+	return buffer;
 }
 
 auto session::start_read_header() -> void {
@@ -172,16 +349,33 @@ auto session::start_read_header() -> void {
 
 	asio::async_read(m_socket,
 		asio::buffer(m_buffer.get(), header_len),
-		std::bind(&session::handle_read_header, shared_from_this(),
+		m_strand.wrap(std::bind(&session::handle_read_header, shared_from_this(),
 			std::placeholders::_1,
-			std::placeholders::_2));
+			std::placeholders::_2)));
 }
 
 auto session::handle_write(const asio::error_code &error, size_t bytes_transferred) -> void {
 	owned_lock<mutex> l{m_send_mutex};
+	for (auto &packet : m_in_flight) {
+		if (!m_send_queue_overflowed) {
+			m_queued_bytes -= packet.header_size + packet.payload_size;
+		}
+		if (packet.owned_payload.capacity() > 0 && m_send_buffer_pool.size() < max_pooled_send_buffers) {
+			m_send_buffer_pool.push_back(std::move(packet.owned_payload));
+		}
+	}
+	m_in_flight.clear();
+	m_write_buffers.clear();
+	m_is_writing = false;
+
 	if (error) {
+		l.unlock();
 		disconnect();
+		return;
 	}
+
+	l.unlock();
+	flush_send_queue();
 }
 
 auto session::handle_read_header(const asio::error_code &error, size_t bytes_transferred) -> void {
@@ -209,9 +403,9 @@ auto session::handle_read_header(const asio::error_code &error, size_t bytes_tra
 
 	asio::async_read(m_socket,
 		asio::buffer(m_buffer.get(), len),
-		std::bind(&session::handle_read_body, shared_from_this(),
+		m_strand.wrap(std::bind(&session::handle_read_body, shared_from_this(),
 			std::placeholders::_1,
-			std::placeholders::_2));
+			std::placeholders::_2)));
 }
 
 auto session::handle_read_body(const asio::error_code &error, size_t bytes_transferred) -> void {
@@ -221,11 +415,24 @@ auto session::handle_read_body(const asio::error_code &error, size_t bytes_trans
 	}
 
 	m_codec->decrypt_packet(m_buffer.get(), bytes_transferred, header_len);
+	if (m_capture_session != 0) {
+		packet_capture::record_packet(m_capture_session, m_buffer.get(), bytes_transferred);
+	}
 
-	packet_reader packet{m_buffer.get(), bytes_transferred};
-	base_handle_request(packet);
-
-	start_read_header();
+	// The handler decides where its packets are processed (e.g. the strand of the map a player is on)
+	// The next read isn't started until this packet is done, which keeps the buffer valid and the packets in order
+	ref_ptr<session> self = shared_from_this();
+	m_handler->dispatch([self, bytes_transferred] {
+		packet_reader packet{self->m_buffer.get(), bytes_transferred};
+		self->base_handle_request(packet);
+
+		// The handler may have run on another strand, reads and writes on the socket stay on the session strand
+		self->m_strand.dispatch([self] {
+			if (self->m_is_connected) {
+				self->start_read_header();
+			}
+		});
+	});
 }
 
 auto session::get_ip() const -> const ip & {
@@ -234,7 +441,8 @@ auto session::get_ip() const -> const ip & {
 
 auto session::base_handle_request(packet_reader &reader) -> void {
 	try {
-		switch (reader.peek<packet_header>()) {
+		packet_header header = reader.peek<packet_header>();
+		switch (header) {
 			case SMSG_PING:
 				if (m_type != connection_type::end_user) {
 					send(packets::pong());
@@ -252,7 +460,12 @@ auto session::base_handle_request(packet_reader &reader) -> void {
 				break;
 		}
 
-		if (m_handler->handle(reader) == result::failure) {
+		size_t bytes = reader.get_consumed_length() + reader.get_buffer_length();
+		auto start = std::chrono::steady_clock::now();
+		result handled = m_handler->handle(reader);
+		packet_stats::record(m_type, header, bytes, duration_cast<microseconds>(std::chrono::steady_clock::now() - start));
+
+		if (handled == result::failure) {
 			disconnect();
 		}
 	}
@@ -48,25 +48,52 @@ namespace vana {
 			handler handler);
 
 		auto disconnect() -> void;
+		// Runs work on the session's strand, for things that finish on another thread
+		auto post(function<void()> work) -> void;
 		auto send(const packet_builder &builder, bool encrypt = true) -> void;
 		auto get_ip() const -> const ip &;
 		auto get_latency() const -> milliseconds;
 		auto get_type() const -> connection_type;
 		auto set_type(connection_type type) -> void;
+		// Queues a plaintext packet (header included) on a replay session as though the client had sent it
+		auto replay(vector<unsigned char> packet) -> void;
+		// Queues the client's disconnect behind the packets that are still waiting on a replay session
+		auto replay_disconnect() -> void;
+		// A handler that finishes a packet asynchronously (e.g. loading a character) holds the replay until it's ready for the next one
+		// A real client waits for the server's response on its own, so sockets aren't affected
+		auto hold_replay() -> void;
+		auto resume_replay() -> void;
 	private:
 		static const size_t header_len = 4;
 		static const size_t max_buffer_len = 65535;
+		static const size_t max_pooled_send_buffers = 8;
+		static const size_t max_coalesced_packets = 64;
+
+		struct outbound_packet {
+			array<unsigned char, header_len> header;
+			size_t header_size = 0;
+			size_t payload_size = 0;
+			// Exactly one of these holds the payload - ciphertext is per-session, plaintext may be shared between sessions
+			vector<unsigned char> owned_payload;
+			vana::util::shared_array<unsigned char> shared_payload;
+
+			auto get_payload() const -> const unsigned char * { return shared_payload ? shared_payload.get() : owned_payload.data(); }
+		};
 
 		auto sync_read(size_t minimum_bytes) -> pair<asio::error_code, packet_reader>;
 		auto start_read_header() -> void;
+		auto flush_send_queue() -> void;
 		auto handle_write(const asio::error_code &error, size_t bytes_transferred) -> void;
 		auto handle_read_header(const asio::error_code &error, size_t bytes_transferred) -> void;
 		auto handle_read_body(const asio::error_code &error, size_t bytes_transferred) -> void;
 		auto get_socket() -> asio::ip::tcp::socket &;
 		auto get_codec() -> packet_transformer &;
 		auto get_buffer() -> vana::util::shared_array<unsigned char> &;
-		auto start(const config::ping &ping, ref_ptr<packet_transformer> transformer) -> void;
-		auto send(const unsigned char *buf, int32_t len, bool encrypt = true) -> void;
+		auto start(const config::ping &ping, ref_ptr<packet_transformer> transformer, size_t send_queue_limit = 0) -> void;
+		auto start_replay(const ip &source) -> void;
+		auto replay_next() -> void;
+		auto send(const vana::util::shared_array<unsigned char> &buf, size_t len, bool encrypt) -> void;
+		auto lease_send_buffer(size_t len) -> vector<unsigned char>;
 		auto ping() -> void;
 		auto base_handle_request(packet_reader &reader) -> void;
 
@@ -74,6 +101,13 @@ namespace vana {
 		friend class connection_listener;
 
 		bool m_is_connected = false;
+		bool m_is_writing = false;
+		bool m_flush_pending = false;
+		bool m_send_queue_overflowed = false;
+		bool m_is_replay = false;
+		bool m_is_replaying = false;
+		bool m_replay_held = false;
+		uint32_t m_capture_session = 0;
 		connection_type m_type = connection_type::unknown;
 		int8_t m_ping_count = 0;
 		int32_t m_max_ping_count = 0;
@@ -83,8 +117,16 @@ namespace vana {
 		ip m_ip;
 		connection_manager &m_manager;
 		asio::ip::tcp::socket m_socket;
+		asio::io_service::strand m_strand;
 		vana::util::shared_array<unsigned char> m_buffer;
-		vana::util::shared_array<unsigned char> m_send_packet;
+		size_t m_send_queue_limit = 0;
+		size_t m_queued_bytes = 0;
+		queue<outbound_packet> m_send_queue;
+		// An empty entry stands for the client disconnecting
+		queue<vector<unsigned char>> m_replay_queue;
+		vector<outbound_packet> m_in_flight;
+		vector<asio::const_buffer> m_write_buffers;
+		vector<vector<unsigned char>> m_send_buffer_pool;
 		ref_ptr<packet_transformer> m_codec;
 		mutex m_send_mutex;
 	};
@@ -24,19 +24,62 @@ namespace vana {
 namespace timer {
 
 auto container::is_timer_running(const id &id) const -> bool {
+	owned_lock<mutex> l{m_timers_mutex};
 	return m_timers.find(id) != std::end(m_timers);
 }
 
-auto container::register_timer(ref_ptr<timer> timer, const id &id, time_point run_at) -> void {
-	m_timers[id] = timer;
-	vana::timer::thread::get_instance().register_timer(timer, run_at);
+auto container::register_timer(func f, const id &id, const time_point &run_at, const duration &repeat) -> void {
+	auto &thread = vana::timer::thread::get_instance();
+	owned_lock<mutex> l{m_timers_mutex};
+	timer *&current = m_timers[id];
+	if (current != nullptr) {
+		// Replaced timers are taken off the wheel now rather than when they come due
+		thread.cancel_timer(current);
+	}
+	current = thread.create_timer(std::move(f), id, shared_from_this(), run_at, repeat);
 }
 
 auto container::remove_timer(const id &id) -> void {
+	remove_timer(id, nullptr);
+}
+
+auto container::remove_timer(const id &id, const timer *timer) -> void {
+	owned_lock<mutex> l{m_timers_mutex};
+	auto iter = m_timers.find(id);
+	if (iter == std::end(m_timers) || (timer != nullptr && iter->second != timer)) {
+		return;
+	}
+
+	vana::timer::thread::get_instance().cancel_timer(iter->second);
+	m_timers.erase(iter);
+}
+
+auto container::get_time_left(const id &id) const -> duration {
+	owned_lock<mutex> l{m_timers_mutex};
 	auto iter = m_timers.find(id);
-	if (iter != std::end(m_timers)) {
-		m_timers.erase(iter);
+	if (iter == std::end(m_timers)) {
+		return duration{0};
+	}
+	return vana::timer::thread::get_instance().get_time_left(iter->second);
+}
+
+auto container::set_dispatcher(dispatcher dispatcher) -> void {
+	owned_lock<mutex> l{m_dispatcher_mutex};
+	m_dispatcher = dispatcher;
+}
+
+auto container::dispatch(function<void()> work) const -> bool {
+	dispatcher current;
+	{
+		owned_lock<mutex> l{m_dispatcher_mutex};
+		current = m_dispatcher;
+	}
+
+	if (current == nullptr) {
+		return false;
 	}
+	current(work);
+	return true;
 }
 
 }
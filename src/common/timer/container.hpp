@@ -17,34 +17,44 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
-#include "common/timer/timer.hpp"
+#include "common/timer/dispatcher.hpp"
+#include "common/timer/func.hpp"
 #include "common/timer/id.hpp"
+#include "common/timer/timer.hpp"
 #include "common/timer/type.hpp"
 #include "common/types.hpp"
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace vana {
 	namespace timer {
-		class container {
+		class container : public enable_shared<container> {
 		public:
 			template <typename TDuration>
 			auto get_remaining_time(const id &id) const -> TDuration;
 			auto is_timer_running(const id &id) const -> bool;
-			auto register_timer(ref_ptr<timer> timer, const id &id, time_point run_at) -> void;
 			auto remove_timer(const id &id) -> void;
+			auto set_dispatcher(dispatcher dispatcher) -> void;
+			auto dispatch(function<void()> work) const -> bool;
 		private:
-			hash_map<id, ref_ptr<timer>> m_timers;
+			friend class timer;
+
+			auto register_timer(func f, const id &id, const time_point &run_at, const duration &repeat) -> void;
+			auto remove_timer(const id &id, const timer *timer) -> void;
+			auto get_time_left(const id &id) const -> duration;
+
+			// Timers of a container that goes away never run, the timer thread releases them when they come due
+			hash_map<id, timer *> m_timers;
+			mutable mutex m_timers_mutex;
+			dispatcher m_dispatcher;
+			mutable mutex m_dispatcher_mutex; // The owner sets the dispatcher while the timer thread dispatches through it
 		};
 
 		template <typename TDuration>
 		auto container::get_remaining_time(const id &id) const -> TDuration {
-			auto iter = m_timers.find(id);
-			if (iter != std::end(m_timers)) {
-				return duration_cast<TDuration>(iter->second->get_time_left());
-			}
-			return TDuration{0};
+			return duration_cast<TDuration>(get_time_left(id));
 		}
 	}
 }
\ No newline at end of file
@@ -18,6 +18,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #pragma once
 
 #include "common/timer/container.hpp"
+#include "common/timer/dispatcher.hpp"
 #include "common/types.hpp"
 #include <memory>
 
@@ -28,6 +29,9 @@ namespace vana {
 			container_holder() {
 				m_timers = make_ref_ptr<vana::timer::container>();
 			}
+
+			// Timers registered in this container will have their callbacks handed to the dispatcher instead of running on the timer thread
+			auto set_timer_dispatcher(vana::timer::dispatcher dispatcher) -> void { m_timers->set_dispatcher(dispatcher); }
 		protected:
 			auto clear_timers() -> void { m_timers.reset(); }
 			auto get_timers() const -> ref_ptr<vana::timer::container> { return m_timers; }
@@ -21,9 +21,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 namespace vana {
 	namespace timer {
-		enum class run_result {
-			reset,
-			complete,
-		};
+		// Hands a ready timer callback to the execution context that owns the timer's state
+		using dispatcher = function<void(function<void()>)>;
 	}
-}
\ No newline at end of file
+}
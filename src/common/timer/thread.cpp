@@ -20,6 +20,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common/timer/container.hpp"
 #include "common/util/thread_pool.hpp"
 #include "common/util/time.hpp"
+#include <algorithm>
 #include <chrono>
 #include <functional>
 
@@ -31,32 +32,19 @@ thread::thread()
 	m_container = make_ref_ptr<container>();
 	m_thread = vana::util::thread_pool::lease(
 		[this](owned_lock<recursive_mutex> &lock) {
-			time_point wait_time = get_wait_time();
 			time_point now = vana::util::time::get_now();
-
-			while (wait_time <= now && m_timers.size() > 0) {
-				timer_pair top = m_timers.top();
-
-				if (ref_ptr<timer> timer = top.second.lock()) {
-					m_timers.pop();
-
-					if (timer->run(now) == run_result::reset) {
-						m_timers.emplace(timer->reset(now), timer);
-					}
-					else {
-						timer->remove_from_container();
-					}
-
-					wait_time = get_wait_time();
-				}
-				else {
-					// Expired timer
-					m_timers.pop();
-					continue;
-				}
+			wheel_node expired;
+			m_timers.collect(now, expired);
+
+			// Callbacks run without the lock, so timers can be registered and cancelled while a batch executes
+			while (timer *timer = m_timers.pop(expired)) {
+				timer->m_running = true;
+				lock.unlock();
+				run_timer(timer, now);
+				lock.lock();
 			}
 
-			m_main_loop_condition.wait_until(lock, wait_time);
+			m_main_loop_condition.wait_until(lock, get_wait_time());
 		},
 		[this] {
 			m_main_loop_condition.notify_one();
@@ -72,15 +60,74 @@ auto thread::get_timer_container() const -> ref_ptr<container> {
 	return m_container;
 }
 
-auto thread::register_timer(ref_ptr<timer> timer, time_point run_at) -> void {
+auto thread::create_timer(func f, const id &id, ref_ptr<container> container, const time_point &run_at, const duration &repeat) -> timer * {
+	owned_lock<recursive_mutex> l{m_timers_mutex};
+	timer *timer = m_timers.acquire();
+	timer->m_id = id;
+	timer->m_container = container;
+	timer->m_run_at = run_at;
+	timer->m_repeat_time = repeat;
+	timer->m_function = std::move(f);
+	m_timers.schedule(timer, run_at);
+	m_main_loop_condition.notify_one();
+	return timer;
+}
+
+auto thread::cancel_timer(timer *timer) -> void {
+	owned_lock<recursive_mutex> l{m_timers_mutex};
+	if (timer->m_running) {
+		// Its callback is in flight, the timer goes back to the pool once that's done
+		timer->m_cancelled = true;
+		return;
+	}
+
+	m_timers.cancel(timer);
+	m_timers.release(timer);
+}
+
+auto thread::get_time_left(const timer *timer) -> duration {
 	owned_lock<recursive_mutex> l{m_timers_mutex};
-	m_timers.emplace(run_at, timer);
+	// A repeating timer whose callback is still running hasn't been given its next run time yet
+	return std::max(timer->m_run_at - vana::util::time::get_now(), duration{0});
+}
+
+auto thread::run_timer(timer *timer, const time_point &now) -> void {
+	ref_ptr<container> container = timer->m_container.lock();
+	if (container != nullptr && container->dispatch([this, timer, now] { execute_timer(timer, now); })) {
+		return;
+	}
+
+	execute_timer(timer, now);
+}
+
+auto thread::execute_timer(timer *timer, const time_point &now) -> void {
+	bool stale = false;
+	{
+		owned_lock<recursive_mutex> l{m_timers_mutex};
+		// Dispatched callbacks may run after the owner removed or replaced the timer, or after its container went away
+		stale = timer->m_cancelled || timer->m_container.expired();
+	}
+
+	if (!stale) {
+		timer->execute(now);
+	}
+
+	owned_lock<recursive_mutex> l{m_timers_mutex};
+	timer->m_running = false;
+	if (stale || timer->m_cancelled || !timer->is_repeating()) {
+		m_timers.release(timer);
+		return;
+	}
+
+	timer->m_run_at = now + timer->m_repeat_time;
+	m_timers.schedule(timer, timer->m_run_at);
 	m_main_loop_condition.notify_one();
 }
 
 auto thread::get_wait_time() const -> time_point {
-	if (m_timers.size() > 0) {
-		return m_timers.top().first;
+	optional<time_point> next = m_timers.get_next_expiry();
+	if (next.is_initialized()) {
+		return next.get();
 	}
 
 	return vana::util::time::get_now_with_time_added(milliseconds{1000000000});
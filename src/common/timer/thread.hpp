@@ -17,16 +17,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 */
 #pragma once
 
+#include "common/timer/func.hpp"
+#include "common/timer/id.hpp"
+#include "common/timer/wheel.hpp"
 #include "common/types.hpp"
 #include <atomic>
 #include <condition_variable>
-#include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
-#include <utility>
-#include <vector>
 
 namespace vana {
 	namespace timer {
@@ -38,19 +37,17 @@ namespace vana {
 		public:
 			~thread();
 			auto get_timer_container() const -> ref_ptr<container>;
-			auto register_timer(ref_ptr<timer> timer, time_point run_at) -> void;
 		private:
-			auto get_wait_time() const -> time_point;
-
-			using timer_pair = pair<time_point, view_ptr<timer>>;
+			friend class container;
 
-			struct find_closest_timer {
-				auto operator()(const timer_pair &t1, const timer_pair &t2) const -> bool {
-					return t1.first > t2.first;
-				}
-			};
+			auto create_timer(func f, const id &id, ref_ptr<container> container, const time_point &run_at, const duration &repeat) -> timer *;
+			auto cancel_timer(timer *timer) -> void;
+			auto get_time_left(const timer *timer) -> duration;
+			auto get_wait_time() const -> time_point;
+			auto run_timer(timer *timer, const time_point &now) -> void;
+			auto execute_timer(timer *timer, const time_point &now) -> void;
 
-			std::priority_queue<timer_pair, vector<timer_pair>, find_closest_timer> m_timers;
+			wheel m_timers;
 			std::condition_variable_any m_main_loop_condition;
 			recursive_mutex m_timers_mutex;
 			ref_ptr<std::thread> m_thread;
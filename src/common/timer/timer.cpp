@@ -24,43 +24,31 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 namespace vana {
 namespace timer {
 
-auto timer::create(const func f, const id &id, ref_ptr<container> container, const duration &difference_from_now, const duration &repeat) -> void {
+auto timer::create(func f, const id &id, ref_ptr<container> container, const duration &difference_from_now, const duration &repeat) -> void {
 	if (container == nullptr) {
 		container = vana::timer::thread::get_instance().get_timer_container();
 	}
 
-	ref_ptr<timer> timer = make_ref_ptr<vana::timer::timer>(f, id, container, difference_from_now, repeat);
-	container->register_timer(timer, id, timer->m_run_at);
+	container->register_timer(std::move(f), id, vana::util::time::get_now_with_time_added(difference_from_now), repeat);
 }
 
-timer::timer(const func f, const id &id, ref_ptr<container> container, const duration &difference_from_now, const duration &repeat) :
-	m_id{id},
-	m_container{container},
-	m_repeat_time{repeat},
-	m_function{f}
+timer::timer() :
+	m_id{vana::timer::type{}}
 {
-	m_repeat = repeat.count() != 0;
-	m_run_at = vana::util::time::get_now_with_time_added(difference_from_now);
 }
 
-auto timer::remove_from_container() const -> void {
-	if (ref_ptr<container> container = m_container.lock()) {
-		container->remove_timer(m_id);
-	}
-}
-
-auto timer::run(const time_point &now) const -> run_result {
+auto timer::execute(const time_point &now) -> void {
 	m_function(now);
-	return m_repeat ? run_result::reset : run_result::complete;
-}
-
-auto timer::reset(const time_point &now) -> time_point {
-	m_run_at = now + m_repeat_time;
-	return m_run_at;
+	if (!is_repeating()) {
+		// Completed timers take themselves out of their container unless the callback already replaced or removed them
+		if (ref_ptr<container> container = m_container.lock()) {
+			container->remove_timer(m_id, this);
+		}
+	}
 }
 
-auto timer::get_time_left() const -> duration {
-	return m_run_at - vana::util::time::get_now();
+auto timer::is_repeating() const -> bool {
+	return m_repeat_time.count() != 0;
 }
 
 }
@@ -19,8 +19,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #include "common/timer/func.hpp"
 #include "common/timer/id.hpp"
-#include "common/timer/run_result.hpp"
 #include "common/timer/type.hpp"
+#include "common/timer/wheel.hpp"
 #include "common/types.hpp"
 #include <ctime>
 #include <functional>
@@ -28,28 +28,32 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 namespace vana {
 	namespace timer {
-
 		class container;
 		class thread;
 
-		class timer {
+		// Timers are the wheel's nodes, they're drawn from its pool and indexed by id in their container
+		class timer : public wheel_node {
 			NONCOPYABLE(timer);
-			NO_DEFAULT_CONSTRUCTOR(timer);
 		public:
-			timer(const func f, const id &id, ref_ptr<container> container, const duration &difference_from_now, const duration &repeat);
-			static auto create(const func f, const id &id, ref_ptr<container> container, const duration &difference_from_now, const duration &repeat = seconds{0}) -> void;
-
-			auto get_time_left() const -> duration;
-			auto run(const time_point &now) const -> run_result;
-			auto reset(const time_point &now) -> time_point;
-			auto remove_from_container() const -> void;
+			static auto create(func f, const id &id, ref_ptr<container> container, const duration &difference_from_now, const duration &repeat = seconds{0}) -> void;
 		private:
+			friend class container;
+			friend class thread;
+			friend class wheel;
+
+			timer();
+
+			auto execute(const time_point &now) -> void;
+			auto is_repeating() const -> bool;
+
 			id m_id;
 			view_ptr<container> m_container;
 			time_point m_run_at;
-			bool m_repeat;
 			duration m_repeat_time;
 			func m_function;
+			// Owned by the timer thread
+			bool m_running = false;
+			bool m_cancelled = false;
 		};
 	}
 }
\ No newline at end of file
@@ -26,6 +26,7 @@ namespace vana {
 			energy_charge_timer,
 			cool_timer,
 			instance_timer,
+			load_test_timer,
 			maple_tv_timer,
 			map_timer,
 			mist_timer,
@@ -33,6 +34,7 @@ namespace vana {
 			mob_heal_timer,
 			mob_remove_timer,
 			mob_status_timer,
+			packet_stats_timer,
 			pet_timer,
 			pickpocket_timer,
 			ping_timer,
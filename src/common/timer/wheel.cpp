@@ -0,0 +1,237 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "wheel.hpp"
+#include "common/timer/timer.hpp"
+#include "common/util/time.hpp"
+#include <algorithm>
+
+namespace vana {
+namespace timer {
+
+// Timers are rounded up to the next tick so they never fire early
+const milliseconds tick_length = milliseconds{1};
+
+wheel::wheel() :
+	m_start{vana::util::time::get_now()}
+{
+	for (auto &slot : m_near) {
+		slot.prev = &slot;
+		slot.next = &slot;
+	}
+	for (auto &level : m_far) {
+		for (auto &slot : level) {
+			slot.prev = &slot;
+			slot.next = &slot;
+		}
+	}
+}
+
+wheel::~wheel() = default;
+
+auto wheel::schedule(timer *timer, const time_point &run_at) -> void {
+	if (m_count == 0) {
+		// Nothing is pending, skip the idle ticks instead of walking through them on the next advance
+		m_tick = std::max(m_tick, get_tick(vana::util::time::get_now(), false));
+	}
+
+	timer->expires = get_tick(run_at, true);
+	place(timer);
+	m_count++;
+}
+
+auto wheel::cancel(timer *timer) -> void {
+	// Works the same whether the timer is still in its slot or already collected
+	unlink(timer);
+	m_count--;
+}
+
+auto wheel::collect(const time_point &now, wheel_node &expired) -> void {
+	expired.prev = &expired;
+	expired.next = &expired;
+
+	uint64_t now_tick = get_tick(now, false);
+	while (m_tick <= now_tick) {
+		size_t index = m_tick & (near_slots - 1);
+		if (index == 0) {
+			cascade();
+		}
+
+		wheel_node batch;
+		splice(&m_near[index], &batch);
+		while (!is_empty(&batch)) {
+			wheel_node *node = batch.next;
+			unlink(node);
+			link(&expired, node);
+		}
+
+		// Anything scheduled by the callbacks lands in a later slot
+		m_tick++;
+	}
+}
+
+auto wheel::pop(wheel_node &expired) -> timer * {
+	// Collected timers may be cancelled while earlier ones run, so they're consumed from the front
+	if (is_empty(&expired)) {
+		return nullptr;
+	}
+
+	wheel_node *node = expired.next;
+	unlink(node);
+	m_count--;
+	return static_cast<timer *>(node);
+}
+
+auto wheel::get_next_expiry() const -> optional<time_point> {
+	optional<time_point> ret;
+	if (m_count == 0) {
+		return ret;
+	}
+
+	uint64_t tick = m_tick;
+	if ((tick & (near_slots - 1)) != 0) {
+		do {
+			if (!is_empty(&m_near[tick & (near_slots - 1)])) {
+				break;
+			}
+			tick++;
+		} while ((tick & (near_slots - 1)) != 0);
+	}
+
+	// Either an occupied slot or the next wrap, which cascades the outer levels
+	ret = get_time(tick);
+	return ret;
+}
+
+auto wheel::place(wheel_node *node) -> void {
+	uint64_t expires = std::max(node->expires, m_tick);
+	uint64_t delta = expires - m_tick;
+	if (delta < near_slots) {
+		link(&m_near[expires & (near_slots - 1)], node);
+		return;
+	}
+
+	for (size_t level = 0; level < far_levels; level++) {
+		uint8_t shift = near_bits + static_cast<uint8_t>(level * far_bits);
+		uint64_t range = uint64_t{1} << (shift + far_bits);
+		if (delta < range || level == far_levels - 1) {
+			if (delta >= range) {
+				// Further out than the wheel spans, it's placed again when the outermost slot cascades
+				expires = m_tick + range - 1;
+			}
+			link(&m_far[level][(expires >> shift) & (far_slots - 1)], node);
+			return;
+		}
+	}
+}
+
+auto wheel::cascade() -> void {
+	for (size_t level = 0; level < far_levels; level++) {
+		size_t index = (m_tick >> (near_bits + level * far_bits)) & (far_slots - 1);
+
+		wheel_node batch;
+		splice(&m_far[level][index], &batch);
+		while (!is_empty(&batch)) {
+			wheel_node *node = batch.next;
+			unlink(node);
+			place(node);
+		}
+
+		if (index != 0) {
+			break;
+		}
+	}
+}
+
+auto wheel::acquire() -> timer * {
+	if (m_free == nullptr) {
+		m_chunks.emplace_back(new timer[node_chunk_size]);
+		timer *chunk = m_chunks.back().get();
+		for (size_t i = 0; i < node_chunk_size; i++) {
+			chunk[i].next = m_free;
+			m_free = &chunk[i];
+		}
+	}
+
+	timer *timer = m_free;
+	m_free = static_cast<vana::timer::timer *>(timer->next);
+	timer->next = nullptr;
+	return timer;
+}
+
+auto wheel::release(timer *timer) -> void {
+	// Drops whatever the callback captured, the timer itself goes back to the pool
+	timer->m_function = nullptr;
+	timer->m_container.reset();
+	timer->m_cancelled = false;
+	timer->prev = nullptr;
+	timer->next = m_free;
+	m_free = timer;
+}
+
+auto wheel::get_tick(const time_point &at, bool round_up) const -> uint64_t {
+	if (at <= m_start) {
+		return 0;
+	}
+
+	auto elapsed = at - m_start;
+	uint64_t ticks = static_cast<uint64_t>(elapsed / tick_length);
+	if (round_up && elapsed % tick_length != duration{0}) {
+		ticks++;
+	}
+	return ticks;
+}
+
+auto wheel::get_time(uint64_t tick) const -> time_point {
+	return m_start + duration_cast<duration>(tick_length * static_cast<int64_t>(tick));
+}
+
+auto wheel::link(wheel_node *list, wheel_node *node) -> void {
+	node->prev = list->prev;
+	node->next = list;
+	list->prev->next = node;
+	list->prev = node;
+}
+
+auto wheel::unlink(wheel_node *node) -> void {
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+	node->prev = nullptr;
+	node->next = nullptr;
+}
+
+auto wheel::splice(wheel_node *from, wheel_node *to) -> void {
+	if (is_empty(from)) {
+		to->prev = to;
+		to->next = to;
+		return;
+	}
+
+	to->next = from->next;
+	to->prev = from->prev;
+	to->next->prev = to;
+	to->prev->next = to;
+	from->prev = from;
+	from->next = from;
+}
+
+auto wheel::is_empty(const wheel_node *list) -> bool {
+	return list->next == list;
+}
+
+}
+}
\ No newline at end of file
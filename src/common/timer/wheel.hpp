@@ -0,0 +1,80 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/types.hpp"
+#include "common/util/optional.hpp"
+#include <array>
+#include <memory>
+
+namespace vana {
+	namespace timer {
+		class timer;
+
+		// Intrusive list links, slot heads are bare links and every pending timer is linked into exactly one slot
+		struct wheel_node {
+			wheel_node *prev = nullptr;
+			wheel_node *next = nullptr;
+			uint64_t expires = 0;
+		};
+
+		// Hashed hierarchical timing wheel
+		// Insertion and cancellation are O(1), timers due in the same tick are expired as one batch
+		// Timers further out sit in coarser levels and are cascaded down as the inner level wraps
+		// The wheel also owns the timers themselves, they're pooled and handed out by acquire
+		// Not thread-safe, the timer thread serializes access
+		class wheel {
+			NONCOPYABLE(wheel);
+		public:
+			wheel();
+			~wheel();
+
+			auto acquire() -> timer *;
+			auto release(timer *timer) -> void;
+			auto schedule(timer *timer, const time_point &run_at) -> void;
+			auto cancel(timer *timer) -> void;
+			auto collect(const time_point &now, wheel_node &expired) -> void;
+			auto pop(wheel_node &expired) -> timer *;
+			auto get_next_expiry() const -> optional<time_point>;
+		private:
+			static const uint8_t near_bits = 8;
+			static const uint8_t far_bits = 6;
+			static const size_t near_slots = 1 << near_bits;
+			static const size_t far_slots = 1 << far_bits;
+			static const size_t far_levels = 4;
+			static const size_t node_chunk_size = 256;
+
+			auto place(wheel_node *node) -> void;
+			auto cascade() -> void;
+			auto get_tick(const time_point &at, bool round_up) const -> uint64_t;
+			auto get_time(uint64_t tick) const -> time_point;
+			static auto link(wheel_node *list, wheel_node *node) -> void;
+			static auto unlink(wheel_node *node) -> void;
+			static auto splice(wheel_node *from, wheel_node *to) -> void;
+			static auto is_empty(const wheel_node *list) -> bool;
+
+			uint64_t m_tick = 0; // Next tick to be processed
+			size_t m_count = 0;
+			time_point m_start;
+			timer *m_free = nullptr;
+			vector<owned_ptr<timer[]>> m_chunks;
+			std::array<wheel_node, near_slots> m_near;
+			std::array<std::array<wheel_node, far_slots>, far_levels> m_far;
+		};
+	}
+}
\ No newline at end of file
@@ -27,6 +27,15 @@ auto exists(const string &file) -> bool {
 	return (!stat(file.c_str(), &file_info)) != 0;
 }
 
+auto get_modified_time(const string &file, time_t &modified) -> bool {
+	struct stat file_info;
+	if (stat(file.c_str(), &file_info) != 0) {
+		return false;
+	}
+	modified = file_info.st_mtime;
+	return true;
+}
+
 auto remove_extension(const string &file) -> string {
 	string ret = file;
 	ret = ret.erase(ret.find_last_of('.'));
@@ -18,12 +18,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #pragma once
 
 #include "common/types.hpp"
+#include <ctime>
 #include <string>
 
 namespace vana {
 	namespace util {
 		namespace file {
 			auto exists(const string &file) -> bool;
+			// Returns false if the file doesn't exist
+			auto get_modified_time(const string &file, time_t &modified) -> bool;
 			auto remove_extension(const string &file) -> string;
 		}
 	}
@@ -0,0 +1,86 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace vana {
+namespace util {
+
+auto latency_histogram::record(uint64_t value) -> void {
+	m_buckets[get_bucket(value)]++;
+	m_count++;
+	m_total += value;
+	m_max = std::max(m_max, value);
+}
+
+auto latency_histogram::merge(const latency_histogram &other) -> void {
+	for (size_t i = 0; i < bucket_count; i++) {
+		m_buckets[i] += other.m_buckets[i];
+	}
+	m_count += other.m_count;
+	m_total += other.m_total;
+	m_max = std::max(m_max, other.m_max);
+}
+
+auto latency_histogram::get_percentile(double percentile) const -> uint64_t {
+	if (m_count == 0) {
+		return 0;
+	}
+
+	uint64_t target = static_cast<uint64_t>(std::ceil(m_count * percentile / 100.));
+	target = std::min(std::max<uint64_t>(target, 1), m_count);
+
+	uint64_t seen = 0;
+	for (size_t i = 0; i < bucket_count; i++) {
+		seen += m_buckets[i];
+		if (seen >= target) {
+			return std::min(get_bucket_upper_bound(i), m_max);
+		}
+	}
+	return m_max;
+}
+
+auto latency_histogram::get_bucket(uint64_t value) -> size_t {
+	if (value < sub_bucket_count) {
+		return static_cast<size_t>(value);
+	}
+
+	uint32_t top_bit = 0;
+	for (uint64_t remaining = value; remaining >>= 1;) {
+		top_bit++;
+	}
+
+	// The bits right below the top bit pick the bucket within its power of two
+	uint32_t shift = top_bit - sub_bucket_bits;
+	size_t sub_bucket = static_cast<size_t>(value >> shift) - sub_bucket_count;
+	return (shift + 1) * sub_bucket_count + sub_bucket;
+}
+
+auto latency_histogram::get_bucket_upper_bound(size_t bucket) -> uint64_t {
+	if (bucket < sub_bucket_count) {
+		return bucket;
+	}
+
+	uint32_t shift = static_cast<uint32_t>(bucket / sub_bucket_count) - 1;
+	uint64_t lower = static_cast<uint64_t>(sub_bucket_count + bucket % sub_bucket_count) << shift;
+	return lower + ((static_cast<uint64_t>(1) << shift) - 1);
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/types.hpp"
+#include <array>
+
+namespace vana {
+	namespace util {
+		// Log-linear histogram in the spirit of HdrHistogram
+		// Each power of two is split into a few equally sized buckets, so the error on a reported value is at most 25% at any magnitude
+		class latency_histogram {
+		public:
+			auto record(uint64_t value) -> void;
+			auto merge(const latency_histogram &other) -> void;
+			// Upper bound of the bucket that holds the given percentile (0-100)
+			auto get_percentile(double percentile) const -> uint64_t;
+			auto get_count() const -> uint64_t { return m_count; }
+			auto get_total() const -> uint64_t { return m_total; }
+			auto get_max() const -> uint64_t { return m_max; }
+		private:
+			static const uint32_t sub_bucket_bits = 2;
+			static const uint32_t sub_bucket_count = 1 << sub_bucket_bits;
+			static const size_t bucket_count = (64 - sub_bucket_bits + 1) * sub_bucket_count;
+
+			static auto get_bucket(uint64_t value) -> size_t;
+			static auto get_bucket_upper_bound(size_t bucket) -> uint64_t;
+
+			array<uint64_t, bucket_count> m_buckets = {};
+			uint64_t m_count = 0;
+			uint64_t m_total = 0;
+			uint64_t m_max = 0;
+		};
+	}
+}
\ No newline at end of file
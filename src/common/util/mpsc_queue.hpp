@@ -0,0 +1,67 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/types.hpp"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace vana {
+	namespace util {
+		// Lock-free queue that any number of threads can push to
+		// The consumer takes everything that's been pushed at once, which suits batching writers
+		template <typename TElement>
+		class mpsc_queue {
+			NONCOPYABLE(mpsc_queue);
+		public:
+			mpsc_queue() = default;
+
+			~mpsc_queue() {
+				take_all();
+			}
+
+			auto push(TElement value) -> void {
+				node *current = new node{std::move(value), m_head.load(std::memory_order_relaxed)};
+				while (!m_head.compare_exchange_weak(current->next, current, std::memory_order_release, std::memory_order_relaxed));
+			}
+
+			// Returns the elements in the order they were pushed
+			auto take_all() -> vector<TElement> {
+				vector<TElement> ret;
+				node *current = m_head.exchange(nullptr, std::memory_order_acquire);
+				while (current != nullptr) {
+					ret.push_back(std::move(current->value));
+					node *next = current->next;
+					delete current;
+					current = next;
+				}
+
+				std::reverse(std::begin(ret), std::end(ret));
+				return ret;
+			}
+		private:
+			struct node {
+				TElement value;
+				node *next;
+			};
+
+			std::atomic<node *> m_head{nullptr};
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "channel_handler.hpp"
+#include "common/packet_reader.hpp"
+#include "common/point.hpp"
+#include "channel_server/smsg_header.hpp"
+#include "load_tester/client.hpp"
+#include "load_tester/load_tester.hpp"
+
+namespace vana {
+namespace load_tester {
+
+auto channel_handler::handle(client &current, packet_reader &reader) -> void {
+	switch (reader.get<packet_header>()) {
+		case SMSG_CHANGE_MAP: handle_change_map(current, reader); break;
+		case SMSG_PLAYER_MOVEMENT: handle_player_movement(current, reader); break;
+		case SMSG_ATTACK_MELEE: handle_melee_attack(current, reader); break;
+		case SMSG_MOB_SHOW: current.on_mob_shown(reader.get<game_map_object>()); break;
+		case SMSG_MOB_CONTROL: handle_mob_control(current, reader); break;
+		case SMSG_MOB_DEATH: current.on_mob_removed(reader.get<game_map_object>()); break;
+		case SMSG_DROP_ITEM: handle_drop_item(current, reader); break;
+		case SMSG_DROP_PICKUP: {
+			reader.unk<int8_t>();
+			current.on_drop_removed(reader.get<game_map_object>());
+			break;
+		}
+	}
+}
+
+auto channel_handler::handle_change_map(client &current, packet_reader &reader) -> void {
+	reader.skip<int32_t>(); // Channel
+	current.on_map_changed(reader.get<game_portal_count>());
+}
+
+auto channel_handler::handle_player_movement(client &current, packet_reader &reader) -> void {
+	game_player_id player_id = reader.get<game_player_id>();
+	reader.skip<point>(); // Original position
+	if (reader.get<uint8_t>() == 0 || reader.get<int8_t>() != 0) {
+		// Not one of ours, we only ever send a single normal movement
+		return;
+	}
+
+	reader.skip<point>();
+	reader.skip<int16_t>(); // X velocity
+	reader.skip<int16_t>(); // Y velocity
+	reader.skip<game_foothold_id>();
+	reader.skip<int8_t>(); // Stance
+	current.get_tester().record_move_seen(player_id, reader.get<int16_t>());
+}
+
+auto channel_handler::handle_melee_attack(client &current, packet_reader &reader) -> void {
+	current.get_tester().record_attack_seen(reader.get<game_player_id>());
+}
+
+auto channel_handler::handle_mob_control(client &current, packet_reader &reader) -> void {
+	// Losing control doesn't mean the mob is gone
+	if (reader.get<int8_t>() != 0) {
+		current.on_mob_shown(reader.get<game_map_object>());
+	}
+}
+
+auto channel_handler::handle_drop_item(client &current, packet_reader &reader) -> void {
+	reader.unk<int8_t>(); // Spawn type
+	game_map_object drop_id = reader.get<game_map_object>();
+	reader.skip<bool>(); // Mesos
+	reader.skip<int32_t>(); // Object ID
+	reader.skip<int32_t>(); // Owner
+	reader.skip<int8_t>(); // Owner type
+	current.on_drop_shown(drop_id, reader.get<point>());
+}
+
+}
+}
\ No newline at end of file
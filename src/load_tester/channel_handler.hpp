@@ -0,0 +1,37 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/types.hpp"
+
+namespace vana {
+	class packet_reader;
+
+	namespace load_tester {
+		class client;
+
+		namespace channel_handler {
+			auto handle(client &current, packet_reader &reader) -> void;
+			auto handle_change_map(client &current, packet_reader &reader) -> void;
+			auto handle_player_movement(client &current, packet_reader &reader) -> void;
+			auto handle_melee_attack(client &current, packet_reader &reader) -> void;
+			auto handle_mob_control(client &current, packet_reader &reader) -> void;
+			auto handle_drop_item(client &current, packet_reader &reader) -> void;
+		}
+	}
+}
\ No newline at end of file
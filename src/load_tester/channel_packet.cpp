@@ -0,0 +1,119 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "channel_packet.hpp"
+#include "channel_server/cmsg_header.hpp"
+
+namespace vana {
+namespace load_tester {
+namespace packets {
+namespace channel {
+
+// Any foothold other than 0 keeps the server from treating the client as falling off the map
+const game_foothold_id standing_foothold = 1;
+
+PACKET_IMPL(player_load, game_player_id player_id) {
+	packet_builder builder;
+	builder
+		.add<packet_header>(CMSG_PLAYER_LOAD)
+		.add<game_player_id>(player_id)
+		.unk<int8_t>()
+		.unk<int8_t>();
+	return builder;
+}
+
+PACKET_IMPL(move, game_portal_count portal_count, const point &from, const point &to, int16_t sequence) {
+	packet_builder builder;
+	builder
+		.add<packet_header>(CMSG_PLAYER_MOVE)
+		.add<game_portal_count>(portal_count)
+		.unk<int32_t>()
+		.add<point>(from)
+		.add<uint8_t>(1)
+		.add<int8_t>(0) // Normal movement
+		.add<point>(to)
+		.add<int16_t>(0) // X velocity
+		.add<int16_t>(0) // Y velocity
+		.add<game_foothold_id>(standing_foothold)
+		.add<int8_t>(0) // Stance
+		.add<int16_t>(sequence)
+		.add<uint8_t>(0) // Keypad states
+		.add<int16_t>(from.x) // Bounds
+		.add<int16_t>(from.y)
+		.add<int16_t>(to.x)
+		.add<int16_t>(to.y);
+	return builder;
+}
+
+PACKET_IMPL(melee_attack, game_portal_count portal_count, game_tick_count ticks, const point &pos, optional<game_map_object> target, game_damage damage) {
+	uint8_t targets = target.is_initialized() ? 1 : 0;
+	packet_builder builder;
+	builder
+		.add<packet_header>(CMSG_ATTACK_MELEE)
+		.add<game_portal_count>(portal_count)
+		.add<uint8_t>(static_cast<uint8_t>(targets * 0x10 + 1))
+		.add<game_skill_id>(0) // Regular attack
+		.unk<game_checksum>()
+		.unk<game_checksum>()
+		.add<uint8_t>(0) // Display
+		.add<uint8_t>(0) // Animation
+		.add<uint8_t>(0) // Weapon class
+		.add<uint8_t>(0) // Weapon speed
+		.add<game_tick_count>(ticks);
+
+	if (target.is_initialized()) {
+		builder
+			.add<game_map_object>(target.get())
+			.add<int8_t>(-1) // Hit action
+			.unk<uint8_t>()
+			.unk<int8_t>()
+			.unk<uint8_t>()
+			.add<point>(pos) // Mob position
+			.add<point>(pos) // Damage position
+			.add<uint16_t>(0) // Delay
+			.add<game_damage>(damage)
+			.unk<game_checksum>();
+	}
+
+	builder.add<point>(pos);
+	return builder;
+}
+
+PACKET_IMPL(loot_drop, game_tick_count ticks, const point &pos, game_map_object drop_id) {
+	packet_builder builder;
+	builder
+		.add<packet_header>(CMSG_ITEM_LOOT)
+		.unk<uint8_t>()
+		.add<game_tick_count>(ticks)
+		.add<point>(pos)
+		.add<game_map_object>(drop_id);
+	return builder;
+}
+
+PACKET_IMPL(chat, const string &message) {
+	packet_builder builder;
+	builder
+		.add<packet_header>(CMSG_PLAYER_CHAT)
+		.add<string>(message)
+		.add<bool>(false);
+	return builder;
+}
+
+}
+}
+}
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/packet_builder.hpp"
+#include "common/point.hpp"
+#include "common/types.hpp"
+#include "common/util/optional.hpp"
+#include <string>
+
+namespace vana {
+	namespace load_tester {
+		namespace packets {
+			namespace channel {
+				PACKET(player_load, game_player_id player_id);
+				// The sequence rides in the element's elapsed time, the server echoes that to everyone nearby untouched
+				PACKET(move, game_portal_count portal_count, const point &from, const point &to, int16_t sequence);
+				PACKET(melee_attack, game_portal_count portal_count, game_tick_count ticks, const point &pos, optional<game_map_object> target, game_damage damage);
+				PACKET(loot_drop, game_tick_count ticks, const point &pos, game_map_object drop_id);
+				PACKET(chat, const string &message);
+			}
+		}
+	}
+}
\ No newline at end of file
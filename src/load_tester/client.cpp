@@ -0,0 +1,522 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "client.hpp"
+#include "common/common_header.hpp"
+#include "common/common_packet.hpp"
+#include "common/encrypted_packet_transformer.hpp"
+#include "common/maple_version.hpp"
+#include "common/packet_builder.hpp"
+#include "common/packet_reader.hpp"
+#include "common/timer/timer.hpp"
+#include "common/util/time.hpp"
+#include "load_tester/channel_handler.hpp"
+#include "load_tester/channel_packet.hpp"
+#include "load_tester/load_config.hpp"
+#include "load_tester/load_tester.hpp"
+#include "load_tester/login_handler.hpp"
+#include "load_tester/login_packet.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+
+namespace vana {
+namespace load_tester {
+
+// Generous enough for a loaded server, a client that takes longer than this to get in game is counted as a failure
+const seconds login_timeout = seconds{30};
+// The world tells the channel about a migrating player asynchronously, so the first attempt can beat it there
+const milliseconds channel_retry_delay = milliseconds{500};
+// Loot requests further away than 300 from the server's idea of our position are ignored
+const int32_t loot_range = 250;
+
+client::client(load_tester &tester, asio::io_service &service, int32_t index, const load_profile &profile, uint32_t seed) :
+	m_tester{tester},
+	m_profile{profile},
+	m_index{index},
+	m_random{seed},
+	m_buffer(max_buffer_len),
+	m_strand{service},
+	m_socket{service}
+{
+}
+
+auto client::start() -> void {
+	ref_ptr<client> self = shared_from_this();
+	m_strand.post([self] {
+		view_ptr<client> weak = self;
+		self->set_timer_dispatcher([weak](function<void()> work) {
+			if (auto current = weak.lock()) {
+				current->m_strand.post(work);
+			}
+		});
+
+		self->m_started = vana::util::time::get_now();
+		self->m_deadline = self->m_started + login_timeout;
+		timer::timer::create(
+			[self](const time_point &now) { self->tick(now); },
+			timer::id{timer::type::load_test_timer, self->m_index},
+			self->get_timers(),
+			self->m_tester.get_settings().tick,
+			self->m_tester.get_settings().tick);
+
+		const auto &settings = self->m_tester.get_settings();
+		self->connect(settings.login_ip, settings.login_port);
+	});
+}
+
+auto client::stop() -> void {
+	ref_ptr<client> self = shared_from_this();
+	m_strand.post([self] {
+		self->m_stage = stage::done;
+		self->clear_timers();
+		self->close_socket();
+	});
+}
+
+auto client::get_tester() -> load_tester & {
+	return m_tester;
+}
+
+auto client::fail(const string &reason) -> void {
+	if (m_stage == stage::done) {
+		return;
+	}
+
+	m_stage = stage::done;
+	m_tester.record_failure(reason);
+	clear_timers();
+	close_socket();
+}
+
+auto client::connect(const ip &address, connection_port port) -> void {
+	close_socket();
+
+	uint32_t generation = ++m_generation;
+	asio::ip::tcp::endpoint endpoint{asio::ip::address_v4{address.as_ipv4()}, port};
+	m_socket.async_connect(endpoint,
+		m_strand.wrap(std::bind(&client::handle_connect, shared_from_this(),
+			generation,
+			std::placeholders::_1)));
+}
+
+auto client::close_socket() -> void {
+	// Handlers still pending for the old connection see a stale generation and bail
+	m_generation++;
+	m_connected = false;
+	m_writing = false;
+	m_send_queue.clear();
+	m_codec.reset();
+
+	asio::error_code ec;
+	m_socket.close(ec);
+}
+
+auto client::handle_connect(uint32_t generation, const asio::error_code &error) -> void {
+	if (generation != m_generation) {
+		return;
+	}
+	if (error) {
+		handle_error(generation, error);
+		return;
+	}
+
+	asio::error_code ec;
+	m_socket.set_option(asio::ip::tcp::no_delay{true}, ec);
+
+	// The connect packet is the only one that's not encrypted, it starts with its own length
+	asio::async_read(m_socket,
+		asio::buffer(m_buffer.data(), sizeof(packet_header)),
+		m_strand.wrap(std::bind(&client::handle_read_handshake_header, shared_from_this(),
+			generation,
+			std::placeholders::_1,
+			std::placeholders::_2)));
+}
+
+auto client::handle_read_handshake_header(uint32_t generation, const asio::error_code &error, size_t bytes_transferred) -> void {
+	if (generation != m_generation) {
+		return;
+	}
+	if (error) {
+		handle_error(generation, error);
+		return;
+	}
+
+	packet_reader reader{m_buffer.data(), bytes_transferred};
+	packet_header len = reader.get<packet_header>();
+	if (len < sizeof(game_version)) {
+		fail("malformed handshake");
+		return;
+	}
+
+	asio::async_read(m_socket,
+		asio::buffer(m_buffer.data(), len),
+		m_strand.wrap(std::bind(&client::handle_read_handshake, shared_from_this(),
+			generation,
+			std::placeholders::_1,
+			std::placeholders::_2)));
+}
+
+auto client::handle_read_handshake(uint32_t generation, const asio::error_code &error, size_t bytes_transferred) -> void {
+	if (generation != m_generation) {
+		return;
+	}
+	if (error) {
+		handle_error(generation, error);
+		return;
+	}
+
+	try {
+		packet_reader reader{m_buffer.data(), bytes_transferred};
+		game_version version = reader.get<game_version>();
+		reader.skip<string>(); // Subversion
+		crypto_iv send_iv = reader.get<crypto_iv>();
+		crypto_iv recv_iv = reader.get<crypto_iv>();
+		game_locale locale = reader.get<game_locale>();
+
+		if (version != maple_version::version || locale != maple_version::locale) {
+			fail("version mismatch");
+			return;
+		}
+
+		m_codec = make_ref_ptr<encrypted_packet_transformer>(recv_iv, send_iv);
+	}
+	catch (packet_content_exception) {
+		fail("malformed handshake");
+		return;
+	}
+
+	m_connected = true;
+	start_read_header();
+	on_connected();
+}
+
+auto client::start_read_header() -> void {
+	asio::async_read(m_socket,
+		asio::buffer(m_buffer.data(), header_len),
+		m_strand.wrap(std::bind(&client::handle_read_header, shared_from_this(),
+			m_generation,
+			std::placeholders::_1,
+			std::placeholders::_2)));
+}
+
+auto client::handle_read_header(uint32_t generation, const asio::error_code &error, size_t bytes_transferred) -> void {
+	if (generation != m_generation) {
+		return;
+	}
+	if (error) {
+		handle_error(generation, error);
+		return;
+	}
+
+	size_t len = m_codec->get_packet_length(m_buffer.data());
+	if (len < sizeof(packet_header)) {
+		fail("malformed packet");
+		return;
+	}
+
+	asio::async_read(m_socket,
+		asio::buffer(m_buffer.data(), len),
+		m_strand.wrap(std::bind(&client::handle_read_body, shared_from_this(),
+			generation,
+			std::placeholders::_1,
+			std::placeholders::_2)));
+}
+
+auto client::handle_read_body(uint32_t generation, const asio::error_code &error, size_t bytes_transferred) -> void {
+	if (generation != m_generation) {
+		return;
+	}
+	if (error) {
+		handle_error(generation, error);
+		return;
+	}
+
+	m_codec->decrypt_packet(m_buffer.data(), static_cast<int32_t>(bytes_transferred), header_len);
+
+	try {
+		packet_reader reader{m_buffer.data(), bytes_transferred};
+		if (reader.peek<packet_header>() == SMSG_PING) {
+			send(vana::packets::pong());
+		}
+		else if (m_stage == stage::login) {
+			login_handler::handle(*this, reader);
+		}
+		else {
+			channel_handler::handle(*this, reader);
+		}
+	}
+	catch (packet_content_exception) {
+		fail("malformed packet");
+		return;
+	}
+
+	// Whatever was handled may have moved us on to another connection
+	if (generation == m_generation) {
+		start_read_header();
+	}
+}
+
+auto client::send(const packet_builder &builder) -> void {
+	if (!m_connected) {
+		return;
+	}
+
+	// Packets are encrypted in the order they're queued so the IV sequence matches what goes out on the wire
+	size_t len = builder.get_size();
+	vector<unsigned char> packet(header_len + len);
+	m_codec->set_packet_header(packet.data(), static_cast<uint16_t>(len));
+	memcpy(packet.data() + header_len, builder.get_buffer(), len);
+	m_codec->encrypt_packet(packet.data() + header_len, static_cast<int32_t>(len), header_len);
+	m_send_queue.push_back(std::move(packet));
+
+	if (!m_writing) {
+		start_write();
+	}
+}
+
+auto client::start_write() -> void {
+	m_writing = true;
+	asio::async_write(m_socket,
+		asio::buffer(m_send_queue.front()),
+		m_strand.wrap(std::bind(&client::handle_write, shared_from_this(),
+			m_generation,
+			std::placeholders::_1,
+			std::placeholders::_2)));
+}
+
+auto client::handle_write(uint32_t generation, const asio::error_code &error, size_t bytes_transferred) -> void {
+	if (generation != m_generation) {
+		return;
+	}
+	if (error) {
+		handle_error(generation, error);
+		return;
+	}
+
+	m_send_queue.pop_front();
+	if (m_send_queue.empty()) {
+		m_writing = false;
+	}
+	else {
+		start_write();
+	}
+}
+
+auto client::handle_error(uint32_t generation, const asio::error_code &error) -> void {
+	if (error == asio::error::operation_aborted) {
+		return;
+	}
+
+	close_socket();
+	on_disconnected();
+}
+
+auto client::on_connected() -> void {
+	switch (m_stage) {
+		case stage::login: {
+			const auto &settings = m_tester.get_settings();
+			send(packets::login::authenticate(settings.account_prefix + std::to_string(settings.first_account + m_index), settings.password));
+			break;
+		}
+		case stage::channel:
+			send(packets::channel::player_load(m_player_id));
+			break;
+		default:
+			break;
+	}
+}
+
+auto client::on_disconnected() -> void {
+	switch (m_stage) {
+		case stage::login:
+			fail("login disconnected");
+			break;
+		case stage::channel: {
+			if (++m_channel_attempts >= max_channel_attempts) {
+				fail("channel refused player");
+				break;
+			}
+
+			ref_ptr<client> self = shared_from_this();
+			timer::timer::create(
+				[self](const time_point &now) {
+					if (self->m_stage == stage::channel) {
+						self->connect(self->m_channel_ip, self->m_channel_port);
+					}
+				},
+				timer::id{timer::type::load_test_timer, m_index, m_channel_attempts},
+				get_timers(),
+				channel_retry_delay);
+			break;
+		}
+		case stage::in_game:
+			fail("channel disconnected");
+			break;
+		default:
+			break;
+	}
+}
+
+auto client::on_authenticated() -> void {
+	const auto &settings = m_tester.get_settings();
+	send(packets::login::player_list(settings.world, settings.channel));
+}
+
+auto client::on_player_list(optional<game_player_id> player_id) -> void {
+	if (!player_id.is_initialized()) {
+		fail("account has no characters");
+		return;
+	}
+
+	m_player_id = player_id.get();
+	send(packets::login::channel_connect(m_player_id));
+}
+
+auto client::on_channel_address(const ip &address, connection_port port) -> void {
+	m_stage = stage::channel;
+	m_channel_ip = address;
+	m_channel_port = port;
+	connect(address, port);
+}
+
+auto client::on_map_changed(game_portal_count portal_count) -> void {
+	m_portal_count = portal_count;
+	m_mobs.clear();
+	m_drops.clear();
+
+	if (m_stage != stage::channel) {
+		return;
+	}
+
+	time_point now = vana::util::time::get_now();
+	m_stage = stage::in_game;
+	m_tester.record_in_game(duration_cast<microseconds>(now - m_started));
+
+	// Spread the first actions out so clients that got in at the same time don't act in lockstep
+	m_next_move = now + jitter(m_profile.move_interval);
+	m_next_attack = now + jitter(m_profile.attack_interval);
+	m_next_chat = now + jitter(m_profile.chat_interval);
+}
+
+auto client::on_mob_shown(game_map_object mob_id) -> void {
+	if (std::find(std::begin(m_mobs), std::end(m_mobs), mob_id) == std::end(m_mobs)) {
+		m_mobs.push_back(mob_id);
+	}
+}
+
+auto client::on_mob_removed(game_map_object mob_id) -> void {
+	auto iter = std::find(std::begin(m_mobs), std::end(m_mobs), mob_id);
+	if (iter != std::end(m_mobs)) {
+		m_mobs.erase(iter);
+	}
+}
+
+auto client::on_drop_shown(game_map_object drop_id, const point &pos) -> void {
+	m_drops[drop_id] = pos;
+}
+
+auto client::on_drop_removed(game_map_object drop_id) -> void {
+	m_drops.erase(drop_id);
+}
+
+auto client::tick(const time_point &now) -> void {
+	if (m_stage == stage::done) {
+		return;
+	}
+
+	if (m_stage != stage::in_game) {
+		if (now > m_deadline) {
+			fail(m_stage == stage::login ? "login timed out" : "channel timed out");
+		}
+		return;
+	}
+
+	if (m_profile.move_interval.count() > 0 && now >= m_next_move) {
+		std::uniform_int_distribution<int32_t> offset{-m_profile.wander, m_profile.wander};
+		move(now, point{static_cast<game_coord>(offset(m_random)), 0});
+		m_next_move = now + jitter(m_profile.move_interval);
+	}
+
+	if (m_profile.attack_interval.count() > 0 && now >= m_next_attack) {
+		attack(now);
+		m_next_attack = now + jitter(m_profile.attack_interval);
+	}
+
+	if (m_profile.loot) {
+		loot(now);
+	}
+
+	if (m_profile.chat_interval.count() > 0 && now >= m_next_chat) {
+		chat();
+		m_next_chat = now + jitter(m_profile.chat_interval);
+	}
+}
+
+auto client::move(const time_point &now, const point &to) -> void {
+	// Recorded first, another client's strand may see the echo before send even returns
+	m_move_sequence = static_cast<int16_t>((m_move_sequence + 1) & 0x7FFF);
+	m_tester.record_move(m_player_id, m_move_sequence);
+	send(packets::channel::move(m_portal_count, m_pos, to, m_move_sequence));
+	m_pos = to;
+}
+
+auto client::attack(const time_point &now) -> void {
+	optional<game_map_object> target;
+	if (!m_mobs.empty()) {
+		std::uniform_int_distribution<size_t> pick{0, m_mobs.size() - 1};
+		target = m_mobs[pick(m_random)];
+	}
+
+	m_tester.record_attack(m_player_id);
+	send(packets::channel::melee_attack(m_portal_count, get_ticks(now), m_pos, target, m_profile.damage));
+}
+
+auto client::loot(const time_point &now) -> void {
+	if (m_drops.empty()) {
+		return;
+	}
+
+	// One drop per tick, whether or not we get it the server tells everyone it's gone
+	auto drop = *std::begin(m_drops);
+	m_drops.erase(std::begin(m_drops));
+
+	if (std::abs(drop.second.x - m_pos.x) > loot_range || std::abs(drop.second.y - m_pos.y) > loot_range) {
+		move(now, drop.second);
+	}
+
+	send(packets::channel::loot_drop(get_ticks(now), m_pos, drop.first));
+}
+
+auto client::chat() -> void {
+	std::uniform_int_distribution<size_t> pick{0, m_profile.chat.size() - 1};
+	send(packets::channel::chat(m_profile.chat[pick(m_random)]));
+}
+
+auto client::get_ticks(const time_point &now) const -> game_tick_count {
+	return static_cast<game_tick_count>(duration_cast<milliseconds>(now - m_started).count());
+}
+
+auto client::jitter(milliseconds interval) -> milliseconds {
+	// Anywhere from half to one and a half times the interval
+	std::uniform_int_distribution<int64_t> spread{interval.count() / 2, interval.count() + interval.count() / 2};
+	return milliseconds{spread(m_random)};
+}
+
+}
+}
\ No newline at end of file
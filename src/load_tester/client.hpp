@@ -0,0 +1,127 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/ip.hpp"
+#include "common/packet_transformer.hpp"
+#include "common/point.hpp"
+#include "common/timer/container_holder.hpp"
+#include "common/types.hpp"
+#include "common/util/optional.hpp"
+#include <asio.hpp>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace vana {
+	class packet_builder;
+	class packet_reader;
+
+	namespace load_tester {
+		class load_tester;
+		struct load_profile;
+
+		// One simulated player, goes from the login server to the channel and then behaves according to its profile
+		// Everything a client does happens on its strand, including its timers
+		class client : public enable_shared<client>, public timer::container_holder {
+			NONCOPYABLE(client);
+			NO_DEFAULT_CONSTRUCTOR(client);
+		public:
+			client(load_tester &tester, asio::io_service &service, int32_t index, const load_profile &profile, uint32_t seed);
+
+			auto start() -> void;
+			auto stop() -> void;
+			auto send(const packet_builder &builder) -> void;
+			auto fail(const string &reason) -> void;
+			auto get_tester() -> load_tester &;
+
+			// Login server
+			auto on_authenticated() -> void;
+			auto on_player_list(optional<game_player_id> player_id) -> void;
+			auto on_channel_address(const ip &address, connection_port port) -> void;
+
+			// Channel server
+			auto on_map_changed(game_portal_count portal_count) -> void;
+			auto on_mob_shown(game_map_object mob_id) -> void;
+			auto on_mob_removed(game_map_object mob_id) -> void;
+			auto on_drop_shown(game_map_object drop_id, const point &pos) -> void;
+			auto on_drop_removed(game_map_object drop_id) -> void;
+		private:
+			enum class stage {
+				login,
+				channel,
+				in_game,
+				done,
+			};
+
+			static const size_t header_len = 4;
+			static const size_t max_buffer_len = 65535;
+			static const int32_t max_channel_attempts = 5;
+
+			auto connect(const ip &address, connection_port port) -> void;
+			auto close_socket() -> void;
+			auto handle_connect(uint32_t generation, const asio::error_code &error) -> void;
+			auto handle_read_handshake_header(uint32_t generation, const asio::error_code &error, size_t bytes_transferred) -> void;
+			auto handle_read_handshake(uint32_t generation, const asio::error_code &error, size_t bytes_transferred) -> void;
+			auto start_read_header() -> void;
+			auto handle_read_header(uint32_t generation, const asio::error_code &error, size_t bytes_transferred) -> void;
+			auto handle_read_body(uint32_t generation, const asio::error_code &error, size_t bytes_transferred) -> void;
+			auto start_write() -> void;
+			auto handle_write(uint32_t generation, const asio::error_code &error, size_t bytes_transferred) -> void;
+			auto handle_error(uint32_t generation, const asio::error_code &error) -> void;
+			auto on_connected() -> void;
+			auto on_disconnected() -> void;
+			auto tick(const time_point &now) -> void;
+			auto move(const time_point &now, const point &to) -> void;
+			auto attack(const time_point &now) -> void;
+			auto loot(const time_point &now) -> void;
+			auto chat() -> void;
+			auto get_ticks(const time_point &now) const -> game_tick_count;
+			auto jitter(milliseconds interval) -> milliseconds;
+
+			load_tester &m_tester;
+			const load_profile &m_profile;
+			int32_t m_index = 0;
+			stage m_stage = stage::login;
+			uint32_t m_generation = 0;
+			int32_t m_channel_attempts = 0;
+			bool m_connected = false;
+			bool m_writing = false;
+			game_player_id m_player_id = 0;
+			game_portal_count m_portal_count = 0;
+			int16_t m_move_sequence = 0;
+			ip m_channel_ip{0};
+			connection_port m_channel_port = 0;
+			point m_pos;
+			time_point m_started;
+			time_point m_deadline;
+			time_point m_next_move;
+			time_point m_next_attack;
+			time_point m_next_chat;
+			std::mt19937 m_random;
+			vector<game_map_object> m_mobs;
+			ord_map<game_map_object, point> m_drops;
+			queue<vector<unsigned char>> m_send_queue;
+			ref_ptr<packet_transformer> m_codec;
+			vector<unsigned char> m_buffer;
+			asio::io_service::strand m_strand;
+			asio::ip::tcp::socket m_socket;
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/ip.hpp"
+#include "common/lua/config_file.hpp"
+#include "common/types.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace vana {
+	namespace load_tester {
+		// How a simulated client behaves once it's in the game, an interval of 0 turns that action off
+		struct load_profile {
+			string name;
+			int32_t weight = 1;
+			milliseconds move_interval = milliseconds{0};
+			game_coord wander = 200;
+			milliseconds attack_interval = milliseconds{0};
+			game_damage damage = 1;
+			bool loot = false;
+			milliseconds chat_interval = milliseconds{0};
+			vector<string> chat;
+		};
+
+		struct load_test {
+			load_test() :
+				login_ip{0}
+			{
+			}
+
+			ip login_ip;
+			connection_port login_port = 8484;
+			game_world_id world = 0;
+			game_channel_id channel = 0;
+			int32_t clients = 100;
+			int32_t ramp_up = 20;
+			seconds duration = seconds{300};
+			seconds report_interval = seconds{10};
+			milliseconds tick = milliseconds{100};
+			uint16_t threads = 4;
+			string account_prefix;
+			int32_t first_account = 1;
+			string password;
+			vector<load_profile> profiles;
+		};
+	}
+
+	template <>
+	struct lua::lua_variant_into<load_tester::load_profile> {
+		auto transform(lua_environment &config, const lua_variant &obj, const string &prefix) -> load_tester::load_profile {
+			config.validate_object(lua_type::table, obj, prefix);
+
+			load_tester::load_profile ret;
+
+			auto values = obj.as<hash_map<lua_variant, lua_variant>>();
+			bool has_name = false;
+			for (const auto &value : values) {
+				config.validate_key(lua_type::string, value.first, prefix);
+
+				string key = value.first.as<string>();
+				if (key == "name") {
+					has_name = true;
+					config.validate_value(lua_type::string, value.second, key, prefix);
+					ret.name = value.second.as<string>();
+				}
+				else if (key == "weight") {
+					if (config.validate_value(lua_type::number, value.second, key, prefix, true) == lua_type::nil) continue;
+					ret.weight = std::max(value.second.as<int32_t>(), 0);
+				}
+				else if (key == "move_interval") {
+					if (config.validate_value(lua_type::number, value.second, key, prefix, true) == lua_type::nil) continue;
+					ret.move_interval = value.second.as<milliseconds>();
+				}
+				else if (key == "wander") {
+					if (config.validate_value(lua_type::number, value.second, key, prefix, true) == lua_type::nil) continue;
+					ret.wander = value.second.as<game_coord>();
+				}
+				else if (key == "attack_interval") {
+					if (config.validate_value(lua_type::number, value.second, key, prefix, true) == lua_type::nil) continue;
+					ret.attack_interval = value.second.as<milliseconds>();
+				}
+				else if (key == "damage") {
+					if (config.validate_value(lua_type::number, value.second, key, prefix, true) == lua_type::nil) continue;
+					ret.damage = value.second.as<game_damage>();
+				}
+				else if (key == "loot") {
+					if (config.validate_value(lua_type::boolean, value.second, key, prefix, true) == lua_type::nil) continue;
+					ret.loot = value.second.as<bool>();
+				}
+				else if (key == "chat_interval") {
+					if (config.validate_value(lua_type::number, value.second, key, prefix, true) == lua_type::nil) continue;
+					ret.chat_interval = value.second.as<milliseconds>();
+				}
+				else if (key == "chat") {
+					if (config.validate_value(lua_type::table, value.second, key, prefix, true) == lua_type::nil) continue;
+					ret.chat = value.second.as<vector<string>>();
+				}
+			}
+
+			config.required(has_name, "name", prefix);
+			if (ret.chat.empty()) {
+				ret.chat_interval = milliseconds{0};
+			}
+
+			return ret;
+		}
+	};
+
+	template <>
+	struct lua::lua_serialize<load_tester::load_test> {
+		auto read(lua_environment &config, const string &prefix) -> load_tester::load_test {
+			load_tester::load_test ret;
+			ret.login_ip = ip{ip::string_to_ipv4(config.get<string>("login_ip"))};
+			ret.login_port = config.get<connection_port>("login_port", ret.login_port);
+			ret.world = config.get<game_world_id>("world", ret.world);
+			ret.channel = config.get<game_channel_id>("channel", ret.channel);
+			ret.clients = std::max(config.get<int32_t>("clients", ret.clients), 1);
+			ret.ramp_up = std::max(config.get<int32_t>("ramp_up", ret.ramp_up), 1);
+			ret.duration = seconds{config.get<int32_t>("duration", static_cast<int32_t>(ret.duration.count()))};
+			ret.report_interval = seconds{std::max(config.get<int32_t>("report_interval", static_cast<int32_t>(ret.report_interval.count())), 1)};
+			ret.tick = milliseconds{std::max(config.get<int32_t>("tick", static_cast<int32_t>(ret.tick.count())), 10)};
+			ret.threads = std::max<uint16_t>(config.get<uint16_t>("threads", ret.threads), 1);
+			ret.account_prefix = config.get<string>("account_prefix");
+			ret.first_account = config.get<int32_t>("first_account", ret.first_account);
+			ret.password = config.get<string>("password");
+
+			lua_variant profiles = config.get<lua_variant>("profiles");
+			if (!profiles.is(lua_type::table)) {
+				config.error("profiles must be a table");
+			}
+
+			auto map = profiles.as<ord_map<int32_t, lua_variant>>();
+			for (const auto &profile : map) {
+				ret.profiles.push_back(profile.second.into<load_tester::load_profile>(config, "profiles." + std::to_string(profile.first)));
+			}
+
+			if (ret.profiles.empty()) {
+				config.error("profiles needs at least one profile");
+			}
+
+			return ret;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,283 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "load_tester.hpp"
+#include "common/timer/timer.hpp"
+#include "common/util/time.hpp"
+#include "load_tester/client.hpp"
+#include <algorithm>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+
+namespace vana {
+namespace load_tester {
+
+namespace timers {
+	enum : int32_t {
+		ramp_up,
+		report,
+		finish,
+	};
+}
+
+// Fast ramps spawn clients in batches rather than firing the timer more often than this
+const milliseconds min_ramp_up_interval = milliseconds{50};
+
+load_tester::load_tester() :
+	m_random{std::random_device{}()},
+	m_signals{m_service, SIGINT}
+{
+	m_signals.async_wait([this](const asio::error_code &ec, int handler_id) {
+		if (!ec) {
+			stop();
+		}
+	});
+}
+
+auto load_tester::run(const load_test &settings) -> void {
+	m_settings = settings;
+	m_started = vana::util::time::get_now();
+	m_work = make_owned_ptr<asio::io_service::work>(m_service);
+
+	milliseconds interval = std::max(milliseconds{1000 / m_settings.ramp_up}, min_ramp_up_interval);
+	int32_t per_batch = std::max(static_cast<int32_t>(m_settings.ramp_up * interval.count() / 1000), 1);
+	timer::timer::create(
+		[this, per_batch](const time_point &now) { spawn(per_batch); },
+		timer::id{timer::type::load_test_timer, timers::ramp_up},
+		get_timers(),
+		seconds{0},
+		interval);
+
+	timer::timer::create(
+		[this](const time_point &now) { report(false); },
+		timer::id{timer::type::load_test_timer, timers::report},
+		get_timers(),
+		m_settings.report_interval,
+		m_settings.report_interval);
+
+	if (m_settings.duration.count() > 0) {
+		timer::timer::create(
+			[this](const time_point &now) { stop(); },
+			timer::id{timer::type::load_test_timer, timers::finish},
+			get_timers(),
+			m_settings.duration);
+	}
+
+	std::cout << "Load testing " << m_settings.login_ip << ":" << m_settings.login_port
+		<< " with " << m_settings.clients << " clients on " << m_settings.threads << " threads" << std::endl;
+
+	// Every thread services the same io_service, each client has its own strand
+	vector<std::thread> threads;
+	for (uint16_t i = 1; i < m_settings.threads; i++) {
+		threads.emplace_back([this] { m_service.run(); });
+	}
+	m_service.run();
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	report(true);
+}
+
+auto load_tester::stop() -> void {
+	if (m_stopping.exchange(true)) {
+		return;
+	}
+
+	clear_timers();
+
+	asio::error_code ec;
+	m_signals.cancel(ec);
+
+	vector<ref_ptr<client>> clients;
+	{
+		owned_lock<mutex> l{m_clients_mutex};
+		clients.swap(m_clients);
+	}
+
+	for (auto &current : clients) {
+		current->stop();
+	}
+
+	// The io_service runs out of work once the clients are done with their sockets
+	m_work.reset();
+}
+
+auto load_tester::get_io_service() -> asio::io_service & {
+	return m_service;
+}
+
+auto load_tester::get_settings() const -> const load_test & {
+	return m_settings;
+}
+
+auto load_tester::spawn(int32_t count) -> void {
+	owned_lock<mutex> l{m_clients_mutex};
+	if (m_stopping) {
+		// Checked under the lock, stop won't see clients spawned after it took them
+		return;
+	}
+
+	for (int32_t i = 0; i < count && m_spawned < m_settings.clients; i++) {
+		auto current = make_ref_ptr<client>(*this, m_service, m_spawned, pick_profile(), m_random());
+		m_clients.push_back(current);
+		current->start();
+		m_spawned++;
+	}
+
+	if (m_spawned == m_settings.clients) {
+		get_timers()->remove_timer(timer::id{timer::type::load_test_timer, timers::ramp_up});
+	}
+}
+
+auto load_tester::pick_profile() -> const load_profile & {
+	int32_t total = 0;
+	for (const auto &profile : m_settings.profiles) {
+		total += profile.weight;
+	}
+
+	if (total > 0) {
+		int32_t roll = std::uniform_int_distribution<int32_t>{0, total - 1}(m_random);
+		for (const auto &profile : m_settings.profiles) {
+			if (roll < profile.weight) {
+				return profile;
+			}
+			roll -= profile.weight;
+		}
+	}
+
+	return m_settings.profiles.front();
+}
+
+auto load_tester::record_in_game(microseconds login_time) -> void {
+	owned_lock<mutex> l{m_stats_mutex};
+	m_in_game++;
+	m_window.login.record(login_time.count());
+}
+
+auto load_tester::record_failure(const string &reason) -> void {
+	owned_lock<mutex> l{m_stats_mutex};
+	m_failures[reason]++;
+}
+
+auto load_tester::record_move(game_player_id player_id, int16_t sequence) -> void {
+	time_point now = vana::util::time::get_now();
+	owned_lock<mutex> l{m_stats_mutex};
+	m_pending_moves[get_move_key(player_id, sequence)] = now;
+}
+
+auto load_tester::record_move_seen(game_player_id player_id, int16_t sequence) -> void {
+	time_point now = vana::util::time::get_now();
+	owned_lock<mutex> l{m_stats_mutex};
+	auto kvp = m_pending_moves.find(get_move_key(player_id, sequence));
+	if (kvp == std::end(m_pending_moves)) {
+		// Somebody else saw it first
+		return;
+	}
+
+	m_window.move.record(duration_cast<microseconds>(now - kvp->second).count());
+	m_pending_moves.erase(kvp);
+}
+
+auto load_tester::record_attack(game_player_id player_id) -> void {
+	time_point now = vana::util::time::get_now();
+	owned_lock<mutex> l{m_stats_mutex};
+	m_pending_attacks[player_id] = now;
+}
+
+auto load_tester::record_attack_seen(game_player_id player_id) -> void {
+	// The broadcast carries nothing that identifies the attack, so it's matched with the attacker's latest one
+	// Attack intervals are far longer than the latencies being measured, so the two can't be confused
+	time_point now = vana::util::time::get_now();
+	owned_lock<mutex> l{m_stats_mutex};
+	auto kvp = m_pending_attacks.find(player_id);
+	if (kvp == std::end(m_pending_attacks)) {
+		return;
+	}
+
+	m_window.attack.record(duration_cast<microseconds>(now - kvp->second).count());
+	m_pending_attacks.erase(kvp);
+}
+
+auto load_tester::get_move_key(game_player_id player_id, int16_t sequence) -> int64_t {
+	return (static_cast<int64_t>(player_id) << 16) | static_cast<uint16_t>(sequence);
+}
+
+auto load_tester::latencies::merge(const latencies &other) -> void {
+	login.merge(other.login);
+	move.merge(other.move);
+	attack.merge(other.attack);
+}
+
+auto load_tester::report(bool final_report) -> void {
+	time_point now = vana::util::time::get_now();
+	owned_lock<mutex> l{m_stats_mutex};
+
+	// Echoes nobody saw (e.g. the client was alone on its map or out of everyone's area of interest) are dropped once they're a report window old
+	// Moves are recorded many times a second per client, so keeping them any longer grows the table for the whole run
+	seconds pending_echo_expiry = m_settings.report_interval;
+	for (auto iter = std::begin(m_pending_moves); iter != std::end(m_pending_moves); ) {
+		iter = now - iter->second > pending_echo_expiry ?
+			m_pending_moves.erase(iter) :
+			std::next(iter);
+	}
+	for (auto iter = std::begin(m_pending_attacks); iter != std::end(m_pending_attacks); ) {
+		iter = now - iter->second > pending_echo_expiry ?
+			m_pending_attacks.erase(iter) :
+			std::next(iter);
+	}
+
+	m_total.merge(m_window);
+	const latencies &shown = final_report ? m_total : m_window;
+
+	uint64_t failed = 0;
+	for (const auto &kvp : m_failures) {
+		failed += kvp.second;
+	}
+
+	std::cout << (final_report ? "Final" : "[" + std::to_string(vana::util::time::get_distance<seconds>(now, m_started)) + "s]")
+		<< " " << m_in_game << "/" << m_settings.clients << " got in game, " << failed << " failed" << std::endl;
+	write_latency("login", shown.login);
+	write_latency("move echo", shown.move);
+	write_latency("attack echo", shown.attack);
+
+	if (final_report) {
+		for (const auto &kvp : m_failures) {
+			std::cout << "\t" << kvp.first << ": " << kvp.second << std::endl;
+		}
+	}
+
+	m_window = latencies{};
+}
+
+auto load_tester::write_latency(const string &name, const vana::util::latency_histogram &histogram) -> void {
+	auto as_ms = [](uint64_t value) { return static_cast<double>(value) / 1000; };
+
+	std::cout << "\t" << std::left << std::setw(12) << name << std::right << " " << std::setw(8) << histogram.get_count();
+	if (histogram.get_count() > 0) {
+		std::cout << std::fixed << std::setprecision(1)
+			<< " p50 " << as_ms(histogram.get_percentile(50)) << " ms"
+			<< " p90 " << as_ms(histogram.get_percentile(90)) << " ms"
+			<< " p99 " << as_ms(histogram.get_percentile(99)) << " ms"
+			<< " max " << as_ms(histogram.get_max()) << " ms";
+	}
+	std::cout << std::endl;
+}
+
+}
+}
\ No newline at end of file
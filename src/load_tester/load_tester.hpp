@@ -0,0 +1,93 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/timer/container_holder.hpp"
+#include "common/types.hpp"
+#include "common/util/latency_histogram.hpp"
+#include "load_tester/load_config.hpp"
+#include <asio.hpp>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vana {
+	namespace load_tester {
+		class client;
+
+		// Ramps up the simulated clients, ends the run and keeps score
+		// Latencies are measured from the moment a client sends something until the first other client is told about it
+		class load_tester : public timer::container_holder {
+			NONCOPYABLE(load_tester);
+		public:
+			// Stops the run on SIGINT from construction on, config errors raise it too
+			load_tester();
+
+			// Blocks until the run is over or stop is called
+			auto run(const load_test &settings) -> void;
+			auto stop() -> void;
+			auto get_io_service() -> asio::io_service &;
+			auto get_settings() const -> const load_test &;
+
+			// Safe to call from any client
+			auto record_in_game(microseconds login_time) -> void;
+			auto record_failure(const string &reason) -> void;
+			auto record_move(game_player_id player_id, int16_t sequence) -> void;
+			auto record_move_seen(game_player_id player_id, int16_t sequence) -> void;
+			auto record_attack(game_player_id player_id) -> void;
+			auto record_attack_seen(game_player_id player_id) -> void;
+		private:
+			struct latencies {
+				vana::util::latency_histogram login;
+				vana::util::latency_histogram move;
+				vana::util::latency_histogram attack;
+
+				auto merge(const latencies &other) -> void;
+			};
+
+			auto spawn(int32_t count) -> void;
+			auto pick_profile() -> const load_profile &;
+			auto report(bool final_report) -> void;
+			auto write_latency(const string &name, const vana::util::latency_histogram &histogram) -> void;
+			static auto get_move_key(game_player_id player_id, int16_t sequence) -> int64_t;
+
+			load_test m_settings;
+			std::atomic<bool> m_stopping{false};
+			int32_t m_spawned = 0;
+			int32_t m_in_game = 0;
+			time_point m_started;
+			std::mt19937 m_random;
+			latencies m_window;
+			latencies m_total;
+			hash_map<int64_t, time_point> m_pending_moves;
+			hash_map<game_player_id, time_point> m_pending_attacks;
+			ord_map<string, uint64_t> m_failures;
+			mutex m_stats_mutex;
+			vector<ref_ptr<client>> m_clients;
+			mutex m_clients_mutex;
+			owned_ptr<asio::io_service::work> m_work;
+			asio::io_service m_service;
+			asio::signal_set m_signals;
+		};
+	}
+}
\ No newline at end of file
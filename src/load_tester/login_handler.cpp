@@ -0,0 +1,82 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "login_handler.hpp"
+#include "common/ip.hpp"
+#include "common/packet_reader.hpp"
+#include "load_tester/client.hpp"
+#include "login_server/player_status.hpp"
+#include "login_server/smsg_header.hpp"
+
+namespace vana {
+namespace load_tester {
+
+auto login_handler::handle(client &current, packet_reader &reader) -> void {
+	switch (reader.get<packet_header>()) {
+		case SMSG_AUTHENTICATION: handle_authentication(current, reader); break;
+		case SMSG_PLAYER_LIST: handle_player_list(current, reader); break;
+		case SMSG_CHANNEL_CONNECT: handle_channel_connect(current, reader); break;
+	}
+}
+
+auto login_handler::handle_authentication(client &current, packet_reader &reader) -> void {
+	int16_t error = reader.get<int16_t>();
+	if (error != 0) {
+		current.fail("login error " + std::to_string(error));
+		return;
+	}
+
+	reader.unk<int32_t>();
+	reader.skip<game_account_id>();
+
+	// The test accounts need to be ready to play, there's nobody to pick a gender or a PIN
+	switch (reader.get<int8_t>()) {
+		case login_server::player_status::set_gender: current.fail("account has no gender"); break;
+		case login_server::player_status::pin_select: current.fail("account has no PIN"); break;
+		default: current.on_authenticated(); break;
+	}
+}
+
+auto login_handler::handle_player_list(client &current, packet_reader &reader) -> void {
+	if (reader.get<int8_t>() == 8) {
+		current.fail("channel offline");
+		return;
+	}
+
+	// Characters are variable length, only the first one matters anyway
+	uint8_t count = reader.get<uint8_t>();
+	optional<game_player_id> player_id;
+	if (count > 0) {
+		player_id = reader.get<game_player_id>();
+	}
+	current.on_player_list(player_id);
+}
+
+auto login_handler::handle_channel_connect(client &current, packet_reader &reader) -> void {
+	reader.unk<int16_t>();
+	uint32_t address = ntohl(reader.get<uint32_t>());
+	connection_port port = reader.get<connection_port>();
+	if (address == 0) {
+		current.fail("channel unavailable");
+		return;
+	}
+
+	current.on_channel_address(ip{address}, port);
+}
+
+}
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "login_packet.hpp"
+#include "login_server/cmsg_header.hpp"
+
+namespace vana {
+namespace load_tester {
+namespace packets {
+namespace login {
+
+PACKET_IMPL(authenticate, const string &username, const string &password) {
+	packet_builder builder;
+	builder
+		.add<packet_header>(CMSG_AUTHENTICATION)
+		.add<string>(username)
+		.add<string>(password)
+		.unk(16) // Device ID
+		.unk<int32_t>() // GameRoom client ID
+		.unk<int8_t>() // Start mode
+		.unk<int8_t>()
+		.unk<int8_t>()
+		.unk<int32_t>(); // Partner code
+	return builder;
+}
+
+PACKET_IMPL(player_list, game_world_id world_id, game_channel_id channel_id) {
+	packet_builder builder;
+	builder
+		.add<packet_header>(CMSG_PLAYER_LIST)
+		.add<game_world_id>(world_id)
+		.add<int8_t>(static_cast<int8_t>(channel_id));
+	return builder;
+}
+
+PACKET_IMPL(channel_connect, game_player_id player_id) {
+	packet_builder builder;
+	builder
+		.add<packet_header>(CMSG_CHANNEL_CONNECT)
+		.add<game_player_id>(player_id);
+	return builder;
+}
+
+}
+}
+}
+}
\ No newline at end of file
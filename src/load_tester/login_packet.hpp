@@ -0,0 +1,34 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#pragma once
+
+#include "common/packet_builder.hpp"
+#include "common/types.hpp"
+#include <string>
+
+namespace vana {
+	namespace load_tester {
+		namespace packets {
+			namespace login {
+				PACKET(authenticate, const string &username, const string &password);
+				PACKET(player_list, game_world_id world_id, game_channel_id channel_id);
+				PACKET(channel_connect, game_player_id player_id);
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+/*
+Copyright (C) 2008-2016 Vana Development Team
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; version 2
+of the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+*/
+#include "common/exit_code.hpp"
+#include "common/lua/config_file.hpp"
+#include "common/vana_main.hpp"
+#include "load_tester/load_config.hpp"
+#include "load_tester/load_tester.hpp"
+#include <botan/botan.h>
+#include <exception>
+#include <iostream>
+
+auto main() -> vana::exit_code_underlying {
+	Botan::LibraryInitializer init{"thread_safe=true"};
+
+	try {
+		vana::load_tester::load_tester tester;
+
+		auto config = vana::lua::config_file::get_load_tester_config();
+		config->run();
+		tester.run(config->get<vana::load_tester::load_test>(""));
+	}
+	catch (vana::lua::config_exception &) {
+		// Code path intentionally blank
+		// Each vanilla config_exception has an associated message at the throw site
+	}
+	catch (std::exception &e) {
+		std::cerr << "PROGRAM ERROR: " << e.what() << std::endl;
+		vana::g_exit_code = vana::exit_code::program_exception;
+	}
+
+	return static_cast<vana::exit_code_underlying>(vana::g_exit_code);
+}
\ No newline at end of file
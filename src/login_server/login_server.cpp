@@ -22,6 +22,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include "common/connection_listener_config.hpp"
 #include "common/connection_manager.hpp"
 #include "common/data/initialize.hpp"
+#include "common/data/loader.hpp"
+#include "common/data/mcdb_snapshot.hpp"
 #include "common/maple_version.hpp"
 #include "common/server_type.hpp"
 #include "login_server/login_server_accept_packet.hpp"
@@ -53,7 +55,8 @@ auto login_server::listen() -> void {
 			connection_type::end_user,
 			maple_version::login_subversion,
 			m_port,
-			ip::type::ipv4
+			ip::type::ipv4,
+			config.client_send_queue_limit
 		},
 		[&] { return make_ref_ptr<user>(); }
 	);
@@ -88,9 +91,16 @@ auto login_server::load_data() -> result {
 	}
 	vana::data::initialize::set_users_offline(this, 1);
 
-	m_valid_char_data_provider.load_data();
-	m_equip_data_provider.load_data();
-	m_curse_data_provider.load_data();
+	// The LoginServer comes up before any channel, so it keeps the snapshot in step with MCDB for them
+	vana::data::mcdb::compile_snapshot(this);
+	vana::data::mcdb::load_snapshot(this);
+
+	vana::data::loader loader;
+	loader
+		.add("Char Info", [&] { m_valid_char_data_provider.load_data(); })
+		.add("Equips", [&] { m_equip_data_provider.load_data(); })
+		.add("Curse Info", [&] { m_curse_data_provider.load_data(); });
+	loader.run();
 
 	ranking_calculator::set_timer();
 	display_launch_time();
@@ -65,12 +65,14 @@ auto ranking_calculator::all() -> void {
 
 	std::cout << std::setw(vana::data::initialize::output_width) << std::left << "Calculating rankings... " << std::endl;
 	vana::util::stop_watch sw;
+	vana::util::stop_watch step;
 
 	auto &db = vana::io::database::get_char_db();
 	auto &sql = db.get_session();
 	rank_player out;
 	soci::statement statement = (sql.prepare
-		<< "SELECT c.character_id, c.exp, c.fame, c.job, c.level, c.world_id, c.time_level, c.fame_cpos, c.world_cpos, c.job_cpos, c.overall_cpos "
+		<< "SELECT c.character_id, c.exp, c.fame, c.job, c.level, c.world_id, c.time_level, "
+		<< "	c.fame_cpos, c.world_cpos, c.job_cpos, c.overall_cpos, c.fame_opos, c.world_opos, c.job_opos, c.overall_opos "
 		<< "FROM " << db.make_table(vana::table::characters) << " c "
 		<< "INNER JOIN " << db.make_table(vana::table::accounts) << " u ON u.account_id = c.account_id "
 		<< "WHERE "
@@ -83,8 +85,7 @@ auto ranking_calculator::all() -> void {
 		<< "			AND c.level > 9"
 		<< "		)"
 		<< "		OR c.job NOT IN (" << vana::util::str::delimit(",", constant::job::beginner_jobs) << ")"
-		<< "	) "
-		<< "ORDER BY c.overall_cpos DESC",
+		<< "	)",
 		soci::into(out.char_id),
 		soci::into(out.exp_stat),
 		soci::into(out.fame_stat),
@@ -95,75 +96,173 @@ auto ranking_calculator::all() -> void {
 		soci::into(out.fame.new_rank),
 		soci::into(out.world.new_rank),
 		soci::into(out.job.new_rank),
-		soci::into(out.overall.new_rank));
+		soci::into(out.overall.new_rank),
+		soci::into(out.fame.saved_old_rank),
+		soci::into(out.world.saved_old_rank),
+		soci::into(out.job.saved_old_rank),
+		soci::into(out.overall.saved_old_rank));
 
 	vector<rank_player> v;
 	statement.execute();
 
 	while (statement.fetch()) {
 		out.job_level_max = vana::util::game_logic::job::get_max_level(out.job_stat);
+		out.fame.saved_new_rank = out.fame.new_rank;
+		out.world.saved_new_rank = out.world.new_rank;
+		out.job.saved_new_rank = out.job.new_rank;
+		out.overall.saved_new_rank = out.overall.new_rank;
 		v.push_back(out);
 	}
 
-	if (v.size() > 0) {
-		overall(v);
-		world(v);
-		job(v);
-		fame(v);
+	auto load_time = step.elapsed<milliseconds>();
+	step.restart();
 
-		game_player_id char_id = 0;
-		opt_int32_t original_fame_rank = 0;
-		int32_t current_fame_rank = 0;
-		opt_int32_t original_world_rank = 0;
-		int32_t current_world_rank = 0;
-		opt_int32_t original_job_rank = 0;
-		int32_t current_job_rank = 0;
-		opt_int32_t original_overall_rank = 0;
-		int32_t current_overall_rank = 0;
-
-		soci::statement st = (sql.prepare
-			<< "UPDATE " << db.make_table(vana::table::characters) << " "
-			<< "SET "
-			<< "	fame_opos = :original_fame_rank,"
-			<< "	fame_cpos = :current_fame_rank,"
-			<< "	world_opos = :original_world_rank,"
-			<< "	world_cpos = :current_world_rank,"
-			<< "	job_opos = :original_job_rank,"
-			<< "	job_cpos = :current_job_rank,"
-			<< "	overall_opos = :original_overall_rank,"
-			<< "	overall_cpos = :current_overall_rank "
-			<< "	WHERE character_id = :char",
-			soci::use(char_id, "char"),
-			soci::use(original_fame_rank, "original_fame_rank"),
-			soci::use(current_fame_rank, "current_fame_rank"),
-			soci::use(original_world_rank, "original_world_rank"),
-			soci::use(current_world_rank, "current_world_rank"),
-			soci::use(original_job_rank, "original_job_rank"),
-			soci::use(current_job_rank, "current_job_rank"),
-			soci::use(original_overall_rank, "original_overall_rank"),
-			soci::use(current_overall_rank, "current_overall_rank"));
-
-		for (const auto &p : v) {
-			char_id = p.char_id;
-			original_fame_rank = p.fame.old_rank;
-			current_fame_rank = p.fame.new_rank.get();
-			original_world_rank = p.world.old_rank;
-			current_world_rank = p.world.new_rank.get();
-			original_job_rank = p.job.old_rank;
-			current_job_rank = p.job.new_rank.get();
-			original_overall_rank = p.overall.old_rank;
-			current_overall_rank = p.overall.new_rank.get();
-			st.execute(true);
+	size_t changed = 0;
+	if (v.size() > 0) {
+		// Sorting pointers keeps the swaps cheap and leaves both orders available at once
+		vector<rank_player *> by_level;
+		by_level.reserve(v.size());
+		for (auto &p : v) {
+			by_level.push_back(&p);
 		}
+		vector<rank_player *> by_fame = by_level;
+
+		// Fame ranks only touch the fame members, so they're worked out next to the rest
+		std::thread fame_thread{[&by_fame] { fame(by_fame); }};
+		level(by_level);
+		fame_thread.join();
+	}
+
+	auto rank_time = step.elapsed<milliseconds>();
+	step.restart();
+
+	if (v.size() > 0) {
+		changed = save(v);
 	}
 
+	auto save_time = step.elapsed<milliseconds>();
+
 	login_server::get_instance().log(vana::log::type::info, [&](out_stream &str) {
-		str << "Calculating rankings completed in " << std::setprecision(3) << sw.elapsed<milliseconds>() / 1000.f << " seconds!";
+		str << "Calculating rankings completed in " << std::setprecision(3) << sw.elapsed<milliseconds>() / 1000.f << " seconds! "
+			<< v.size() << " characters ranked, " << changed << " changed "
+			<< "(load " << load_time << " ms, rank " << rank_time << " ms, save " << save_time << " ms)";
 	});
 
 	l.unlock();
 }
 
+auto ranking_calculator::save(const vector<rank_player> &v) -> size_t {
+	using namespace soci;
+	auto &db = vana::io::database::get_char_db();
+	auto &sql = db.get_session();
+
+	// Each chunk of changed rows is a single multi-row INSERT into a temporary table, which is then applied with one UPDATE
+	const size_t rows_per_insert = 500;
+
+	struct rank_row {
+		game_player_id char_id = 0;
+		opt_int32_t original_fame_rank;
+		opt_int32_t current_fame_rank;
+		opt_int32_t original_world_rank;
+		opt_int32_t current_world_rank;
+		opt_int32_t original_job_rank;
+		opt_int32_t current_job_rank;
+		opt_int32_t original_overall_rank;
+		opt_int32_t current_overall_rank;
+	};
+
+	vector<rank_row> rows;
+	for (const auto &p : v) {
+		if (!is_changed(p.fame) && !is_changed(p.world) && !is_changed(p.job) && !is_changed(p.overall)) {
+			continue;
+		}
+
+		rank_row row;
+		row.char_id = p.char_id;
+		row.original_fame_rank = p.fame.old_rank;
+		row.current_fame_rank = p.fame.new_rank;
+		row.original_world_rank = p.world.old_rank;
+		row.current_world_rank = p.world.new_rank;
+		row.original_job_rank = p.job.old_rank;
+		row.current_job_rank = p.job.new_rank;
+		row.original_overall_rank = p.overall.old_rank;
+		row.current_overall_rank = p.overall.new_rank;
+		rows.push_back(row);
+	}
+
+	if (rows.empty()) {
+		return 0;
+	}
+
+	sql.once << "DROP TEMPORARY TABLE IF EXISTS ranking_updates";
+	sql.once
+		<< "CREATE TEMPORARY TABLE ranking_updates ("
+		<< "	character_id int(11) NOT NULL,"
+		<< "	fame_opos int(11) unsigned NULL,"
+		<< "	fame_cpos int(11) unsigned NULL,"
+		<< "	world_opos int(11) unsigned NULL,"
+		<< "	world_cpos int(11) unsigned NULL,"
+		<< "	job_opos int(11) unsigned NULL,"
+		<< "	job_cpos int(11) unsigned NULL,"
+		<< "	overall_opos int(11) unsigned NULL,"
+		<< "	overall_cpos int(11) unsigned NULL,"
+		<< "	PRIMARY KEY (character_id)"
+		<< ")";
+
+	for (size_t offset = 0; offset < rows.size(); offset += rows_per_insert) {
+		size_t count = std::min(rows_per_insert, rows.size() - offset);
+		out_stream query;
+		query << "INSERT INTO ranking_updates VALUES ";
+
+		statement st{sql};
+		for (size_t i = 0; i < count; ++i) {
+			rank_row &row = rows[offset + i];
+			string n = vana::util::str::lexical_cast<string>(i);
+			if (i != 0) {
+				query << ", ";
+			}
+			query << "(:char" << n << ", :ofame" << n << ", :cfame" << n << ", :oworld" << n << ", :cworld" << n << ", "
+				<< ":ojob" << n << ", :cjob" << n << ", :ooverall" << n << ", :coverall" << n << ")";
+
+			st.exchange(use(row.char_id, "char" + n));
+			st.exchange(use(row.original_fame_rank, "ofame" + n));
+			st.exchange(use(row.current_fame_rank, "cfame" + n));
+			st.exchange(use(row.original_world_rank, "oworld" + n));
+			st.exchange(use(row.current_world_rank, "cworld" + n));
+			st.exchange(use(row.original_job_rank, "ojob" + n));
+			st.exchange(use(row.current_job_rank, "cjob" + n));
+			st.exchange(use(row.original_overall_rank, "ooverall" + n));
+			st.exchange(use(row.current_overall_rank, "coverall" + n));
+		}
+
+		st.alloc();
+		st.prepare(query.str());
+		st.define_and_bind();
+		st.execute(true);
+	}
+
+	sql.once
+		<< "UPDATE " << db.make_table(vana::table::characters) << " c "
+		<< "INNER JOIN ranking_updates r ON r.character_id = c.character_id "
+		<< "SET "
+		<< "	c.fame_opos = r.fame_opos,"
+		<< "	c.fame_cpos = r.fame_cpos,"
+		<< "	c.world_opos = r.world_opos,"
+		<< "	c.world_cpos = r.world_cpos,"
+		<< "	c.job_opos = r.job_opos,"
+		<< "	c.job_cpos = r.job_cpos,"
+		<< "	c.overall_opos = r.overall_opos,"
+		<< "	c.overall_cpos = r.overall_cpos";
+
+	sql.once << "DROP TEMPORARY TABLE ranking_updates";
+
+	return rows.size();
+}
+
+auto ranking_calculator::is_changed(const rank &r) -> bool {
+	return r.old_rank != r.saved_old_rank || r.new_rank != r.saved_new_rank;
+}
+
 auto ranking_calculator::increase_rank(game_player_level level, game_player_level max_level, game_player_level last_level, game_experience exp, game_experience last_exp, game_job_id job) -> bool {
 	if (level == max_level) {
 		return true;
@@ -193,149 +292,89 @@ auto ranking_calculator::update_rank(rank &r, int32_t new_rank) -> void {
 	r.new_rank = new_rank;
 }
 
-auto ranking_calculator::overall(vector<rank_player> &v) -> void {
-	std::sort(std::begin(v), std::end(v), &base_compare);
-
-	game_player_level last_level = 0;
-	time_t last_time = 0;
-	game_experience last_exp = 0;
-	bool first = true;
-	size_t rank = 1;
-
-	for (size_t i = 0; i < v.size(); ++i) {
-		rank_player &p = v[i];
-
-		if (!first && increase_rank(p.level_stat, p.job_level_max, last_level, p.exp_stat, last_exp, p.job_stat)) {
-			++rank;
-		}
+auto ranking_calculator::rank_counter::next(const rank_player &p) -> int32_t {
+	if (!m_first && increase_rank(p.level_stat, p.job_level_max, m_last_level, p.exp_stat, m_last_exp, p.job_stat)) {
+		++m_rank;
+	}
 
-		update_rank(p.overall, rank);
+	m_first = false;
+	m_last_level = p.level_stat;
+	m_last_exp = p.exp_stat;
+	return m_rank;
+}
 
-		first = false;
-		last_level = p.level_stat;
-		last_exp = p.exp_stat;
-		last_time = p.level_time;
+auto ranking_calculator::is_in_job_track(const rank_player &p, int8_t job_track) -> bool {
+	bool is_track = vana::util::game_logic::job::get_job_track(p.job_stat) == job_track;
+
+	// These exceptions have beginner jobs that are not in their tracks ID-wise
+	// Which means we also need to account for them within the tracks they aren't supposed to be in as well
+	switch (job_track) {
+		case constant::job::track::legend: return p.job_stat != constant::job::id::evan && p.job_stat != constant::job::id::mercedes && is_track;
+		case constant::job::track::evan: return p.job_stat == constant::job::id::evan || is_track;
+		case constant::job::track::mercedes: return p.job_stat == constant::job::id::mercedes || is_track;
+		case constant::job::track::citizen: return p.job_stat != constant::job::id::demon_slayer && is_track;
+		case constant::job::track::demon_slayer: return p.job_stat == constant::job::id::demon_slayer || is_track;
+		default: return is_track;
 	}
 }
 
-auto ranking_calculator::world(vector<rank_player> &v) -> void {
-	std::sort(std::begin(v), std::end(v), [](const rank_player &t1, const rank_player &t2) -> bool {
-		if (t1.world_id == t2.world_id) {
-			return base_compare(t1, t2);
-		}
-		return t1.world_id > t2.world_id;
+auto ranking_calculator::level(vector<rank_player *> &v) -> void {
+	std::sort(std::begin(v), std::end(v), [](const rank_player *t1, const rank_player *t2) -> bool {
+		return base_compare(*t1, *t2);
 	});
 
-	login_server::get_instance().get_worlds().run_function([&v](vana::login_server::world *world_value) -> bool {
+	// Only worlds that are configured are ranked
+	hash_map<game_world_id, rank_counter> worlds;
+	login_server::get_instance().get_worlds().run_function([&worlds](vana::login_server::world *world_value) -> bool {
 		optional<game_world_id> world_id = world_value->get_id();
 		if (!world_id.is_initialized()) {
 			THROW_CODE_EXCEPTION(codepath_invalid_exception, "!world_id.is_initialized()");
 		}
-
-		game_player_level last_level = 0;
-		time_t last_time = 0;
-		game_experience last_exp = 0;
-		bool first = true;
-		size_t rank = 1;
-		game_world_id cached = world_id.get();
-
-		for (size_t i = 0; i < v.size(); ++i) {
-			rank_player &p = v[i];
-			if (p.world_id != cached) {
-				continue;
-			}
-
-			if (!first && increase_rank(p.level_stat, p.job_level_max, last_level, p.exp_stat, last_exp, p.job_stat)) {
-				++rank;
-			}
-
-			update_rank(p.world, rank);
-
-			first = false;
-			last_level = p.level_stat;
-			last_exp = p.exp_stat;
-			last_time = p.level_time;
-		}
+		worlds[world_id.get()];
 		return false;
 	});
-}
-
-auto ranking_calculator::job(vector<rank_player> &v) -> void {
-	std::sort(std::begin(v), std::end(v), [](const rank_player &t1, const rank_player &t2) -> bool {
-		int8_t job1 = vana::util::game_logic::job::get_job_track(t1.job_stat);
-		int8_t job2 = vana::util::game_logic::job::get_job_track(t2.job_stat);
 
-		if (job1 == job2) {
-			return base_compare(t1, t2);
-		}
-		return job1 > job2;
-	});
+	hash_map<int8_t, rank_counter> job_tracks;
+	rank_counter overall;
 
-	// We will iterate through each job track
-	for (const auto &job_track : constant::job::track::all) {
-		game_player_level last_level = 0;
-		time_t last_time = 0;
-		game_experience last_exp = 0;
-		bool first = true;
-		size_t rank = 1;
-
-		for (size_t i = 0; i < v.size(); ++i) {
-			rank_player &p = v[i];
-			bool valid = false;
-			bool is_track = vana::util::game_logic::job::get_job_track(p.job_stat) == job_track;
-
-			// These exceptions have beginner jobs that are not in their tracks ID-wise
-			// Which means we also need to account for them within the tracks they aren't supposed to be in as well
-			switch (job_track) {
-				case constant::job::track::legend: valid = (p.job_stat != constant::job::id::evan && p.job_stat != constant::job::id::mercedes && is_track); break;
-				case constant::job::track::evan: valid = (p.job_stat == constant::job::id::evan || is_track); break;
-				case constant::job::track::mercedes: valid = (p.job_stat == constant::job::id::mercedes || is_track); break;
-				case constant::job::track::citizen: valid = (p.job_stat != constant::job::id::demon_slayer && is_track); break;
-				case constant::job::track::demon_slayer: valid = (p.job_stat == constant::job::id::demon_slayer || is_track); break;
-				default: valid = is_track;
-			}
+	for (rank_player *p : v) {
+		update_rank(p->overall, overall.next(*p));
 
-			if (!valid) {
-				continue;
-			}
+		auto kvp = worlds.find(p->world_id);
+		if (kvp != std::end(worlds)) {
+			update_rank(p->world, kvp->second.next(*p));
+		}
 
-			if (!first && increase_rank(p.level_stat, p.job_level_max, last_level, p.exp_stat, last_exp, p.job_stat)) {
-				++rank;
+		for (const auto &job_track : constant::job::track::all) {
+			if (is_in_job_track(*p, job_track)) {
+				update_rank(p->job, job_tracks[job_track].next(*p));
 			}
-
-			update_rank(p.job, rank);
-
-			first = false;
-			last_level = p.level_stat;
-			last_exp = p.exp_stat;
-			last_time = p.level_time;
 		}
 	}
 }
 
-auto ranking_calculator::fame(vector<rank_player> &v) -> void {
-	std::sort(std::begin(v), std::end(v), [](const rank_player &t1, const rank_player &t2) -> bool {
-		return t1.fame_stat > t2.fame_stat;
+auto ranking_calculator::fame(vector<rank_player *> &v) -> void {
+	std::sort(std::begin(v), std::end(v), [](const rank_player *t1, const rank_player *t2) -> bool {
+		return t1->fame_stat > t2->fame_stat;
 	});
 
 	game_fame last_fame = 0;
 	bool first = true;
-	size_t rank = 1;
+	int32_t rank = 1;
 
-	for (size_t i = 0; i < v.size(); ++i) {
-		rank_player &p = v[i];
-		if (p.fame_stat <= 0) {
+	for (rank_player *p : v) {
+		if (p->fame_stat <= 0) {
 			continue;
 		}
 
-		if (!first && last_fame != p.fame_stat) {
+		if (!first && last_fame != p->fame_stat) {
 			++rank;
 		}
 
-		update_rank(p.fame, rank);
+		update_rank(p->fame, rank);
 
 		first = false;
-		last_fame = p.fame_stat;
+		last_fame = p->fame_stat;
 	}
 }
 
@@ -29,6 +29,9 @@ namespace vana {
 			struct rank {
 				opt_int32_t old_rank;
 				opt_int32_t new_rank;
+				// What's in the database right now, rows where neither rank moved aren't written again
+				opt_int32_t saved_old_rank;
+				opt_int32_t saved_new_rank;
 			};
 			struct rank_player {
 				game_player_level level_stat;
@@ -44,14 +47,25 @@ namespace vana {
 				rank job;
 				rank fame;
 			};
+			// Hands out ranks within one category (e.g. a single world) to players in ranking order
+			struct rank_counter {
+				auto next(const rank_player &p) -> int32_t;
+			private:
+				game_player_level m_last_level = 0;
+				game_experience m_last_exp = 0;
+				bool m_first = true;
+				int32_t m_rank = 1;
+			};
 
 			auto set_timer() -> void;
 			auto run_thread() -> void;
 			auto all() -> void;
-			auto overall(vector<rank_player> &v) -> void;
-			auto world(vector<rank_player> &v) -> void;
-			auto job(vector<rank_player> &v) -> void;
-			auto fame(vector<rank_player> &v) -> void;
+			// Overall, world and job ranks all follow the same order, so they're handed out in a single pass over one sort
+			auto level(vector<rank_player *> &v) -> void;
+			auto fame(vector<rank_player *> &v) -> void;
+			auto save(const vector<rank_player> &v) -> size_t;
+			auto is_changed(const rank &r) -> bool;
+			auto is_in_job_track(const rank_player &p, int8_t job_track) -> bool;
 			auto increase_rank(game_player_level level, game_player_level max_level, game_player_level last_level, game_experience exp, game_experience last_exp, game_job_id job) -> bool;
 			auto base_compare(const rank_player &t1, const rank_player &t2) -> bool;
 			auto update_rank(rank &r, int32_t new_rank) -> void;